@@ -19,11 +19,15 @@
 #include "brave/components/brave_shields/browser/https_everywhere_service.h"
 #include "brave/components/brave_shields/browser/local_data_files_service.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
+#include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/io_thread.h"
+#include "chrome/browser/profiles/profile.h"
 #include "chrome/common/chrome_paths.h"
 #include "components/component_updater/component_updater_service.h"
 #include "components/component_updater/timer_update_scheduler.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_source.h"
 
 #if BUILDFLAG(BUNDLE_WIDEVINE_CDM)
 #include "brave/browser/widevine/brave_widevine_bundle_manager.h"
@@ -34,6 +38,13 @@ BraveBrowserProcessImpl* g_brave_browser_process = nullptr;
 using content::BrowserThread;
 
 BraveBrowserProcessImpl::~BraveBrowserProcessImpl() {
+  // Lookups run on the service's task runner with an unretained pointer, so
+  // it is deleted there, after the ones already posted.
+  if (https_everywhere_service_) {
+    scoped_refptr<base::SequencedTaskRunner> task_runner =
+        https_everywhere_service_->GetTaskRunner();
+    task_runner->DeleteSoon(FROM_HERE, https_everywhere_service_.release());
+  }
 }
 
 BraveBrowserProcessImpl::BraveBrowserProcessImpl(ChromeFeatureListCreator* chrome_feature_list_creator)
@@ -41,6 +52,9 @@ BraveBrowserProcessImpl::BraveBrowserProcessImpl(ChromeFeatureListCreator* chrom
   g_browser_process = this;
   g_brave_browser_process = this;
 
+  notification_registrar_.Add(this, chrome::NOTIFICATION_PROFILE_DESTROYED,
+                              content::NotificationService::AllSources());
+
   brave_referrals_service_ = brave::BraveReferralsServiceFactory(local_state());
   base::SequencedTaskRunnerHandle::Get()->PostDelayedTask(
       FROM_HERE,
@@ -164,6 +178,18 @@ void BraveBrowserProcessImpl::CreateProfileManager() {
   profile_manager_ = std::make_unique<BraveProfileManager>(user_data_dir);
 }
 
+void BraveBrowserProcessImpl::Observe(
+    int type,
+    const content::NotificationSource& source,
+    const content::NotificationDetails& details) {
+  DCHECK_EQ(chrome::NOTIFICATION_PROFILE_DESTROYED, type);
+  // The HTTPS Everywhere cache is scoped by resource context, see
+  // HTTPSECacheScope.
+  Profile* profile = content::Source<Profile>(source).ptr();
+  if (https_everywhere_service_)
+    https_everywhere_service_->ClearCacheScope(profile->GetResourceContext());
+}
+
 #if BUILDFLAG(BUNDLE_WIDEVINE_CDM)
 BraveWidevineBundleManager*
 BraveBrowserProcessImpl::brave_widevine_bundle_manager() {
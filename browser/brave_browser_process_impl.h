@@ -6,6 +6,8 @@
 #define BRAVE_BROWSER_BRAVE_BROWSER_PROCESS_IMPL_H_
 
 #include "chrome/browser/browser_process_impl.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
 #include "third_party/widevine/cdm/buildflags.h"
 
 namespace brave {
@@ -30,7 +32,8 @@ namespace extensions {
 class BraveTorClientUpdater;
 }
 
-class BraveBrowserProcessImpl : public BrowserProcessImpl {
+class BraveBrowserProcessImpl : public BrowserProcessImpl,
+                                public content::NotificationObserver {
  public:
   BraveBrowserProcessImpl(ChromeFeatureListCreator* chrome_feature_list_creator);
   ~BraveBrowserProcessImpl() override;
@@ -54,6 +57,13 @@ class BraveBrowserProcessImpl : public BrowserProcessImpl {
  private:
   void CreateProfileManager();
 
+  // content::NotificationObserver implementation.
+  void Observe(int type,
+               const content::NotificationSource& source,
+               const content::NotificationDetails& details) override;
+
+  content::NotificationRegistrar notification_registrar_;
+
   std::unique_ptr<brave_shields::AdBlockService> ad_block_service_;
   std::unique_ptr<brave_shields::AdBlockRegionalService>
       ad_block_regional_service_;
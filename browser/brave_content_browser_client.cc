@@ -156,21 +156,15 @@ bool BraveContentBrowserClient::AllowAccessCookie(
       BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
           render_process_id, render_frame_id, -1).GetOrigin();
   ProfileIOData* io_data = ProfileIOData::FromResourceContext(context);
-  bool allow_brave_shields =
-      brave_shields::IsAllowContentSettingWithIOData(
-          io_data, tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-          brave_shields::kBraveShields) &&
+  brave_shields::ShieldsSettings settings =
+      brave_shields::GetShieldsSettingsWithIOData(io_data, tab_origin);
+  bool allow_brave_shields = settings.allow_brave_shields &&
       !first_party.SchemeIs(kChromeExtensionScheme);
-  bool allow_1p_cookies = brave_shields::IsAllowContentSettingWithIOData(
-      io_data, tab_origin, GURL("https://firstParty/"),
-      CONTENT_SETTINGS_TYPE_PLUGINS, brave_shields::kCookies);
-  bool allow_3p_cookies = brave_shields::IsAllowContentSettingWithIOData(
-      io_data, tab_origin, GURL(), CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kCookies);
   content_settings::BraveCookieSettings* cookie_settings =
       (content_settings::BraveCookieSettings*)io_data->GetCookieSettings();
-  bool allow = !ShouldBlockCookie(allow_brave_shields, allow_1p_cookies,
-                   allow_3p_cookies, first_party, url) &&
+  bool allow = !ShouldBlockCookie(allow_brave_shields,
+                   settings.allow_1p_cookies, settings.allow_3p_cookies,
+                   first_party, url) &&
       cookie_settings->IsCookieAccessAllowed(url, first_party, tab_origin);
   return allow;
 }
@@ -8,6 +8,7 @@
 #include "brave/browser/tor/tor_profile_service_factory.h"
 #include "brave/components/brave_ads/browser/ads_service_factory.h"
 #include "brave/components/brave_rewards/browser/rewards_service_factory.h"
+#include "brave/components/brave_shields/browser/shields_settings_observer_factory.h"
 #include "brave/components/brave_sync/brave_sync_service_factory.h"
 
 namespace brave {
@@ -15,6 +16,7 @@ namespace brave {
 void EnsureBrowserContextKeyedServiceFactoriesBuilt() {
   brave_ads::AdsServiceFactory::GetInstance();
   brave_rewards::RewardsServiceFactory::GetInstance();
+  brave_shields::ShieldsSettingsObserverFactory::GetInstance();
   brave_sync::BraveSyncServiceFactory::GetInstance();
   TorProfileServiceFactory::GetInstance();
   SearchEngineProviderServiceFactory::GetInstance();
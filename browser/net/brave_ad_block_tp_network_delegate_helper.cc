@@ -15,6 +15,7 @@
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
+#include "brave/components/brave_shields/browser/shields_decision_cache.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/grit/brave_generated_resources.h"
@@ -22,6 +23,7 @@
 #include "extensions/common/url_pattern.h"
 #include "ui/base/resource/resource_bundle.h"
 
+using brave_shields::ShieldsDecisionCache;
 using content::ResourceType;
 
 namespace brave {
@@ -76,7 +78,9 @@ bool GetPolyfillForAdBlock(bool allow_brave_shields, bool allow_ads,
   return false;
 }
 
-void OnBeforeURLRequestAdBlockTPOnTaskRunner(std::shared_ptr<BraveRequestInfo> ctx) {
+// Runs on the shields task runner, which all lists match on.
+void OnBeforeURLRequestAdBlockTPOnTaskRunner(
+    std::shared_ptr<BraveRequestInfo> ctx) {
   // If the following info isn't available, then proper content settings can't
   // be looked up, so do nothing.
   if (ctx->tab_origin.is_empty() || !ctx->tab_origin.has_host() ||
@@ -86,16 +90,29 @@ void OnBeforeURLRequestAdBlockTPOnTaskRunner(std::shared_ptr<BraveRequestInfo> c
   DCHECK(ctx->request_identifier != 0);
 
   std::string tab_host = ctx->tab_origin.host();
-  if (!g_brave_browser_process->tracking_protection_service()->
-      ShouldStartRequest(ctx->request_url, ctx->resource_type, tab_host)) {
+  ShieldsDecisionCache* decision_cache = ShieldsDecisionCache::GetInstance();
+  ShieldsDecisionCache::Decision decision;
+  if (!decision_cache->Get(tab_host, ctx->request_url, ctx->resource_type,
+                           &decision)) {
+    uint64_t generation = decision_cache->generation();
+    decision = ShieldsDecisionCache::kAllow;
+    if (!g_brave_browser_process->tracking_protection_service()->
+        ShouldStartRequest(ctx->request_url, ctx->resource_type, tab_host)) {
+      decision = ShieldsDecisionCache::kBlockedByTrackingProtection;
+    } else if (brave_shields::AdBlockBaseService::FindBlockingList(
+                   {g_brave_browser_process->ad_block_service(),
+                    g_brave_browser_process->ad_block_regional_service()},
+                   ctx->request_url, ctx->resource_type, tab_host)) {
+      decision = ShieldsDecisionCache::kBlockedByAdBlock;
+    }
+    decision_cache->Put(tab_host, ctx->request_url, ctx->resource_type,
+                        decision, generation);
+  }
+
+  if (decision == ShieldsDecisionCache::kBlockedByTrackingProtection)
     ctx->blocked_by = kTrackerBlocked;
-  } else if (!g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-           ctx->request_url, ctx->resource_type, tab_host) ||
-       !g_brave_browser_process->ad_block_regional_service()
-            ->ShouldStartRequest(ctx->request_url, ctx->resource_type,
-                                 tab_host)) {
+  else if (decision == ShieldsDecisionCache::kBlockedByAdBlock)
     ctx->blocked_by = kAdBlocked;
-  }
 }
 
 void OnBeforeURLRequestDispatchOnIOThread(
@@ -129,7 +146,7 @@ int OnBeforeURLRequest_AdBlockTPPreWork(
   }
 
   // These should probably move to our ad block lists
-  if (IsEmptyDataURLRedirect(ctx->request_url) || IsBlockedResource(ctx->request_url)) {
+  if (IsBlockedResource(ctx->request_url)) {
     ctx->new_url_spec = kEmptyDataURI;
     return net::OK;
   }
@@ -141,6 +158,8 @@ int OnBeforeURLRequest_AdBlockTPPreWork(
     return net::OK;
   }
 
+  // The task runner skips tasks on shutdown, so matching never reaches the
+  // services once the browser process starts tearing them down.
   g_brave_browser_process->ad_block_service()->
         GetTaskRunner()->PostTaskAndReply(FROM_HERE,
           base::Bind(&OnBeforeURLRequestAdBlockTPOnTaskRunner, ctx),
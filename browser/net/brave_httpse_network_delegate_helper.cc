@@ -22,7 +22,8 @@ void OnBeforeURLRequest_HttpseFileWork(
       base::BlockingType::WILL_BLOCK);
   DCHECK(ctx->request_identifier != 0);
   g_brave_browser_process->https_everywhere_service()->
-    GetHTTPSURL(&ctx->request_url, ctx->request_identifier, ctx->new_url_spec);
+    GetHTTPSURL(&ctx->request_url, ctx->request_identifier,
+                ctx->resource_context, ctx->new_url_spec);
 }
 
 void OnBeforeURLRequest_HttpsePostFileWork(
@@ -68,7 +69,7 @@ int OnBeforeURLRequest_HttpsePreFileWork(
   if (is_valid_url) {
     if (!g_brave_browser_process->https_everywhere_service()->
         GetHTTPSURLFromCacheOnly(&ctx->request_url, ctx->request_identifier,
-          ctx->new_url_spec)) {
+          ctx->resource_context, ctx->new_url_spec)) {
       g_brave_browser_process->https_everywhere_service()->
         GetTaskRunner()->PostTaskAndReply(FROM_HERE,
           base::Bind(OnBeforeURLRequest_HttpseFileWork, ctx),
@@ -5,8 +5,12 @@
 #include "brave/browser/net/brave_network_delegate_base.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
+#include "base/no_destructor.h"
 #include "base/task/post_task.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
@@ -38,6 +42,47 @@ content::WebContents* GetWebContentsFromProcessAndFrameId(int render_process_id,
   return content::WebContents::FromFrameTreeNodeId(render_frame_id);
 }
 
+#define COOKIE_NOTIFICATIONS_FLUSH_DELAY_MS 100
+
+// Only used on the IO thread.
+std::vector<base::OnceClosure>* GetPendingCookieNotifications() {
+  static base::NoDestructor<std::vector<base::OnceClosure>> notifications;
+  return notifications.get();
+}
+
+void RunCookieNotificationsOnUI(std::vector<base::OnceClosure> notifications) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  TRACE_EVENT1("brave", "RunCookieNotificationsOnUI",
+               "notifications", notifications.size());
+  for (auto& notification : notifications)
+    std::move(notification).Run();
+}
+
+void FlushCookieNotificationsOnIO() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  std::vector<base::OnceClosure> notifications;
+  notifications.swap(*GetPendingCookieNotifications());
+  base::PostTaskWithTraits(
+      FROM_HERE, {BrowserThread::UI},
+      base::BindOnce(&RunCookieNotificationsOnUI, std::move(notifications)));
+}
+
+// Page info only needs to catch up eventually, so the cookie reads and
+// writes of a page load are reported to the UI thread in one task.
+void QueueCookieNotification(base::OnceClosure notification) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  std::vector<base::OnceClosure>* notifications =
+      GetPendingCookieNotifications();
+  notifications->push_back(std::move(notification));
+  if (notifications->size() == 1) {
+    base::PostDelayedTaskWithTraits(
+        FROM_HERE, {BrowserThread::IO},
+        base::BindOnce(&FlushCookieNotificationsOnIO),
+        base::TimeDelta::FromMilliseconds(
+            COOKIE_NOTIFICATIONS_FLUSH_DELAY_MS));
+  }
+}
+
 }  // namespace
 
 BraveNetworkDelegateBase::BraveNetworkDelegateBase(
@@ -91,10 +136,9 @@ int BraveNetworkDelegateBase::OnBeforeURLRequest(
     return ChromeNetworkDelegate::OnBeforeURLRequest(
         request, std::move(callback), new_url);
   }
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
+  std::shared_ptr<brave::BraveRequestInfo> ctx = GetRequestInfo(request);
+  ctx->ResetForEvent(brave::kOnBeforeRequest);
   ctx->new_url = new_url;
-  ctx->event_type = brave::kOnBeforeRequest;
   callbacks_[request->identifier()] = std::move(callback);
   RunNextCallback(request, ctx);
   return net::ERR_IO_PENDING;
@@ -108,9 +152,8 @@ int BraveNetworkDelegateBase::OnBeforeStartTransaction(
     return ChromeNetworkDelegate::OnBeforeStartTransaction(
         request, std::move(callback), headers);
   }
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
-  ctx->event_type = brave::kOnBeforeStartTransaction;
+  std::shared_ptr<brave::BraveRequestInfo> ctx = GetRequestInfo(request);
+  ctx->ResetForEvent(brave::kOnBeforeStartTransaction);
   ctx->headers = headers;
   ctx->referral_headers_list = referral_headers_list_.get();
   callbacks_[request->identifier()] = std::move(callback);
@@ -130,10 +173,9 @@ int BraveNetworkDelegateBase::OnHeadersReceived(
         override_response_headers, allowed_unsafe_redirect_url);
   }
 
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
   callbacks_[request->identifier()] = std::move(callback);
-  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
-  ctx->event_type = brave::kOnHeadersReceived;
+  std::shared_ptr<brave::BraveRequestInfo> ctx = GetRequestInfo(request);
+  ctx->ResetForEvent(brave::kOnHeadersReceived);
   ctx->original_response_headers = original_response_headers;
   ctx->override_response_headers = override_response_headers;
   ctx->allowed_unsafe_redirect_url = allowed_unsafe_redirect_url;
@@ -153,20 +195,19 @@ bool BraveNetworkDelegateBase::OnCanGetCookies(
     const URLRequest& request,
     const net::CookieList& cookie_list,
     bool allowed_from_caller) {
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  brave::BraveRequestInfo::FillCTXFromRequest(&request, ctx);
-  ctx->event_type = brave::kOnCanGetCookies;
-  bool allow = std::all_of(can_get_cookies_callbacks_.begin(),
-                           can_get_cookies_callbacks_.end(),
-                           [&ctx](brave::OnCanGetCookiesCallback callback) {
-                             return callback.Run(ctx);
-                           });
+  // Cookie checks run synchronously in the middle of the request, so they
+  // share its context but leave the state of the current event alone.
+  std::shared_ptr<brave::BraveRequestInfo> ctx = GetRequestInfo(&request);
+  bool allow = std::all_of(
+      can_get_cookies_callbacks_.begin(), can_get_cookies_callbacks_.end(),
+      [&ctx](const brave::OnCanGetCookiesCallback& callback) {
+        return callback.Run(ctx);
+      });
 
   base::RepeatingCallback<content::WebContents*(void)> wc_getter =
       base::BindRepeating(&GetWebContentsFromProcessAndFrameId,
                           ctx->render_process_id, ctx->render_frame_id);
-  base::PostTaskWithTraits(
-      FROM_HERE, {BrowserThread::UI},
+  QueueCookieNotification(
       base::BindOnce(&TabSpecificContentSettings::CookiesRead, wc_getter,
                      request.url(), request.site_for_cookies(), cookie_list,
                      !allow));
@@ -179,21 +220,17 @@ bool BraveNetworkDelegateBase::OnCanSetCookie(
     const net::CanonicalCookie& cookie,
     net::CookieOptions* options,
     bool allowed_from_caller) {
-  std::shared_ptr<brave::BraveRequestInfo> ctx(new brave::BraveRequestInfo());
-  brave::BraveRequestInfo::FillCTXFromRequest(&request, ctx);
-  ctx->event_type = brave::kOnCanSetCookies;
-
-  bool allow = std::all_of(can_set_cookies_callbacks_.begin(),
-                           can_set_cookies_callbacks_.end(),
-                           [&ctx](brave::OnCanSetCookiesCallback callback) {
-                             return callback.Run(ctx);
-                           });
+  std::shared_ptr<brave::BraveRequestInfo> ctx = GetRequestInfo(&request);
+  bool allow = std::all_of(
+      can_set_cookies_callbacks_.begin(), can_set_cookies_callbacks_.end(),
+      [&ctx](const brave::OnCanSetCookiesCallback& callback) {
+        return callback.Run(ctx);
+      });
 
   base::RepeatingCallback<content::WebContents*(void)> wc_getter =
       base::BindRepeating(&GetWebContentsFromProcessAndFrameId,
                           ctx->render_process_id, ctx->render_frame_id);
-  base::PostTaskWithTraits(
-      FROM_HERE, {BrowserThread::UI},
+  QueueCookieNotification(
       base::BindOnce(&TabSpecificContentSettings::CookieChanged, wc_getter,
                      request.url(), request.site_for_cookies(), cookie,
                      !allow));
@@ -201,11 +238,21 @@ bool BraveNetworkDelegateBase::OnCanSetCookie(
   return allow;
 }
 
+std::shared_ptr<brave::BraveRequestInfo>
+BraveNetworkDelegateBase::GetRequestInfo(const URLRequest* request) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  std::shared_ptr<brave::BraveRequestInfo>& ctx =
+      request_infos_[request->identifier()];
+  if (!ctx)
+    ctx = std::make_shared<brave::BraveRequestInfo>();
+  brave::BraveRequestInfo::FillCTXFromRequest(request, ctx);
+  return ctx;
+}
+
 void BraveNetworkDelegateBase::RunCallbackForRequestIdentifier(
     uint64_t request_identifier,
     int rv) {
-  std::map<uint64_t, net::CompletionOnceCallback>::iterator it =
-      callbacks_.find(request_identifier);
+  auto it = callbacks_.find(request_identifier);
   std::move(it->second).Run(rv);
 }
 
@@ -222,18 +269,21 @@ void BraveNetworkDelegateBase::RunNextCallback(
     return;
   }
 
-  // Continue processing callbacks until we hit one that returns PENDING
+  // Continue processing callbacks until we hit one that returns PENDING.
+  // Most helpers finish synchronously, so all of them share one bound
+  // continuation and only the pending ones keep a reference to it.
   int rv = net::OK;
+  brave::ResponseCallback next_callback =
+      base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
+                 base::Unretained(this), request, ctx);
 
   if (ctx->event_type == brave::kOnBeforeRequest) {
     while (before_url_request_callbacks_.size() !=
            ctx->next_url_request_index) {
-      brave::OnBeforeURLRequestCallback callback =
-          before_url_request_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                     base::Unretained(this), request, ctx);
-      rv = callback.Run(next_callback, ctx);
+      size_t index = ctx->next_url_request_index++;
+      TRACE_EVENT1("brave", "BraveNetworkDelegateBase::OnBeforeURLRequest",
+                   "helper", index);
+      rv = before_url_request_callbacks_[index].Run(next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
         return;
       }
@@ -244,12 +294,12 @@ void BraveNetworkDelegateBase::RunNextCallback(
   } else if (ctx->event_type == brave::kOnBeforeStartTransaction) {
     while (before_start_transaction_callbacks_.size() !=
            ctx->next_url_request_index) {
-      brave::OnBeforeStartTransactionCallback callback =
-          before_start_transaction_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                     base::Unretained(this), request, ctx);
-      rv = callback.Run(request, ctx->headers, next_callback, ctx);
+      size_t index = ctx->next_url_request_index++;
+      TRACE_EVENT1("brave",
+                   "BraveNetworkDelegateBase::OnBeforeStartTransaction",
+                   "helper", index);
+      rv = before_start_transaction_callbacks_[index].Run(
+          request, ctx->headers, next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
         return;
       }
@@ -259,14 +309,13 @@ void BraveNetworkDelegateBase::RunNextCallback(
     }
   } else if (ctx->event_type == brave::kOnHeadersReceived) {
     while (headers_received_callbacks_.size() != ctx->next_url_request_index) {
-      brave::OnHeadersReceivedCallback callback =
-          headers_received_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveNetworkDelegateBase::RunNextCallback,
-                     base::Unretained(this), request, ctx);
-      rv = callback.Run(request, ctx->original_response_headers,
-                        ctx->override_response_headers,
-                        ctx->allowed_unsafe_redirect_url, next_callback, ctx);
+      size_t index = ctx->next_url_request_index++;
+      TRACE_EVENT1("brave", "BraveNetworkDelegateBase::OnHeadersReceived",
+                   "helper", index);
+      rv = headers_received_callbacks_[index].Run(
+          request, ctx->original_response_headers,
+          ctx->override_response_headers, ctx->allowed_unsafe_redirect_url,
+          next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
         return;
       }
@@ -316,9 +365,9 @@ void BraveNetworkDelegateBase::RunNextCallback(
 }
 
 void BraveNetworkDelegateBase::OnURLRequestDestroyed(URLRequest* request) {
-  if (ContainsKey(callbacks_, request->identifier())) {
-    callbacks_.erase(request->identifier());
-  }
+  callbacks_.erase(request->identifier());
+  // Helpers still running on other sequences keep their own reference.
+  request_infos_.erase(request->identifier());
   ChromeNetworkDelegate::OnURLRequestDestroyed(request);
 }
 
@@ -5,6 +5,10 @@
 #ifndef BRAVE_BROWSER_NET_BRAVE_NETWORK_DELEGATE_BASE_H_
 #define BRAVE_BROWSER_NET_BRAVE_NETWORK_DELEGATE_BASE_H_
 
+#include <memory>
+#include <vector>
+
+#include "base/containers/flat_map.h"
 #include "brave/browser/net/url_context.h"
 #include "chrome/browser/net/chrome_network_delegate.h"
 #include "content/public/browser/browser_thread.h"
@@ -70,6 +74,10 @@ class BraveNetworkDelegateBase : public ChromeNetworkDelegate {
   std::vector<brave::OnCanSetCookiesCallback> can_set_cookies_callbacks_;
 
  private:
+  // Returns the context of |request|, created on its first event and kept
+  // until the request is destroyed.
+  std::shared_ptr<brave::BraveRequestInfo> GetRequestInfo(
+      const net::URLRequest* request);
   void InitPrefChangeRegistrarOnUI();
   void SetReferralHeaders(base::ListValue* referral_headers);
   void OnReferralHeadersChanged();
@@ -79,7 +87,11 @@ class BraveNetworkDelegateBase : public ChromeNetworkDelegate {
   // PrefChangeRegistrar and corresponding |base::Unretained| usages, that are
   // illegal.
   std::unique_ptr<base::ListValue> referral_headers_list_;
-  std::map<uint64_t, net::CompletionOnceCallback> callbacks_;
+  // Keyed by request identifier. Only requests in flight are kept, so these
+  // stay small enough for a sorted vector.
+  base::flat_map<uint64_t, net::CompletionOnceCallback> callbacks_;
+  base::flat_map<uint64_t, std::shared_ptr<brave::BraveRequestInfo>>
+      request_infos_;
   std::unique_ptr<PrefChangeRegistrar, content::BrowserThread::DeleteOnUIThread>
       pref_change_registrar_;
 
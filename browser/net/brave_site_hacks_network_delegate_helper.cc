@@ -10,6 +10,7 @@
 #include "base/strings/string_util.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/shield_exceptions.h"
+#include "brave/common/site_hack_rules.h"
 #include "brave/common/url_constants.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
@@ -17,7 +18,6 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/resource_request_info.h"
 #include "content/public/common/referrer.h"
-#include "extensions/common/url_pattern.h"
 #include "net/url_request/url_request.h"
 
 using content::BrowserThread;
@@ -35,15 +35,9 @@ bool ApplyPotentialReferrerBlock(std::shared_ptr<BraveRequestInfo> ctx,
   if (tab_origin.SchemeIs(kChromeExtensionScheme)) {
     return false;
   }
-  bool allow_referrers = brave_shields::IsAllowContentSettingFromIO(
-      request, tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kReferrers);
-  bool shields_up = brave_shields::IsAllowContentSettingFromIO(
-      request, tab_origin, GURL(), CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kBraveShields);
   const std::string original_referrer = request->referrer();
   Referrer new_referrer;
-  if (brave_shields::ShouldSetReferrer(allow_referrers, shields_up,
+  if (brave_shields::ShouldSetReferrer(ctx->allow_referrers, ctx->shields_up,
           GURL(original_referrer), tab_origin, request->url(), target_origin,
           Referrer::NetReferrerPolicyToBlinkReferrerPolicy(
               request->referrer_policy()), &new_referrer)) {
@@ -62,39 +56,34 @@ int OnBeforeURLRequest_SiteHacksWork(
   return net::OK;
 }
 
-void CheckForCookieOverride(const GURL& url, const URLPattern& pattern,
-    net::HttpRequestHeaders* headers, const std::string& extra_cookies) {
-  if (pattern.MatchesURL(url)) {
+void CheckForCookieOverride(const GURL& url,
+    net::HttpRequestHeaders* headers) {
+  const SiteHackRule* rule =
+      SiteHackRuleTable::GetInstance().Find(kExtraCookiesRule, url);
+  if (rule) {
     std::string cookies;
     if (headers->GetHeader(kCookieHeader, &cookies)) {
       cookies = "; ";
     }
-    cookies += extra_cookies;
+    cookies += rule->value;
     headers->SetHeader(kCookieHeader, cookies);
   }
 }
 
 bool IsBlockTwitterSiteHack(net::URLRequest* request,
     net::HttpRequestHeaders* headers) {
-  URLPattern redirectURLPattern(URLPattern::SCHEME_ALL, kTwitterRedirectURL);
-  URLPattern referrerPattern(URLPattern::SCHEME_ALL, kTwitterReferrer);
-  if (redirectURLPattern.MatchesURL(request->url())) {
-    std::string referrer;
-    if (headers->GetHeader(kRefererHeader, &referrer) &&
-        referrerPattern.MatchesURL(GURL(referrer))) {
-      return true;
-    }
-  }
-  return false;
+  std::string referrer;
+  if (!headers->GetHeader(kRefererHeader, &referrer))
+    return false;
+  return SiteHackRuleTable::GetInstance().Find(
+      kBlockedForReferrerRule, request->url(), GURL(referrer)) != nullptr;
 }
 
 int OnBeforeStartTransaction_SiteHacksWork(net::URLRequest* request,
         net::HttpRequestHeaders* headers,
         const ResponseCallback& next_callback,
         std::shared_ptr<BraveRequestInfo> ctx) {
-  CheckForCookieOverride(request->url(),
-      URLPattern(URLPattern::SCHEME_ALL, kForbesPattern), headers,
-      kForbesExtraCookies);
+  CheckForCookieOverride(request->url(), headers);
   if (IsBlockTwitterSiteHack(request, headers)) {
     return net::ERR_ABORTED;
   }
@@ -5,74 +5,32 @@
 #include "brave/browser/net/brave_static_redirect_network_delegate_helper.h"
 
 #include "brave/common/network_constants.h"
-#include "extensions/common/url_pattern.h"
+#include "brave/common/site_hack_rules.h"
 
 namespace brave {
 
 int OnBeforeURLRequest_StaticRedirectWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx) {
-  GURL::Replacements replacements;
-  static URLPattern geo_pattern(URLPattern::SCHEME_HTTPS, kGeoLocationsPattern);
-  static URLPattern safeBrowsing_pattern(URLPattern::SCHEME_HTTPS, kSafeBrowsingPrefix);
-
-  if (geo_pattern.MatchesURL(ctx->request_url)) {
+  const SiteHackRuleTable& rules = SiteHackRuleTable::GetInstance();
+  if (rules.Find(kGeolocationRedirectRule, ctx->request_url)) {
     ctx->new_url_spec = GURL(GOOGLEAPIS_ENDPOINT GOOGLEAPIS_API_KEY).spec();
     return net::OK;
   }
 
-  if (safeBrowsing_pattern.MatchesHost(ctx->request_url)) {
+  if (rules.Find(kSafeBrowsingRedirectRule, ctx->request_url)) {
+    GURL::Replacements replacements;
     replacements.SetHostStr(SAFEBROWSING_ENDPOINT);
     ctx->new_url_spec = ctx->request_url.ReplaceComponents(replacements).spec();
     return net::OK;
   }
 
 #if !defined(NDEBUG)
-  GURL gurl = ctx->request_url;
-  static std::vector<URLPattern> allowed_patterns({
-    // Brave updates
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://go-updater.brave.com/*"),
-    // Brave promo referrals, production and staging (laptop-updates
-    // proxies to promo-services)
-    // TODO: In the future, we may want to specify the value of the
-    // BRAVE_REFERRALS_SERVER environment variable rather than
-    // hardcoding the server name here
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://laptop-updates.brave.com/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://laptop-updates-staging.herokuapp.com/*"),
-    // CRX file download
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://brave-core-ext.s3.brave.com/release/*"),
-    // Safe Browsing and other files
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://static.brave.com/*"),
-    // We do allow redirects to the Google update server for extensions we don't support
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://update.googleapis.com/service/update2"),
-
-    // Rewards URLs
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://ledger.mercury.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://balance.mercury.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://publishers.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://publishers-distro.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://ledger-staging.mercury.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://balance-staging.mercury.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://publishers-staging.basicattentiontoken.org/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://publishers-staging-distro.basicattentiontoken.org/*"),
-
-    // Safe browsing
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://safebrowsing.brave.com/v4/*"),
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://ssl.gstatic.com/safebrowsing/*"),
-
-    // Will be removed when https://github.com/brave/brave-browser/issues/663 is fixed
-    URLPattern(URLPattern::SCHEME_HTTPS, "https://www.gstatic.com/*"),
-  });
-  // Check to make sure the URL being requested matches at least one of the allowed patterns
-  bool is_url_allowed = std::any_of(allowed_patterns.begin(), allowed_patterns.end(),
-    [&gurl](URLPattern pattern) {
-      if (pattern.MatchesURL(gurl)) {
-        return true;
-      }
-      return false;
-    });
-  if (!is_url_allowed) {
-    LOG(ERROR) << "URL not allowed from system network delegate: " << gurl;
+  // Check to make sure the URL being requested matches at least one of the
+  // allowed patterns
+  if (!rules.Find(kSystemRequestAllowedRule, ctx->request_url)) {
+    LOG(ERROR) << "URL not allowed from system network delegate: "
+               << ctx->request_url;
   }
   // TODO: Before we can turn this into DCHECK we have to find a way to allow these, I think they are for Chrome Cast
   // http://192.168.0.13:8008/ssdp/device-desc.xml
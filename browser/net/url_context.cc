@@ -6,11 +6,11 @@
 #include "brave/browser/net/url_context.h"
 
 #include <string>
+#include <utility>
 
 #include "brave/common/url_constants.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
-#include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "content/public/browser/resource_request_info.h"
 
 namespace brave {
@@ -21,6 +21,19 @@ BraveRequestInfo::BraveRequestInfo() {
 BraveRequestInfo::~BraveRequestInfo() {
 }
 
+void BraveRequestInfo::ResetForEvent(BraveNetworkDelegateEventType type) {
+  new_url_spec.clear();
+  next_url_request_index = 0;
+  headers = nullptr;
+  original_response_headers = nullptr;
+  override_response_headers = nullptr;
+  allowed_unsafe_redirect_url = nullptr;
+  event_type = type;
+  referral_headers_list = nullptr;
+  blocked_by = kNotBlocked;
+  new_url = nullptr;
+}
+
 void BraveRequestInfo::FillCTXFromRequest(const net::URLRequest* request,
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
   ctx->request_identifier = request->identifier();
@@ -28,38 +41,45 @@ void BraveRequestInfo::FillCTXFromRequest(const net::URLRequest* request,
   auto* request_info = content::ResourceRequestInfo::ForRequest(request);
   if (request_info) {
     ctx->resource_type = request_info->GetResourceType();
+    ctx->resource_context = request_info->GetContext();
   }
   brave_shields::GetRenderFrameInfo(request,
                                     &ctx->render_frame_id,
                                     &ctx->render_process_id,
                                     &ctx->frame_tree_node_id);
+  GURL tab_url;
   if (!request->site_for_cookies().is_empty()) {
-    ctx->tab_url = request->site_for_cookies();
+    tab_url = request->site_for_cookies();
   } else {
     // We can not always use site_for_cookies since it can be empty in certain
     // cases. See the comments in url_request.h
-    ctx->tab_url = brave_shields::BraveShieldsWebContentsObserver::
+    tab_url = brave_shields::BraveShieldsWebContentsObserver::
         GetTabURLFromRenderFrameInfo(ctx->render_process_id,
                                      ctx->render_frame_id,
                                      ctx->frame_tree_node_id).GetOrigin();
   }
-  ctx->tab_origin = ctx->tab_url.GetOrigin();
-  ctx->allow_brave_shields = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kBraveShields) &&
+  GURL tab_origin = tab_url.GetOrigin();
+  ctx->tab_url = std::move(tab_url);
+
+  // The shields settings only depend on the tab origin, so later events of
+  // the same request skip the lookups unless a redirect changed the origin.
+  if (ctx->content_settings_filled_ && tab_origin == ctx->tab_origin) {
+    ctx->request = request;
+    return;
+  }
+  ctx->tab_origin = std::move(tab_origin);
+  ctx->content_settings_filled_ = true;
+  brave_shields::ShieldsSettings settings =
+      brave_shields::GetShieldsSettingsFromIO(request, ctx->tab_origin);
+  ctx->allow_brave_shields = settings.allow_brave_shields &&
     !request->site_for_cookies().SchemeIs(kChromeExtensionScheme);
-  ctx->allow_ads = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kAds);
-  ctx->allow_http_upgradable_resource = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, ctx->tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kHTTPUpgradableResources);
-  ctx->allow_1p_cookies = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, GURL("https://firstParty/"), CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kCookies);
-  ctx->allow_3p_cookies = brave_shields::IsAllowContentSettingFromIO(
-      request, ctx->tab_origin, GURL(), CONTENT_SETTINGS_TYPE_PLUGINS,
-      brave_shields::kCookies);
+  ctx->shields_up = settings.shields_up;
+  ctx->allow_ads = settings.allow_ads;
+  ctx->allow_http_upgradable_resource =
+      settings.allow_http_upgradable_resources;
+  ctx->allow_1p_cookies = settings.allow_1p_cookies;
+  ctx->allow_3p_cookies = settings.allow_3p_cookies;
+  ctx->allow_referrers = settings.allow_referrers;
   ctx->request = request;
 }
 
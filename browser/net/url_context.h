@@ -15,6 +15,10 @@
 
 class BraveNetworkDelegateBase;
 
+namespace content {
+class ResourceContext;
+}
+
 namespace brave {
 
 struct BraveRequestInfo;
@@ -58,10 +62,15 @@ struct BraveRequestInfo {
   bool allow_http_upgradable_resource = false;
   bool allow_1p_cookies = true;
   bool allow_3p_cookies = false;
+  bool allow_referrers = false;
+  // Shields are up for every secondary URL of the tab origin.
+  bool shields_up = true;
   int render_process_id = 0;
   int render_frame_id = 0;
   int frame_tree_node_id = 0;
   uint64_t request_identifier = 0;
+  // Identifies the profile (regular or off-the-record) of the request.
+  content::ResourceContext* resource_context = nullptr;
   size_t next_url_request_index = 0;
   net::HttpRequestHeaders* headers = nullptr;
   const net::HttpResponseHeaders* original_response_headers = nullptr;
@@ -74,9 +83,14 @@ struct BraveRequestInfo {
   // can properly detect that the info couldn't be obtained.
   content::ResourceType resource_type = content::RESOURCE_TYPE_LAST_TYPE;
 
+  // Fills the fields that describe |request|. A context is kept for the whole
+  // request, so this is called again for each event to pick up redirects.
   static void FillCTXFromRequest(const net::URLRequest* request,
     std::shared_ptr<brave::BraveRequestInfo> ctx);
 
+  // Clears the results of the previous event before the next one runs.
+  void ResetForEvent(BraveNetworkDelegateEventType type);
+
  private:
   // Please don't add any more friends here if it can be avoided.
   // We should also remove the ones below.
@@ -95,6 +109,8 @@ struct BraveRequestInfo {
   // request is deprecated, do not use it.
   const net::URLRequest* request;
   GURL* new_url = nullptr;
+  // Whether the allow_* settings were looked up for |tab_origin|.
+  bool content_settings_filled_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(BraveRequestInfo);
 };
@@ -140,8 +140,7 @@ class RewardsDOMHandler : public WebUIMessageHandler,
       bool rewards_main_enabled) override;
 
   void OnPublisherListNormalized(
-      brave_rewards::RewardsService* rewards_service,
-      brave_rewards::ContentSiteList list) override;
+      brave_rewards::RewardsService* rewards_service) override;
 
   // RewardsNotificationsServiceObserver implementation
   void OnNotificationAdded(
@@ -908,15 +907,10 @@ void RewardsDOMHandler::OnRewardsMainEnabled(
 
 
 void RewardsDOMHandler::OnPublisherListNormalized(
-    brave_rewards::RewardsService* rewards_service,
-    brave_rewards::ContentSiteList list) {
-  std::unique_ptr<brave_rewards::ContentSiteList> site_list(
-      new brave_rewards::ContentSiteList);
-  for (auto& publisher : list) {
-    site_list->push_back(publisher);
-  }
-
-  OnContentSiteList(std::move(site_list), 0);
+    brave_rewards::RewardsService* rewards_service) {
+  rewards_service_->GetAutoContributeProps(
+      base::Bind(&RewardsDOMHandler::OnAutoContributePropsReady,
+        weak_factory_.GetWeakPtr()));
 }
 
 void RewardsDOMHandler::GetAddressesForPaymentId(
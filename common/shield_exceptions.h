@@ -6,7 +6,6 @@ class GURL;
 
 namespace brave {
 
-bool IsEmptyDataURLRedirect(const GURL& gurl);
 bool IsUAWhitelisted(const GURL& gurl);
 bool IsBlockedResource(const GURL& gurl);
 bool IsWhitelistedCookieExeption(const GURL& firstPartyOrigin,
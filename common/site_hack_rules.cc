@@ -0,0 +1,220 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/site_hack_rules.h"
+
+#include <utility>
+
+#include "base/no_destructor.h"
+#include "base/strings/string_piece.h"
+#include "brave/common/network_constants.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+// New site hacks and static redirects go here instead of into the network
+// delegate helpers.
+const SiteHackRule kSiteHackRules[] = {
+  {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+      "https://*.adobe.com/*", nullptr, nullptr},
+  {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+      "https://*.duckduckgo.com/*", nullptr, nullptr},
+  {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+      "https://*.brave.com/*", nullptr, nullptr},
+  // For Widevine
+  {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+      "https://*.netflix.com/*", nullptr, nullptr},
+
+  // These should probably move to our ad block lists
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "https://www.lesechos.fr/xtcore.js", nullptr, nullptr},
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "https://*.y8.com/js/sdkloader/outstream.js", nullptr, nullptr},
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "https://pdfjs.robwu.nl/*", nullptr, nullptr},
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "*://sp1.nypost.com/*", nullptr, nullptr},
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "*://sp.nasdaq.com/*", nullptr, nullptr},
+
+  // Note that there's already an exception for TLD+1, so don't add those
+  // here. Check with the security team before adding exceptions.
+  // https://github.com/brave/browser-laptop/issues/5861
+  // Only allow the specific request pattern of
+  // reddit -> redditmedia -> embedly -> imgur.
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://www.reddit.com/*", "https://www.reddit.com/*", nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://www.redditmedia.com/*", "https://www.reddit.com/*", nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://cdn.embedly.com/*", "https://www.reddit.com/*", nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://imgur.com/*", "https://www.reddit.com/*", nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://*.fbcdn.net/*", "https://www.facebook.com/", nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://content.googleapis.com/*", "https://accounts.google.com/",
+      nullptr},
+  // It's preferred to use a first party pattern when possible
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_ALL,
+      "https://use.typekit.net/*", nullptr, nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_ALL,
+      "https://api.geetest.com/*", nullptr, nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_ALL,
+      "https://cloud.typography.com/*", nullptr, nullptr},
+
+  {kExtraCookiesRule, URLPattern::SCHEME_ALL,
+      kForbesPattern, nullptr, kForbesExtraCookies},
+  {kBlockedForReferrerRule, URLPattern::SCHEME_ALL,
+      kTwitterRedirectURL, kTwitterReferrer, nullptr},
+
+  {kGeolocationRedirectRule, URLPattern::SCHEME_HTTPS,
+      kGeoLocationsPattern, nullptr, nullptr},
+  {kSafeBrowsingRedirectRule, URLPattern::SCHEME_ALL,
+      "*://safebrowsing.googleapis.com/*", nullptr, nullptr},
+
+#if !defined(NDEBUG)
+  // Brave updates
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://go-updater.brave.com/*", nullptr, nullptr},
+  // Brave promo referrals, production and staging (laptop-updates
+  // proxies to promo-services)
+  // TODO: In the future, we may want to specify the value of the
+  // BRAVE_REFERRALS_SERVER environment variable rather than
+  // hardcoding the server name here
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://laptop-updates.brave.com/*", nullptr, nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://laptop-updates-staging.herokuapp.com/*", nullptr, nullptr},
+  // CRX file download
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://brave-core-ext.s3.brave.com/release/*", nullptr, nullptr},
+  // Safe Browsing and other files
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://static.brave.com/*", nullptr, nullptr},
+  // We do allow redirects to the Google update server for extensions we
+  // don't support
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://update.googleapis.com/service/update2", nullptr, nullptr},
+
+  // Rewards URLs
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://ledger.mercury.basicattentiontoken.org/*", nullptr, nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://balance.mercury.basicattentiontoken.org/*", nullptr, nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://publishers.basicattentiontoken.org/*", nullptr, nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://publishers-distro.basicattentiontoken.org/*", nullptr, nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://ledger-staging.mercury.basicattentiontoken.org/*", nullptr,
+      nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://balance-staging.mercury.basicattentiontoken.org/*", nullptr,
+      nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://publishers-staging.basicattentiontoken.org/*", nullptr,
+      nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://publishers-staging-distro.basicattentiontoken.org/*", nullptr,
+      nullptr},
+
+  // Safe browsing
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://safebrowsing.brave.com/v4/*", nullptr, nullptr},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://ssl.gstatic.com/safebrowsing/*", nullptr, nullptr},
+
+  // Will be removed when https://github.com/brave/brave-browser/issues/663
+  // is fixed
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+      "https://www.gstatic.com/*", nullptr, nullptr},
+#endif
+};
+
+}  // namespace
+
+SiteHackRuleTable::CompiledRule::CompiledRule(const SiteHackRule& rule)
+    : rule(&rule),
+      pattern(rule.valid_schemes, rule.pattern) {
+  if (rule.first_party_pattern)
+    first_party_pattern.emplace(rule.valid_schemes, rule.first_party_pattern);
+}
+
+SiteHackRuleTable::CompiledRule::CompiledRule(const CompiledRule& other) =
+    default;
+
+SiteHackRuleTable::CompiledRule::~CompiledRule() = default;
+
+SiteHackRuleTable::SiteHackRuleTable(const SiteHackRule* rules, size_t count)
+    : size_(count) {
+  for (size_t i = 0; i < count; ++i) {
+    CompiledRule compiled(rules[i]);
+    rules_by_host_[compiled.pattern.host()].push_back(std::move(compiled));
+  }
+}
+
+SiteHackRuleTable::~SiteHackRuleTable() = default;
+
+// static
+const SiteHackRuleTable& SiteHackRuleTable::GetInstance() {
+  static base::NoDestructor<SiteHackRuleTable> table(
+      kSiteHackRules, arraysize(kSiteHackRules));
+  return *table;
+}
+
+const SiteHackRule* SiteHackRuleTable::Find(SiteHackRuleType type,
+                                            const GURL& url) const {
+  return FindInternal(type, url, nullptr);
+}
+
+const SiteHackRule* SiteHackRuleTable::Find(SiteHackRuleType type,
+                                            const GURL& url,
+                                            const GURL& first_party) const {
+  return FindInternal(type, url, &first_party);
+}
+
+const SiteHackRule* SiteHackRuleTable::FindInternal(
+    SiteHackRuleType type,
+    const GURL& url,
+    const GURL* first_party) const {
+  auto matches = [&](const CompiledRule& compiled, bool is_request_host) {
+    if (compiled.rule->type != type)
+      return false;
+    // A rule for a parent domain only applies to its subdomains if it says
+    // so.
+    if (!is_request_host && !compiled.pattern.match_subdomains())
+      return false;
+    if (!compiled.pattern.MatchesURL(url))
+      return false;
+    return !first_party || !compiled.first_party_pattern ||
+        compiled.first_party_pattern->MatchesURL(*first_party);
+  };
+
+  // Tries the request host, then each parent domain of it, and finally the
+  // rules for every host.
+  base::StringPiece host = url.host_piece();
+  bool is_request_host = true;
+  while (true) {
+    auto it = rules_by_host_.find(host);
+    if (it != rules_by_host_.end()) {
+      for (const CompiledRule& compiled : it->second) {
+        if (matches(compiled, is_request_host))
+          return compiled.rule;
+      }
+    }
+    if (host.empty())
+      break;
+    size_t dot = host.find('.');
+    host = dot == base::StringPiece::npos ?
+        base::StringPiece() : host.substr(dot + 1);
+    is_request_host = false;
+  }
+  return nullptr;
+}
+
+}  // namespace brave
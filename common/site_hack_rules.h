@@ -0,0 +1,105 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMMON_SITE_HACK_RULES_H_
+#define BRAVE_COMMON_SITE_HACK_RULES_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/macros.h"
+#include "base/optional.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace brave {
+
+enum SiteHackRuleType {
+  // Requests get "Brave" added to their User-Agent.
+  kUAWhitelistedRule,
+  // Requests are redirected to an empty data URL.
+  kBlockedResourceRule,
+  // Requests keep their referrer when it is cross-site.
+  kWhitelistedReferrerRule,
+  // Requests keep their cookies when they are third-party.
+  kWhitelistedCookieRule,
+  // Requests get the cookies in |value| added.
+  kExtraCookiesRule,
+  // Requests are aborted when their referrer matches |first_party_pattern|.
+  kBlockedForReferrerRule,
+  // Requests are redirected to the Brave geolocation endpoint.
+  kGeolocationRedirectRule,
+  // Requests are redirected to the Brave safe browsing host.
+  kSafeBrowsingRedirectRule,
+  // Requests the system network delegate is expected to make. Only checked
+  // in debug builds.
+  kSystemRequestAllowedRule,
+};
+
+struct SiteHackRule {
+  SiteHackRuleType type;
+  // URLPattern::SCHEME_* bits for |pattern| and |first_party_pattern|.
+  int valid_schemes;
+  const char* pattern;
+  // When set, the rule only applies to requests from a matching first party.
+  const char* first_party_pattern;
+  const char* value;
+};
+
+// The site hacks and static redirects, compiled once and indexed by the host
+// of their patterns. A lookup only runs the patterns of the request host and
+// its parent domains, so adding rules does not add a scan to every request.
+class SiteHackRuleTable {
+ public:
+  SiteHackRuleTable(const SiteHackRule* rules, size_t count);
+  ~SiteHackRuleTable();
+
+  // The table of the rules Brave ships with.
+  static const SiteHackRuleTable& GetInstance();
+
+  // Returns the first rule of |type| that matches |url|, or nullptr. There is
+  // no first party to check, so rules with a first party pattern match too;
+  // use the overload below whenever the rule type has first party patterns.
+  const SiteHackRule* Find(SiteHackRuleType type, const GURL& url) const;
+
+  // Same as above, but a rule with a first party pattern also has to match
+  // |first_party|. A rule without one matches any first party, and an empty
+  // or invalid |first_party| only matches those.
+  const SiteHackRule* Find(SiteHackRuleType type,
+                           const GURL& url,
+                           const GURL& first_party) const;
+
+  size_t size() const { return size_; }
+
+ private:
+  struct CompiledRule {
+    explicit CompiledRule(const SiteHackRule& rule);
+    CompiledRule(const CompiledRule& other);
+    ~CompiledRule();
+
+    const SiteHackRule* rule;
+    URLPattern pattern;
+    base::Optional<URLPattern> first_party_pattern;
+  };
+
+  const SiteHackRule* FindInternal(SiteHackRuleType type,
+                                   const GURL& url,
+                                   const GURL* first_party) const;
+
+  // Rules by the host of their pattern. Rules matching every host are kept
+  // under the empty host.
+  base::flat_map<std::string, std::vector<CompiledRule>> rules_by_host_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(SiteHackRuleTable);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_SITE_HACK_RULES_H_
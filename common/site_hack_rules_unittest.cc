@@ -0,0 +1,170 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/site_hack_rules.h"
+
+#include <string>
+
+#include "base/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+const SiteHackRule kTestRules[] = {
+  {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+      "https://*.example.com/*", nullptr, nullptr},
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "https://cdn.example.com/ads.js", nullptr, nullptr},
+  {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+      "https://exact.test/*", nullptr, nullptr},
+  {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+      "https://media.test/*", "https://site.test/*", nullptr},
+  {kExtraCookiesRule, URLPattern::SCHEME_ALL,
+      "https://news.test/*", nullptr, "a=1"},
+  {kSystemRequestAllowedRule, URLPattern::SCHEME_ALL,
+      "https://*/allowed/*", nullptr, nullptr},
+};
+
+}  // namespace
+
+TEST(SiteHackRuleTableTest, DispatchesOnHostAndParentDomains) {
+  SiteHackRuleTable table(kTestRules, arraysize(kTestRules));
+  EXPECT_EQ(arraysize(kTestRules), table.size());
+
+  EXPECT_TRUE(table.Find(kUAWhitelistedRule, GURL("https://example.com/")));
+  EXPECT_TRUE(table.Find(kUAWhitelistedRule,
+                         GURL("https://a.b.example.com/x")));
+  EXPECT_FALSE(table.Find(kUAWhitelistedRule,
+                          GURL("https://notexample.com/")));
+  EXPECT_FALSE(table.Find(kUAWhitelistedRule, GURL("http://example.com/")));
+
+  EXPECT_TRUE(table.Find(kBlockedResourceRule,
+                         GURL("https://cdn.example.com/ads.js")));
+  EXPECT_FALSE(table.Find(kBlockedResourceRule,
+                          GURL("https://cdn.example.com/app.js")));
+  // The rule for exact.test does not cover its subdomains.
+  EXPECT_TRUE(table.Find(kBlockedResourceRule, GURL("https://exact.test/")));
+  EXPECT_FALSE(table.Find(kBlockedResourceRule,
+                          GURL("https://www.exact.test/")));
+
+  EXPECT_TRUE(table.Find(kSystemRequestAllowedRule,
+                         GURL("https://anything.test/allowed/1")));
+  EXPECT_FALSE(table.Find(kSystemRequestAllowedRule,
+                          GURL("https://anything.test/other")));
+
+  const SiteHackRule* rule =
+      table.Find(kExtraCookiesRule, GURL("https://news.test/story"));
+  ASSERT_TRUE(rule);
+  EXPECT_STREQ("a=1", rule->value);
+}
+
+TEST(SiteHackRuleTableTest, FirstPartyPattern) {
+  SiteHackRuleTable table(kTestRules, arraysize(kTestRules));
+  GURL url("https://media.test/image.png");
+
+  EXPECT_TRUE(table.Find(kWhitelistedReferrerRule, url));
+  EXPECT_TRUE(table.Find(kWhitelistedReferrerRule, url,
+                         GURL("https://site.test/")));
+  EXPECT_FALSE(table.Find(kWhitelistedReferrerRule, url,
+                          GURL("https://other.test/")));
+  EXPECT_FALSE(table.Find(kWhitelistedReferrerRule, url, GURL()));
+}
+
+TEST(SiteHackRuleTableTest, ShippedRules) {
+  const SiteHackRuleTable& table = SiteHackRuleTable::GetInstance();
+  EXPECT_TRUE(table.Find(kUAWhitelistedRule,
+                         GURL("https://www.netflix.com/watch")));
+  EXPECT_TRUE(table.Find(kBlockedResourceRule,
+                         GURL("https://sp1.nypost.com/")));
+  EXPECT_TRUE(table.Find(kBlockedResourceRule,
+                         GURL("https://a.y8.com/js/sdkloader/outstream.js")));
+  EXPECT_TRUE(table.Find(kGeolocationRedirectRule,
+      GURL("https://www.googleapis.com/geolocation/v1/geolocate?key=1")));
+  EXPECT_TRUE(table.Find(kSafeBrowsingRedirectRule,
+      GURL("https://safebrowsing.googleapis.com/v4/threatListUpdates")));
+  EXPECT_TRUE(table.Find(kBlockedForReferrerRule,
+      GURL("https://mobile.twitter.com/i/nojs_router?path=%2F"),
+      GURL("https://twitter.com/brave")));
+  EXPECT_FALSE(table.Find(kBlockedForReferrerRule,
+      GURL("https://mobile.twitter.com/i/nojs_router?path=%2F"),
+      GURL("https://example.com/")));
+}
+
+// The table gives the same answers as matching every rule with URLPattern.
+TEST(SiteHackRuleTableTest, MatchesURLPatternScan) {
+  const SiteHackRule kRules[] = {
+    {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+        "https://*.adobe.com/*", nullptr, nullptr},
+    {kUAWhitelistedRule, URLPattern::SCHEME_ALL,
+        "https://*.netflix.com/*", nullptr, nullptr},
+    {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+        "https://www.lesechos.fr/xtcore.js", nullptr, nullptr},
+    {kBlockedResourceRule, URLPattern::SCHEME_ALL,
+        "*://sp1.nypost.com/*", nullptr, nullptr},
+    {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+        "https://cdn.embedly.com/*", "https://www.reddit.com/*", nullptr},
+    {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+        "https://imgur.com/*", "https://www.reddit.com/*", nullptr},
+    {kWhitelistedReferrerRule, URLPattern::SCHEME_HTTPS,
+        "https://*.fbcdn.net/*", "https://www.facebook.com/", nullptr},
+    {kWhitelistedReferrerRule, URLPattern::SCHEME_ALL,
+        "https://use.typekit.net/*", nullptr, nullptr},
+    {kSystemRequestAllowedRule, URLPattern::SCHEME_HTTPS,
+        "https://*/safebrowsing/*", nullptr, nullptr},
+  };
+  SiteHackRuleTable table(kRules, arraysize(kRules));
+
+  const char* kHosts[] = {
+    "www.google.com", "fonts.gstatic.com", "www.forbes.com",
+    "cdn.embedly.com", "imgur.com", "i.imgur.com", "www.reddit.com",
+    "scontent.xx.fbcdn.net", "use.typekit.net", "www.lesechos.fr",
+    "sp1.nypost.com", "www.netflix.com", "assets.adobe.com", "adobe.com",
+  };
+  const char* kPaths[] = {
+    "/xtcore.js", "/safebrowsing/list", "/image.png",
+  };
+  const GURL kFirstParties[] = {
+    GURL("https://www.reddit.com/"), GURL("https://www.facebook.com/"),
+    GURL("https://example.com/"),
+  };
+  const SiteHackRuleType kTypes[] = {
+    kUAWhitelistedRule, kBlockedResourceRule, kWhitelistedReferrerRule,
+    kSystemRequestAllowedRule,
+  };
+
+  const char* kSchemes[] = {"https://", "http://"};
+
+  for (const char* scheme : kSchemes) {
+    for (const char* host : kHosts) {
+      for (const char* path : kPaths) {
+        GURL url(std::string(scheme) + host + path);
+        for (SiteHackRuleType type : kTypes) {
+          for (const GURL& first_party : kFirstParties) {
+            bool expected = false;
+            for (const SiteHackRule& rule : kRules) {
+              if (rule.type != type ||
+                  !URLPattern(rule.valid_schemes, rule.pattern)
+                       .MatchesURL(url))
+                continue;
+              if (rule.first_party_pattern &&
+                  !URLPattern(rule.valid_schemes, rule.first_party_pattern)
+                       .MatchesURL(first_party))
+                continue;
+              expected = true;
+              break;
+            }
+            EXPECT_EQ(expected, table.Find(type, url, first_party) != nullptr)
+                << url << " " << first_party;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace brave
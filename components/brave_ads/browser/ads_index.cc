@@ -0,0 +1,65 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/browser/ads_index.h"
+
+#include <algorithm>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+
+namespace brave_ads {
+
+AdsIndex::AdsIndex() {
+}
+
+AdsIndex::~AdsIndex() {
+}
+
+void AdsIndex::Add(const std::string& category,
+                   const std::string& region,
+                   const ads::AdInfo& info) {
+  ads_[std::make_pair(category, region)].push_back(info);
+}
+
+void AdsIndex::Finalize() {
+  for (auto& category_ads : ads_) {
+    std::stable_sort(category_ads.second.begin(), category_ads.second.end(),
+        [](const ads::AdInfo& a, const ads::AdInfo& b) {
+          return a.start_timestamp < b.start_timestamp;
+        });
+  }
+}
+
+std::vector<ads::AdInfo> AdsIndex::GetAds(const std::string& region,
+                                          const std::string& category,
+                                          const std::string& now) const {
+  std::vector<ads::AdInfo> ads;
+
+  auto it = ads_.find(std::make_pair(category, region));
+  if (it == ads_.end())
+    return ads;
+
+  // Ads are sorted by start timestamp, so stop at the first one which has not
+  // started yet
+  for (const auto& info : it->second) {
+    if (info.start_timestamp > now)
+      break;
+    if (info.end_timestamp >= now)
+      ads.push_back(info);
+  }
+
+  return ads;
+}
+
+// static
+std::string AdsIndex::FormatTime(base::Time time) {
+  base::Time::Exploded exploded;
+  time.LocalExplode(&exploded);
+  return base::StringPrintf("%04d-%02d-%02d %02d:%02d",
+      exploded.year, exploded.month, exploded.day_of_month,
+      exploded.hour, exploded.minute);
+}
+
+}  // namespace brave_ads
@@ -0,0 +1,56 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_ADS_BROWSER_ADS_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_ADS_BROWSER_ADS_INDEX_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "bat/ads/ad_info.h"
+
+namespace base {
+class Time;
+}  // namespace base
+
+namespace brave_ads {
+
+// In-memory copy of the ads stored by BundleStateDatabase, keyed by category
+// and region, so ads can be served without a round trip to SQLite. It is
+// built on the file task runner and then only read on the UI thread.
+//
+// Times are the "%Y-%m-%d %H:%M" local time strings the database compares
+// against, so the index matches the ads the query would return.
+class AdsIndex {
+ public:
+  AdsIndex();
+  ~AdsIndex();
+
+  void Add(const std::string& category,
+           const std::string& region,
+           const ads::AdInfo& info);
+  // Call once all ads were added
+  void Finalize();
+
+  // Returns the ads for |category| and |region| which run at |now|
+  std::vector<ads::AdInfo> GetAds(const std::string& region,
+                                  const std::string& category,
+                                  const std::string& now) const;
+
+  // Formats |time| the way GetAds() expects
+  static std::string FormatTime(base::Time time);
+
+ private:
+  // (category, region) to ads sorted by start timestamp
+  std::map<std::pair<std::string, std::string>, std::vector<ads::AdInfo>> ads_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdsIndex);
+};
+
+}  // namespace brave_ads
+
+#endif  // BRAVE_COMPONENTS_BRAVE_ADS_BROWSER_ADS_INDEX_H_
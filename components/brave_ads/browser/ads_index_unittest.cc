@@ -0,0 +1,110 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/browser/ads_index.h"
+
+#include <string>
+#include <vector>
+
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=AdsIndexTest.*
+
+namespace brave_ads {
+
+namespace {
+
+// Timestamps are stored by datetime(), which adds seconds
+ads::AdInfo CreateAdInfo(const std::string& uuid,
+                         const std::string& start_timestamp,
+                         const std::string& end_timestamp) {
+  ads::AdInfo info;
+  info.uuid = uuid;
+  info.start_timestamp = start_timestamp;
+  info.end_timestamp = end_timestamp;
+  return info;
+}
+
+std::vector<std::string> GetUuids(const std::vector<ads::AdInfo>& ads) {
+  std::vector<std::string> uuids;
+  for (const auto& info : ads)
+    uuids.push_back(info.uuid);
+  return uuids;
+}
+
+}  // namespace
+
+TEST(AdsIndexTest, LooksUpCategoryAndRegion) {
+  AdsIndex index;
+  index.Add("Technology", "US",
+      CreateAdInfo("us", "2019-01-01 00:00:00", "2019-12-31 00:00:00"));
+  index.Add("Technology", "CA",
+      CreateAdInfo("ca", "2019-01-01 00:00:00", "2019-12-31 00:00:00"));
+  index.Add("Travel", "US",
+      CreateAdInfo("travel", "2019-01-01 00:00:00", "2019-12-31 00:00:00"));
+  index.Finalize();
+
+  const std::string now = "2019-06-01 12:00";
+  EXPECT_EQ(std::vector<std::string>({"us"}),
+            GetUuids(index.GetAds("US", "Technology", now)));
+  EXPECT_EQ(std::vector<std::string>({"ca"}),
+            GetUuids(index.GetAds("CA", "Technology", now)));
+  EXPECT_EQ(std::vector<std::string>({"travel"}),
+            GetUuids(index.GetAds("US", "Travel", now)));
+  EXPECT_TRUE(index.GetAds("CA", "Travel", now).empty());
+  EXPECT_TRUE(index.GetAds("US", "Sports", now).empty());
+}
+
+// The "%Y-%m-%d %H:%M" time is a prefix of the stored "%Y-%m-%d %H:%M:%S"
+// timestamps, so it sorts before them. Like the SQL query, an ad starting on
+// the current minute is not served yet, and one ending on it still is.
+TEST(AdsIndexTest, StartAndEndBoundaries) {
+  AdsIndex index;
+  index.Add("Technology", "US",
+      CreateAdInfo("ad", "2019-06-01 10:00:00", "2019-06-01 12:00:00"));
+  index.Finalize();
+
+  EXPECT_TRUE(index.GetAds("US", "Technology", "2019-06-01 09:59").empty());
+  EXPECT_TRUE(index.GetAds("US", "Technology", "2019-06-01 10:00").empty());
+  EXPECT_EQ(1u, index.GetAds("US", "Technology", "2019-06-01 10:01").size());
+  EXPECT_EQ(1u, index.GetAds("US", "Technology", "2019-06-01 12:00").size());
+  EXPECT_TRUE(index.GetAds("US", "Technology", "2019-06-01 12:01").empty());
+}
+
+TEST(AdsIndexTest, StopsAtFirstAdNotStarted) {
+  AdsIndex index;
+  // Added out of order, Finalize() sorts them by start timestamp
+  index.Add("Technology", "US",
+      CreateAdInfo("future", "2019-07-01 00:00:00", "2019-12-31 00:00:00"));
+  index.Add("Technology", "US",
+      CreateAdInfo("expired", "2019-01-01 00:00:00", "2019-02-01 00:00:00"));
+  index.Add("Technology", "US",
+      CreateAdInfo("running", "2019-03-01 00:00:00", "2019-12-31 00:00:00"));
+  index.Add("Technology", "US",
+      CreateAdInfo("earlier", "2019-02-01 00:00:00", "2019-12-31 00:00:00"));
+  index.Finalize();
+
+  EXPECT_EQ(std::vector<std::string>({"earlier", "running"}),
+            GetUuids(index.GetAds("US", "Technology", "2019-06-01 12:00")));
+  EXPECT_EQ(std::vector<std::string>({"earlier", "running", "future"}),
+            GetUuids(index.GetAds("US", "Technology", "2019-08-01 12:00")));
+}
+
+TEST(AdsIndexTest, FormatTime) {
+  base::Time::Exploded exploded = {0};
+  exploded.year = 2019;
+  exploded.month = 6;
+  exploded.day_of_month = 1;
+  exploded.hour = 9;
+  exploded.minute = 5;
+  exploded.second = 30;
+  base::Time time;
+  ASSERT_TRUE(base::Time::FromLocalExploded(exploded, &time));
+
+  EXPECT_EQ("2019-06-01 09:05", AdsIndex::FormatTime(time));
+}
+
+}  // namespace brave_ads
@@ -17,12 +17,14 @@
 #include "base/sequenced_task_runner.h"
 #include "base/task_runner_util.h"
 #include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/time/time.h"
 #include "bat/ads/ads.h"
 #include "bat/ads/notification_info.h"
 #include "bat/ads/notification_result_type.h"
 #include "bat/ads/resources/grit/bat_ads_resources.h"
 #include "brave/components/brave_ads/browser/ad_notification.h"
+#include "brave/components/brave_ads/browser/ads_index.h"
 #include "brave/components/brave_ads/browser/bundle_state_database.h"
 #include "brave/components/brave_ads/common/pref_names.h"
 #include "brave/components/brave_rewards/common/pref_names.h"
@@ -234,6 +236,15 @@ std::vector<ads::AdInfo> GetAdsForCategoryOnFileTaskRunner(
   return ads;
 }
 
+std::unique_ptr<AdsIndex> LoadAdsIndexOnFileTaskRunner(
+    BundleStateDatabase* backend) {
+  auto index = std::make_unique<AdsIndex>();
+  if (!backend || !backend->GetAdsIndex(index.get()))
+    return nullptr;
+
+  return index;
+}
+
 bool ResetOnFileTaskRunner(
     const base::FilePath& path) {
   return base::DeleteFile(path, false);
@@ -259,6 +270,8 @@ AdsServiceImpl::AdsServiceImpl(Profile* profile) :
     next_timer_id_(0),
     bundle_state_backend_(
         new BundleStateDatabase(base_path_.AppendASCII("bundle_state"))),
+    ads_index_loading_(false),
+    ads_index_generation_(0),
     display_service_(NotificationDisplayService::GetForProfile(profile_)),
 #if !defined(OS_ANDROID)
     last_idle_state_(ui::IdleState::IDLE_STATE_ACTIVE),
@@ -435,6 +448,8 @@ void AdsServiceImpl::Shutdown() {
   bat_ads_.reset();
   bat_ads_client_binding_.Close();
 
+  ads_index_.reset();
+
   for (NotificationInfoMap::iterator it = notification_ids_.begin();
       it != notification_ids_.end(); ++it) {
     const std::string notification_id = it->first;
@@ -640,6 +655,11 @@ const std::string AdsServiceImpl::LoadJsonSchema(const std::string& name) {
 void AdsServiceImpl::SaveBundleState(
     std::unique_ptr<ads::BundleState> bundle_state,
     ads::OnSaveCallback callback) {
+  // Drop the index and any load in flight, they no longer match the database
+  ads_index_.reset();
+  ads_index_loading_ = false;
+  ads_index_generation_++;
+
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
       base::BindOnce(&SaveBundleStateOnFileTaskRunner,
                     base::Passed(std::move(bundle_state)),
@@ -651,10 +671,36 @@ void AdsServiceImpl::SaveBundleState(
 
 void AdsServiceImpl::OnSaveBundleState(const ads::OnSaveCallback& callback,
                                        bool success) {
+  if (success)
+    LoadAdsIndex();
+
   if (connected())
     callback(success ? ads::Result::SUCCESS : ads::Result::FAILED);
 }
 
+void AdsServiceImpl::LoadAdsIndex() {
+  if (ads_index_ || ads_index_loading_)
+    return;
+
+  ads_index_loading_ = true;
+  base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&LoadAdsIndexOnFileTaskRunner,
+                     bundle_state_backend_.get()),
+      base::BindOnce(&AdsServiceImpl::OnAdsIndexLoaded,
+                     AsWeakPtr(),
+                     ads_index_generation_));
+}
+
+void AdsServiceImpl::OnAdsIndexLoaded(uint32_t generation,
+                                      std::unique_ptr<AdsIndex> index) {
+  // The bundle was saved again while loading
+  if (generation != ads_index_generation_)
+    return;
+
+  ads_index_loading_ = false;
+  ads_index_ = std::move(index);
+}
+
 void AdsServiceImpl::OnLoaded(
     const ads::OnLoadCallback& callback,
     const std::string& value) {
@@ -693,6 +739,22 @@ void AdsServiceImpl::GetAds(
       const std::string& region,
       const std::string& category,
       ads::OnGetAdsCallback callback) {
+  if (ads_index_) {
+    // Still reply asynchronously, like the database query does
+    base::SequencedTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+        base::BindOnce(&AdsServiceImpl::OnGetAdsForCategory,
+                       AsWeakPtr(),
+                       std::move(callback),
+                       region,
+                       category,
+                       ads_index_->GetAds(region, category,
+                           AdsIndex::FormatTime(base::Time::Now()))));
+    return;
+  }
+
+  // Query the database until the index is ready
+  LoadAdsIndex();
+
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
       base::BindOnce(&GetAdsForCategoryOnFileTaskRunner,
                     region,
@@ -39,6 +39,7 @@ class SequencedTaskRunner;
 namespace brave_ads {
 
 class AdsNotificationHandler;
+class AdsIndex;
 class BundleStateDatabase;
 
 class AdsServiceImpl : public AdsService,
@@ -161,6 +162,8 @@ class AdsServiceImpl : public AdsService,
                            const std::string& category,
                            const std::vector<ads::AdInfo>& ads);
   void OnSaveBundleState(const ads::OnSaveCallback& callback, bool success);
+  void LoadAdsIndex();
+  void OnAdsIndexLoaded(uint32_t generation, std::unique_ptr<AdsIndex> index);
   void OnLoaded(const ads::OnLoadCallback& callback,
                 const std::string& value);
   void OnSaved(const ads::OnSaveCallback& callback, bool success);
@@ -184,6 +187,10 @@ class AdsServiceImpl : public AdsService,
   std::map<uint32_t, std::unique_ptr<base::OneShotTimer>> timers_;
   uint32_t next_timer_id_;
   std::unique_ptr<BundleStateDatabase> bundle_state_backend_;
+  // Ads from |bundle_state_backend_|, reloaded after every bundle update
+  std::unique_ptr<AdsIndex> ads_index_;
+  bool ads_index_loading_;
+  uint32_t ads_index_generation_;
   NotificationDisplayService* display_service_;  // NOT OWNED
 #if !defined(OS_ANDROID)
   ui::IdleState last_idle_state_;
@@ -8,11 +8,14 @@
 #include <stdint.h>
 
 #include <map>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "brave/components/brave_ads/browser/ads_index.h"
 #include "build/build_config.h"
 #include "sql/meta_table.h"
 #include "sql/statement.h"
@@ -25,11 +28,15 @@ namespace {
 const int kCurrentVersionNumber = 2;
 const int kCompatibleVersionNumber = 2;
 
+// SQLite value of PRAGMA auto_vacuum for incremental mode
+const int kAutoVacuumIncremental = 2;
+
 }  // namespace
 
 BundleStateDatabase::BundleStateDatabase(const base::FilePath& db_path) :
     db_path_(db_path),
-    initialized_(false) {
+    initialized_(false),
+    auto_vacuum_checked_(false) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
@@ -45,6 +52,11 @@ bool BundleStateDatabase::Init() {
   if (!db_.Open(db_path_))
     return false;
 
+  // Only applies to a new database, SaveBundleState() converts an existing
+  // one
+  if (!db_.Execute("PRAGMA auto_vacuum = INCREMENTAL"))
+    return false;
+
   // TODO(brave): add error delegate
   sql::Transaction committer(&db_);
   if (!committer.Begin())
@@ -90,21 +102,6 @@ bool BundleStateDatabase::CreateCategoryTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateCategoryTable() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
-  sql::Statement sql(
-      GetDB().GetCachedStatement(SQL_FROM_HERE, "DELETE FROM category"));
-  return sql.Run();
-}
-
-
 bool BundleStateDatabase::CreateAdInfoTable() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -134,20 +131,6 @@ bool BundleStateDatabase::CreateAdInfoTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateAdInfoTable() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-
-  bool initialized = Init();
-  DCHECK(initialized);
-
-  if (!initialized)
-    return false;
-
-  sql::Statement sql(
-      GetDB().GetCachedStatement(SQL_FROM_HERE, "DELETE FROM ad_info"));
-  return sql.Run();
-}
-
 bool BundleStateDatabase::CreateAdInfoCategoryTable() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -174,26 +157,65 @@ bool BundleStateDatabase::CreateAdInfoCategoryTable() {
   return GetDB().Execute(sql.c_str());
 }
 
-bool BundleStateDatabase::TruncateAdInfoCategoryTable() {
+bool BundleStateDatabase::CreateAdInfoCategoryNameIndex() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  bool initialized = Init();
-  DCHECK(initialized);
+  return GetDB().Execute(
+      "CREATE INDEX IF NOT EXISTS ad_info_category_category_name_index "
+      "ON ad_info_category (category_name)");
+}
 
-  if (!initialized)
-    return false;
+void BundleStateDatabase::EnsureIncrementalAutoVacuum() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (auto_vacuum_checked_)
+    return;
+  auto_vacuum_checked_ = true;
+
+  int auto_vacuum = 0;
+  {
+    sql::Statement statement(GetDB().GetUniqueStatement("PRAGMA auto_vacuum"));
+    if (!statement.Step())
+      return;
+    auto_vacuum = statement.ColumnInt(0);
+  }
+  if (auto_vacuum == kAutoVacuumIncremental)
+    return;
 
-  sql::Statement sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
-      "DELETE FROM ad_info_category"));
-  return sql.Run();
+  // Switching an existing database over needs one full vacuum, from then on
+  // IncrementalVacuum() keeps the file small. The database works either way.
+  DCHECK_EQ(0, db_.transaction_nesting());
+  ignore_result(GetDB().Execute("VACUUM"));
 }
 
-bool BundleStateDatabase::CreateAdInfoCategoryNameIndex() {
+bool BundleStateDatabase::GetCategories(std::set<std::string>* categories) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  return GetDB().Execute(
-      "CREATE INDEX IF NOT EXISTS ad_info_category_category_name_index "
-      "ON ad_info_category (category_name)");
+  sql::Statement statement(
+      GetDB().GetUniqueStatement("SELECT name FROM category"));
+  while (statement.Step())
+    categories->insert(statement.ColumnString(0));
+  return statement.Succeeded();
+}
+
+bool BundleStateDatabase::GetAdInfoKeys(AdInfoKeys* keys) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Statement statement(
+      GetDB().GetUniqueStatement("SELECT region, uuid FROM ad_info"));
+  while (statement.Step())
+    keys->emplace(statement.ColumnString(0), statement.ColumnString(1));
+  return statement.Succeeded();
+}
+
+bool BundleStateDatabase::GetAdInfoCategoryKeys(AdInfoCategoryKeys* keys) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Statement statement(GetDB().GetUniqueStatement(
+      "SELECT ad_info_uuid, category_name FROM ad_info_category"));
+  while (statement.Step())
+    keys->emplace(statement.ColumnString(0), statement.ColumnString(1));
+  return statement.Succeeded();
 }
 
 bool BundleStateDatabase::SaveBundleState(
@@ -209,43 +231,96 @@ bool BundleStateDatabase::SaveBundleState(
   if (!GetDB().BeginTransaction())
     return false;
 
-  // we are completely replacing here so first truncate all the tables
-  if (!TruncateAdInfoCategoryTable() ||
-      !TruncateAdInfoTable() ||
-      !TruncateCategoryTable()) {
+  // Only rows which changed are written. Whatever is stored but no longer in
+  // |bundle_state| is left in the stale sets and deleted at the end.
+  std::set<std::string> stale_categories;
+  AdInfoKeys stale_ad_infos;
+  AdInfoCategoryKeys stale_ad_info_categories;
+  if (!GetCategories(&stale_categories) ||
+      !GetAdInfoKeys(&stale_ad_infos) ||
+      !GetAdInfoCategoryKeys(&stale_ad_info_categories)) {
     GetDB().RollbackTransaction();
     return false;
   }
 
-  auto categories = bundle_state.categories;
-  for (std::map<std::string, std::vector<ads::AdInfo>>::iterator it =
-      categories.begin();  it != categories.end(); ++it) {
-    auto category = it->first;
-    if (!InsertOrUpdateCategory(category)) {
+  AdInfoKeys saved_ad_infos;
+  AdInfoCategoryKeys saved_ad_info_categories;
+  for (const auto& category_ads : bundle_state.categories) {
+    const std::string& category = category_ads.first;
+    if (!stale_categories.erase(category) &&
+        !InsertOrUpdateCategory(category)) {
       GetDB().RollbackTransaction();
       return false;
     }
 
-    auto ads = it->second;
-    for (std::vector<ads::AdInfo>::iterator ad_it = ads.begin();
-        ad_it != ads.end(); ++ad_it) {
-      auto ad_info = *ad_it;
-      if (!InsertOrUpdateAdInfo(ad_info) ||
-          !InsertOrUpdateAdInfoCategory(ad_info, category)) {
+    for (const auto& ad_info : category_ads.second) {
+      if (!SaveAdInfo(ad_info, &stale_ad_infos, &saved_ad_infos)) {
         GetDB().RollbackTransaction();
         return false;
       }
+
+      auto key = std::make_pair(ad_info.uuid, category);
+      if (!saved_ad_info_categories.insert(key).second ||
+          stale_ad_info_categories.erase(key))
+        continue;
+      if (!InsertOrUpdateAdInfoCategory(ad_info, category)) {
+        GetDB().RollbackTransaction();
+        return false;
+      }
+    }
+  }
+
+  for (const auto& key : stale_ad_info_categories) {
+    if (!DeleteAdInfoCategory(key.first, key.second)) {
+      GetDB().RollbackTransaction();
+      return false;
+    }
+  }
+  for (const auto& key : stale_ad_infos) {
+    if (!DeleteAdInfo(key.first, key.second)) {
+      GetDB().RollbackTransaction();
+      return false;
+    }
+  }
+  for (const auto& category : stale_categories) {
+    if (!DeleteCategory(category)) {
+      GetDB().RollbackTransaction();
+      return false;
     }
   }
 
   if (GetDB().CommitTransaction()) {
-    Vacuum();
+    // Done here rather than in Init() so that the full vacuum a conversion
+    // needs does not delay the first read
+    EnsureIncrementalAutoVacuum();
+    IncrementalVacuum();
     return true;
   }
 
   return false;
 }
 
+bool BundleStateDatabase::SaveAdInfo(const ads::AdInfo& info,
+                                     AdInfoKeys* stale_keys,
+                                     AdInfoKeys* saved_keys) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  for (const auto& region : info.regions) {
+    auto key = std::make_pair(region, info.uuid);
+    // The same ad is listed under each of its categories
+    if (!saved_keys->insert(key).second)
+      continue;
+
+    bool saved = stale_keys->erase(key) ?
+        UpdateAdInfoIfChanged(info, region) :
+        InsertOrUpdateAdInfo(info, region);
+    if (!saved)
+      return false;
+  }
+
+  return true;
+}
+
 bool BundleStateDatabase::InsertOrUpdateCategory(const std::string& category) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -266,7 +341,8 @@ bool BundleStateDatabase::InsertOrUpdateCategory(const std::string& category) {
   return ad_info_statement.Run();
 }
 
-bool BundleStateDatabase::InsertOrUpdateAdInfo(const ads::AdInfo& info) {
+bool BundleStateDatabase::InsertOrUpdateAdInfo(const ads::AdInfo& info,
+                                               const std::string& region) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -275,33 +351,70 @@ bool BundleStateDatabase::InsertOrUpdateAdInfo(const ads::AdInfo& info) {
   if (!initialized)
     return false;
 
-  for (auto it = info.regions.begin(); it != info.regions.end(); ++it) {
-    sql::Statement ad_info_statement(
-        GetDB().GetCachedStatement(SQL_FROM_HERE,
-            "INSERT OR REPLACE INTO ad_info "
-            "(creative_set_id, advertiser, notification_text, "
-            "notification_url, start_timestamp, end_timestamp, uuid, "
-            "campaign_id, daily_cap, per_day, total_max, region) "
-            "VALUES (?, ?, ?, ?, datetime(?), datetime(?), ?, ?, ?, ?, ?, ?)"));
-
-    ad_info_statement.BindString(0, info.creative_set_id);
-    ad_info_statement.BindString(1, info.advertiser);
-    ad_info_statement.BindString(2, info.notification_text);
-    ad_info_statement.BindString(3, info.notification_url);
-    ad_info_statement.BindString(4, info.start_timestamp);
-    ad_info_statement.BindString(5, info.end_timestamp);
-    ad_info_statement.BindString(6, info.uuid);
-    ad_info_statement.BindString(7, info.campaign_id);
-    ad_info_statement.BindInt(8, info.daily_cap);
-    ad_info_statement.BindInt(9, info.per_day);
-    ad_info_statement.BindInt(10, info.total_max);
-    ad_info_statement.BindString(11, *it);
-    if (!ad_info_statement.Run()) {
-      return false;
-    }
-  }
+  sql::Statement ad_info_statement(
+      GetDB().GetCachedStatement(SQL_FROM_HERE,
+          "INSERT OR REPLACE INTO ad_info "
+          "(creative_set_id, advertiser, notification_text, "
+          "notification_url, start_timestamp, end_timestamp, uuid, "
+          "campaign_id, daily_cap, per_day, total_max, region) "
+          "VALUES (?, ?, ?, ?, datetime(?), datetime(?), ?, ?, ?, ?, ?, ?)"));
+
+  ad_info_statement.BindString(0, info.creative_set_id);
+  ad_info_statement.BindString(1, info.advertiser);
+  ad_info_statement.BindString(2, info.notification_text);
+  ad_info_statement.BindString(3, info.notification_url);
+  ad_info_statement.BindString(4, info.start_timestamp);
+  ad_info_statement.BindString(5, info.end_timestamp);
+  ad_info_statement.BindString(6, info.uuid);
+  ad_info_statement.BindString(7, info.campaign_id);
+  ad_info_statement.BindInt(8, info.daily_cap);
+  ad_info_statement.BindInt(9, info.per_day);
+  ad_info_statement.BindInt(10, info.total_max);
+  ad_info_statement.BindString(11, region);
 
-  return true;
+  return ad_info_statement.Run();
+}
+
+bool BundleStateDatabase::UpdateAdInfoIfChanged(const ads::AdInfo& info,
+                                                const std::string& region) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  bool initialized = Init();
+  DCHECK(initialized);
+
+  if (!initialized)
+    return false;
+
+  // The WHERE clause leaves an unchanged row alone, so its pages are not
+  // rewritten
+  sql::Statement ad_info_statement(
+      GetDB().GetCachedStatement(SQL_FROM_HERE,
+          "UPDATE ad_info SET "
+          "creative_set_id = ?1, advertiser = ?2, notification_text = ?3, "
+          "notification_url = ?4, start_timestamp = datetime(?5), "
+          "end_timestamp = datetime(?6), campaign_id = ?7, daily_cap = ?8, "
+          "per_day = ?9, total_max = ?10 "
+          "WHERE region = ?11 AND uuid = ?12 AND ("
+          "creative_set_id IS NOT ?1 OR advertiser IS NOT ?2 OR "
+          "notification_text IS NOT ?3 OR notification_url IS NOT ?4 OR "
+          "start_timestamp IS NOT datetime(?5) OR "
+          "end_timestamp IS NOT datetime(?6) OR campaign_id IS NOT ?7 OR "
+          "daily_cap IS NOT ?8 OR per_day IS NOT ?9 OR total_max IS NOT ?10)"));
+
+  ad_info_statement.BindString(0, info.creative_set_id);
+  ad_info_statement.BindString(1, info.advertiser);
+  ad_info_statement.BindString(2, info.notification_text);
+  ad_info_statement.BindString(3, info.notification_url);
+  ad_info_statement.BindString(4, info.start_timestamp);
+  ad_info_statement.BindString(5, info.end_timestamp);
+  ad_info_statement.BindString(6, info.campaign_id);
+  ad_info_statement.BindInt(7, info.daily_cap);
+  ad_info_statement.BindInt(8, info.per_day);
+  ad_info_statement.BindInt(9, info.total_max);
+  ad_info_statement.BindString(10, region);
+  ad_info_statement.BindString(11, info.uuid);
+
+  return ad_info_statement.Run();
 }
 
 bool BundleStateDatabase::InsertOrUpdateAdInfoCategory(
@@ -327,6 +440,38 @@ bool BundleStateDatabase::InsertOrUpdateAdInfoCategory(
   return ad_info_statement.Run();
 }
 
+bool BundleStateDatabase::DeleteCategory(const std::string& category) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      "DELETE FROM category WHERE name = ?"));
+  statement.BindString(0, category);
+  return statement.Run();
+}
+
+bool BundleStateDatabase::DeleteAdInfo(const std::string& region,
+                                       const std::string& uuid) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      "DELETE FROM ad_info WHERE region = ? AND uuid = ?"));
+  statement.BindString(0, region);
+  statement.BindString(1, uuid);
+  return statement.Run();
+}
+
+bool BundleStateDatabase::DeleteAdInfoCategory(const std::string& uuid,
+                                               const std::string& category) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Statement statement(GetDB().GetCachedStatement(SQL_FROM_HERE,
+      "DELETE FROM ad_info_category "
+      "WHERE ad_info_uuid = ? AND category_name = ?"));
+  statement.BindString(0, uuid);
+  statement.BindString(1, category);
+  return statement.Run();
+}
+
 bool BundleStateDatabase::GetAdsForCategory(const std::string& region,
                                             const std::string& category,
                                             std::vector<ads::AdInfo>& ads) {
@@ -365,16 +510,59 @@ bool BundleStateDatabase::GetAdsForCategory(const std::string& region,
     info.start_timestamp = info_sql.ColumnString(4);
     info.end_timestamp = info_sql.ColumnString(5);
     info.uuid = info_sql.ColumnString(6);
-    info.campaign_id = info_sql.ColumnString(7);
-    info.daily_cap = info_sql.ColumnInt(8);
-    info.per_day = info_sql.ColumnInt(9);
-    info.total_max = info_sql.ColumnInt(10);
+    info.campaign_id = info_sql.ColumnString(8);
+    info.daily_cap = info_sql.ColumnInt(9);
+    info.per_day = info_sql.ColumnInt(10);
+    info.total_max = info_sql.ColumnInt(11);
     ads.emplace_back(info);
   }
 
   return true;
 }
 
+bool BundleStateDatabase::GetAdsIndex(AdsIndex* index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(index);
+
+  bool initialized = Init();
+  DCHECK(initialized);
+
+  if (!initialized)
+    return false;
+
+  sql::Statement info_sql(
+      db_.GetUniqueStatement(
+          "SELECT ai.creative_set_id, ai.advertiser, "
+          "ai.notification_text, ai.notification_url, "
+          "ai.start_timestamp, ai.end_timestamp, "
+          "ai.uuid, ai.region, ai.campaign_id, ai.daily_cap, "
+          "ai.per_day, ai.total_max, aic.category_name FROM ad_info AS ai "
+          "INNER JOIN ad_info_category AS aic "
+          "ON aic.ad_info_uuid = ai.uuid;"));
+
+  while (info_sql.Step()) {
+    ads::AdInfo info;
+    info.creative_set_id = info_sql.ColumnString(0);
+    info.advertiser = info_sql.ColumnString(1);
+    info.notification_text = info_sql.ColumnString(2);
+    info.notification_url = info_sql.ColumnString(3);
+    info.start_timestamp = info_sql.ColumnString(4);
+    info.end_timestamp = info_sql.ColumnString(5);
+    info.uuid = info_sql.ColumnString(6);
+    info.campaign_id = info_sql.ColumnString(8);
+    info.daily_cap = info_sql.ColumnInt(9);
+    info.per_day = info_sql.ColumnInt(10);
+    info.total_max = info_sql.ColumnInt(11);
+    index->Add(info_sql.ColumnString(12), info_sql.ColumnString(7), info);
+  }
+
+  if (!info_sql.Succeeded())
+    return false;
+
+  index->Finalize();
+  return true;
+}
+
 // static
 int BundleStateDatabase::GetCurrentVersion() {
   return kCurrentVersionNumber;
@@ -391,6 +579,18 @@ void BundleStateDatabase::Vacuum() {
   ignore_result(db_.Execute("VACUUM"));
 }
 
+void BundleStateDatabase::IncrementalVacuum() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (!initialized_)
+    return;
+
+  DCHECK_EQ(0, db_.transaction_nesting()) <<
+      "Can not have a transaction when vacuuming.";
+  // At most 256 pages (1MB with the default page size) per call
+  ignore_result(db_.Execute("PRAGMA incremental_vacuum(256)"));
+}
+
 void BundleStateDatabase::OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -6,7 +6,11 @@
 #define BRAVE_COMPONENTS_BRAVE_ADS_BROWSER_BUNDLE_DATA_DATABASE_H_
 
 #include <memory>
+#include <set>
 #include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "bat/ads/ad_info.h"
 #include "bat/ads/bundle_state.h"
@@ -22,6 +26,8 @@
 
 namespace brave_ads {
 
+class AdsIndex;
+
 class BundleStateDatabase {
  public:
   BundleStateDatabase(const base::FilePath& db_path);
@@ -37,6 +43,8 @@ class BundleStateDatabase {
   bool GetAdsForCategory(const std::string& region,
                          const std::string& category,
                          std::vector<ads::AdInfo>& ads);
+  // Reads every ad into |index| so they can be served from memory
+  bool GetAdsIndex(AdsIndex* index);
 
   // Returns the current version of the publisher info database
   static int GetCurrentVersion();
@@ -45,6 +53,10 @@ class BundleStateDatabase {
   // unused space in the file. It can be VERY SLOW.
   void Vacuum();
 
+  // Returns a bounded number of free pages to the file system. Cheap enough
+  // to run after every catalog update.
+  void IncrementalVacuum();
+
   std::string GetDiagnosticInfo(int extended_error, sql::Statement* statement);
 
  private:
@@ -57,15 +69,36 @@ class BundleStateDatabase {
   bool CreateAdInfoCategoryTable();
   bool CreateAdInfoCategoryNameIndex();
 
-  bool TruncateCategoryTable();
-  bool TruncateAdInfoTable();
-  bool TruncateAdInfoCategoryTable();
+  // Switches an existing database to incremental auto vacuum, once per
+  // session. Must be called outside of a transaction.
+  void EnsureIncrementalAutoVacuum();
+
+  // (region, uuid) keys of the ad_info table
+  using AdInfoKeys = std::set<std::pair<std::string, std::string>>;
+  // (uuid, category) pairs of the ad_info_category table
+  using AdInfoCategoryKeys = std::set<std::pair<std::string, std::string>>;
+
+  bool GetCategories(std::set<std::string>* categories);
+  bool GetAdInfoKeys(AdInfoKeys* keys);
+  bool GetAdInfoCategoryKeys(AdInfoCategoryKeys* keys);
+
+  bool SaveAdInfo(const ads::AdInfo& info,
+                  AdInfoKeys* stale_keys,
+                  AdInfoKeys* saved_keys);
 
   bool InsertOrUpdateCategory(const std::string& category);
-  bool InsertOrUpdateAdInfo(const ads::AdInfo& info);
+  bool InsertOrUpdateAdInfo(const ads::AdInfo& info,
+                            const std::string& region);
+  bool UpdateAdInfoIfChanged(const ads::AdInfo& info,
+                             const std::string& region);
   bool InsertOrUpdateAdInfoCategory(const ads::AdInfo& ad_info,
                                     const std::string& category);
 
+  bool DeleteCategory(const std::string& category);
+  bool DeleteAdInfo(const std::string& region, const std::string& uuid);
+  bool DeleteAdInfoCategory(const std::string& uuid,
+                            const std::string& category);
+
   sql::Database& GetDB();
   sql::MetaTable& GetMetaTable();
 
@@ -76,6 +109,7 @@ class BundleStateDatabase {
   sql::MetaTable meta_table_;
   const base::FilePath db_path_;
   bool initialized_;
+  bool auto_vacuum_checked_;
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
@@ -0,0 +1,174 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_ads/browser/bundle_state_database.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BundleStateDatabaseTest.*
+
+namespace brave_ads {
+
+namespace {
+
+ads::AdInfo CreateAdInfo(const std::string& uuid,
+                         const std::string& notification_text) {
+  ads::AdInfo info;
+  info.creative_set_id = "creative-set-" + uuid;
+  info.advertiser = "Brave";
+  info.notification_text = notification_text;
+  info.notification_url = "https://brave.com/" + uuid;
+  info.start_timestamp = "2019-01-01 00:00:00";
+  info.end_timestamp = "2099-01-01 00:00:00";
+  info.uuid = uuid;
+  info.campaign_id = "campaign-" + uuid;
+  info.daily_cap = 1;
+  info.per_day = 2;
+  info.total_max = 3;
+  info.regions = {"US"};
+  return info;
+}
+
+}  // namespace
+
+class BundleStateDatabaseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_file_ = temp_dir_.GetPath().AppendASCII("BundleStateDatabaseTest.db");
+  }
+
+  void CreateDatabase() {
+    bundle_state_database_ = std::make_unique<BundleStateDatabase>(db_file_);
+  }
+
+  // Reads through a second connection, the rows are what the next session
+  // would see
+  int CountTableRows(const std::string& table) {
+    sql::Database db;
+    if (!db.Open(db_file_))
+      return -1;
+
+    std::string sql = "SELECT COUNT(*) FROM " + table;
+    sql::Statement s(db.GetUniqueStatement(sql.c_str()));
+    if (!s.Step())
+      return -1;
+
+    return static_cast<int>(s.ColumnInt64(0));
+  }
+
+  std::string GetNotificationText(const std::string& uuid) {
+    sql::Database db;
+    if (!db.Open(db_file_))
+      return std::string();
+
+    sql::Statement s(db.GetUniqueStatement(
+        "SELECT notification_text FROM ad_info WHERE uuid = ?"));
+    s.BindString(0, uuid);
+    if (!s.Step())
+      return std::string();
+
+    return s.ColumnString(0);
+  }
+
+  int GetAutoVacuum() {
+    sql::Database db;
+    if (!db.Open(db_file_))
+      return -1;
+
+    sql::Statement s(db.GetUniqueStatement("PRAGMA auto_vacuum"));
+    if (!s.Step())
+      return -1;
+
+    return s.ColumnInt(0);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath db_file_;
+  std::unique_ptr<BundleStateDatabase> bundle_state_database_;
+};
+
+TEST_F(BundleStateDatabaseTest, SaveBundleStateAppliesDiff) {
+  CreateDatabase();
+
+  ads::BundleState first;
+  ads::AdInfo shared = CreateAdInfo("shared", "Shared");
+  shared.regions = {"US", "CA"};
+  first.categories["Technology"] = {CreateAdInfo("dropped", "Dropped"),
+                                    shared};
+  first.categories["Travel"] = {shared};
+  ASSERT_TRUE(bundle_state_database_->SaveBundleState(first));
+
+  EXPECT_EQ(2, CountTableRows("category"));
+  EXPECT_EQ(3, CountTableRows("ad_info"));
+  EXPECT_EQ(3, CountTableRows("ad_info_category"));
+
+  // "dropped" and the Travel category go away, "shared" changes and "added"
+  // is new
+  ads::BundleState second;
+  second.categories["Technology"] = {CreateAdInfo("shared", "Changed"),
+                                     CreateAdInfo("added", "Added")};
+  ASSERT_TRUE(bundle_state_database_->SaveBundleState(second));
+
+  EXPECT_EQ(1, CountTableRows("category"));
+  EXPECT_EQ(2, CountTableRows("ad_info"));
+  EXPECT_EQ(2, CountTableRows("ad_info_category"));
+  EXPECT_EQ("Changed", GetNotificationText("shared"));
+  EXPECT_EQ("Added", GetNotificationText("added"));
+  EXPECT_EQ(std::string(), GetNotificationText("dropped"));
+}
+
+TEST_F(BundleStateDatabaseTest, GetAdsForCategory) {
+  CreateDatabase();
+
+  ads::BundleState bundle_state;
+  bundle_state.categories["Technology"] = {CreateAdInfo("uuid", "Text")};
+  ASSERT_TRUE(bundle_state_database_->SaveBundleState(bundle_state));
+
+  std::vector<ads::AdInfo> ads;
+  ASSERT_TRUE(
+      bundle_state_database_->GetAdsForCategory("US", "Technology", ads));
+  ASSERT_EQ(1u, ads.size());
+  EXPECT_EQ("uuid", ads[0].uuid);
+  EXPECT_EQ("Text", ads[0].notification_text);
+  EXPECT_EQ("campaign-uuid", ads[0].campaign_id);
+  EXPECT_EQ(1u, ads[0].daily_cap);
+  EXPECT_EQ(2u, ads[0].per_day);
+  EXPECT_EQ(3u, ads[0].total_max);
+
+  ads.clear();
+  ASSERT_TRUE(
+      bundle_state_database_->GetAdsForCategory("CA", "Technology", ads));
+  EXPECT_TRUE(ads.empty());
+}
+
+TEST_F(BundleStateDatabaseTest, SaveConvertsToIncrementalAutoVacuum) {
+  // A database created before incremental auto vacuum was turned on
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(db_file_));
+    ASSERT_TRUE(db.Execute("CREATE TABLE category(name LONGVARCHAR)"));
+  }
+  ASSERT_EQ(0, GetAutoVacuum());
+
+  CreateDatabase();
+  ads::BundleState bundle_state;
+  bundle_state.categories["Technology"] = {CreateAdInfo("uuid", "Text")};
+  ASSERT_TRUE(bundle_state_database_->SaveBundleState(bundle_state));
+
+  // 2 is INCREMENTAL
+  EXPECT_EQ(2, GetAutoVacuum());
+  EXPECT_EQ(1, CountTableRows("ad_info"));
+}
+
+}  // namespace brave_ads
@@ -7,11 +7,16 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/trace_event/trace_event.h"
 #include "bat/ledger/media_publisher_info.h"
 #include "build/build_config.h"
 #include "sql/meta_table.h"
@@ -27,15 +32,85 @@ namespace {
 const int kCurrentVersionNumber = 4;
 const int kCompatibleVersionNumber = 1;
 
+// Queued activity rows are written out once there are this many of them.
+const size_t kMaxQueuedActivityInfo = 100;
+
+// GetActivityList has a fixed WHERE clause so that it can be cached; a filter
+// that is not set binds a value that lets every row through.
+#define ACTIVITY_LIST_SELECT \
+    "SELECT ai.publisher_id, ai.duration, ai.score, " \
+    "ai.percent, ai.weight, pi.verified, pi.excluded, " \
+    "ai.month, ai.year, pi.name, pi.url, pi.provider, " \
+    "pi.favIcon, ai.reconcile_stamp, ai.visits " \
+    "FROM activity_info AS ai " \
+    "INNER JOIN publisher_info AS pi " \
+    "ON ai.publisher_id = pi.publisher_id "
+
+#define ACTIVITY_LIST_FILTER \
+    "AND (?2 = -1 OR ai.month = ?2) " \
+    "AND (?3 <= 0 OR ai.year = ?3) " \
+    "AND (?4 = 0 OR ai.reconcile_stamp = ?4) " \
+    "AND ai.duration >= ?5 " \
+    "AND (?6 = -1 OR pi.excluded = ?6) " \
+    "AND (?7 = -1 OR pi.excluded != ?7) " \
+    "AND ai.percent >= ?8 " \
+    "AND ai.visits >= ?9 " \
+    "AND (?10 OR pi.verified = 1) " \
+    "AND (?15 = '' OR " \
+    "    (ai.publisher_id, ai.month, ai.year, ai.reconcile_stamp) " \
+    "    > (?15, ?16, ?17, ?18)) " \
+    "ORDER BY CASE ?11 " \
+    "WHEN 1 THEN ai.percent " \
+    "WHEN 2 THEN ai.duration " \
+    "WHEN 3 THEN ai.visits " \
+    "WHEN 4 THEN ai.score " \
+    "WHEN 5 THEN ai.weight " \
+    "END * ?12, ai.publisher_id, ai.month, ai.year, ai.reconcile_stamp " \
+    "LIMIT ?13 OFFSET ?14"
+
+const char kActivityListQuery[] =
+    ACTIVITY_LIST_SELECT "WHERE ?1 = '' " ACTIVITY_LIST_FILTER;
+// Matches the publisher id on its own so that looking up a single publisher,
+// which every visit does, can use the publisher_id index.
+const char kPublisherActivityListQuery[] =
+    ACTIVITY_LIST_SELECT "WHERE ai.publisher_id = ?1 " ACTIVITY_LIST_FILTER;
+
+// Columns GetActivityList can order by, numbered as in the CASE above.
+const char* const kActivityListOrderColumns[] = {
+    "ai.percent", "ai.duration", "ai.visits", "ai.score", "ai.weight"};
+
+// Queues |info| under |key| for PublisherInfoDatabase::FlushActivityInfo().
+template <typename Key>
+void QueueRow(
+    const Key& key,
+    const ledger::PublisherInfo& info,
+    uint64_t order,
+    std::map<Key, std::pair<uint64_t, ledger::PublisherInfo>>* queue) {
+  auto it = queue->find(key);
+  if (it == queue->end()) {
+    queue->emplace(key, std::make_pair(order, info));
+    return;
+  }
+  // A later row with no favicon keeps the one that is already queued, as
+  // writing the two in turn would.
+  std::string favicon_url = it->second.second.favicon_url;
+  it->second = std::make_pair(order, info);
+  if (info.favicon_url.empty()) {
+    it->second.second.favicon_url = favicon_url;
+  }
+}
+
 }  // namespace
 
 PublisherInfoDatabase::PublisherInfoDatabase(const base::FilePath& db_path) :
     db_path_(db_path),
-    initialized_(false) {
+    initialized_(false),
+    next_queued_activity_(0) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 PublisherInfoDatabase::~PublisherInfoDatabase() {
+  FlushActivityInfo();
 }
 
 bool PublisherInfoDatabase::Init() {
@@ -171,7 +246,9 @@ void PublisherInfoDatabase::GetTips(ledger::PublisherInfoList* list,
     return;
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(
+  FlushActivityInfo();
+
+  sql::Statement info_sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "SELECT pi.publisher_id, pi.name, pi.url, pi.favIcon, "
       "ci.probi, ci.date, pi.verified, pi.provider "
       "FROM contribution_info as ci "
@@ -233,6 +310,7 @@ bool PublisherInfoDatabase::CreatePublisherInfoTable() {
 
 bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
     const ledger::PublisherInfo& info) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::InsertOrUpdatePublisherInfo");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -242,6 +320,12 @@ bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
     return false;
   }
 
+  FlushActivityInfo();
+  return WritePublisherInfo(info);
+}
+
+bool PublisherInfoDatabase::WritePublisherInfo(
+    const ledger::PublisherInfo& info) {
   sql::Transaction transaction(&GetDB());
   if (!transaction.Begin()) {
     return false;
@@ -290,6 +374,7 @@ bool PublisherInfoDatabase::InsertOrUpdatePublisherInfo(
 
 std::unique_ptr<ledger::PublisherInfo>
 PublisherInfoDatabase::GetPublisherInfo(const std::string& publisher_key) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::GetPublisherInfo");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -299,7 +384,9 @@ PublisherInfoDatabase::GetPublisherInfo(const std::string& publisher_key) {
     return nullptr;
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(
+  FlushActivityInfo();
+
+  sql::Statement info_sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "SELECT publisher_id, name, url, favIcon, provider, verified, excluded "
       "FROM publisher_info WHERE publisher_id=?"));
 
@@ -326,6 +413,7 @@ PublisherInfoDatabase::GetPublisherInfo(const std::string& publisher_key) {
 std::unique_ptr<ledger::PublisherInfo>
 PublisherInfoDatabase::GetPanelPublisher(
     const ledger::ActivityInfoFilter& filter) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::GetPanelPublisher");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -335,7 +423,9 @@ PublisherInfoDatabase::GetPanelPublisher(
     return nullptr;
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(
+  FlushActivityInfo();
+
+  sql::Statement info_sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "SELECT pi.publisher_id, pi.name, pi.url, pi.favIcon, "
       "pi.provider, pi.verified, pi.excluded, "
       "("
@@ -377,7 +467,9 @@ bool PublisherInfoDatabase::RestorePublishers() {
     return false;
   }
 
-  sql::Statement restore_q(db_.GetUniqueStatement(
+  FlushActivityInfo();
+
+  sql::Statement restore_q(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "UPDATE publisher_info SET excluded=? WHERE excluded=?"));
 
   restore_q.BindInt(0, static_cast<int>(
@@ -435,6 +527,7 @@ bool PublisherInfoDatabase::CreateActivityInfoIndex() {
 
 bool PublisherInfoDatabase::InsertOrUpdateActivityInfo(
     const ledger::PublisherInfo& info) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::InsertOrUpdateActivityInfo");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -444,7 +537,100 @@ bool PublisherInfoDatabase::InsertOrUpdateActivityInfo(
     return false;
   }
 
-  if (!InsertOrUpdatePublisherInfo(info)) {
+  FlushActivityInfo();
+  return WriteActivityInfo(info);
+}
+
+void PublisherInfoDatabase::QueueActivityInfo(
+    const ledger::PublisherInfo& info) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (info.id.empty()) {
+    return;
+  }
+
+  QueueRow(ActivityKey(info.id, info.month, info.year, info.reconcile_stamp),
+           info, next_queued_activity_++, &queued_activity_);
+
+  if (queued_activity_.size() + queued_publishers_.size() >=
+      kMaxQueuedActivityInfo) {
+    FlushActivityInfo();
+  }
+}
+
+void PublisherInfoDatabase::QueuePublisherInfo(
+    const ledger::PublisherInfo& info) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (info.id.empty()) {
+    return;
+  }
+
+  QueueRow(info.id, info, next_queued_activity_++, &queued_publishers_);
+
+  if (queued_activity_.size() + queued_publishers_.size() >=
+      kMaxQueuedActivityInfo) {
+    FlushActivityInfo();
+  }
+}
+
+bool PublisherInfoDatabase::FlushActivityInfo() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (queued_activity_.empty() && queued_publishers_.empty()) {
+    return true;
+  }
+
+  TRACE_EVENT1("brave", "PublisherInfoDatabase::FlushActivityInfo",
+               "rows", queued_activity_.size() + queued_publishers_.size());
+
+  // Rows are written in the order they were last queued, so that the newest
+  // publisher details win.
+  struct Row {
+    uint64_t order;
+    const ledger::PublisherInfo* info;
+    bool activity;
+  };
+  std::vector<Row> rows;
+  rows.reserve(queued_activity_.size() + queued_publishers_.size());
+  for (const auto& queued : queued_activity_) {
+    rows.push_back({queued.second.first, &queued.second.second, true});
+  }
+  for (const auto& queued : queued_publishers_) {
+    rows.push_back({queued.second.first, &queued.second.second, false});
+  }
+  std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+    return a.order < b.order;
+  });
+
+  bool success = Init();
+  DCHECK(success);
+
+  sql::Transaction transaction(&GetDB());
+  if (success) {
+    success = transaction.Begin();
+  }
+
+  for (size_t i = 0; success && i < rows.size(); i++) {
+    success = rows[i].activity ? WriteActivityInfo(*rows[i].info)
+                               : WritePublisherInfo(*rows[i].info);
+  }
+
+  if (success) {
+    success = transaction.Commit();
+  } else {
+    LOG(ERROR) << "Failed to write " << rows.size() << " queued rows";
+  }
+
+  // Rows that failed are dropped, like a failed InsertOrUpdateActivityInfo.
+  queued_activity_.clear();
+  queued_publishers_.clear();
+  return success;
+}
+
+bool PublisherInfoDatabase::WriteActivityInfo(
+    const ledger::PublisherInfo& info) {
+  if (!WritePublisherInfo(info)) {
     return false;
   }
 
@@ -470,6 +656,7 @@ bool PublisherInfoDatabase::InsertOrUpdateActivityInfo(
 
 bool PublisherInfoDatabase::InsertOrUpdateActivityInfos(
     const ledger::PublisherInfoList& list) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::InsertOrUpdateActivityInfos");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -479,13 +666,15 @@ bool PublisherInfoDatabase::InsertOrUpdateActivityInfos(
     return false;
   }
 
+  FlushActivityInfo();
+
   sql::Transaction transaction(&GetDB());
   if (!transaction.Begin()) {
     return false;
   }
 
   for (const auto& info : list) {
-    if (!InsertOrUpdateActivityInfo(info)) {
+    if (info.id.empty() || !WriteActivityInfo(info)) {
       transaction.Rollback();
       return false;
     }
@@ -494,15 +683,11 @@ bool PublisherInfoDatabase::InsertOrUpdateActivityInfos(
   return transaction.Commit();
 }
 
-bool PublisherInfoDatabase::GetActivityList(
-    int start,
-    int limit,
-    const ledger::ActivityInfoFilter& filter,
-    ledger::PublisherInfoList* list) {
+bool PublisherInfoDatabase::UpdateActivityInfoWeights(
+    const ledger::PublisherInfoList& list) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::UpdateActivityInfoWeights");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  CHECK(list);
-
   bool initialized = Init();
   DCHECK(initialized);
 
@@ -510,112 +695,107 @@ bool PublisherInfoDatabase::GetActivityList(
     return false;
   }
 
-  std::string query = "SELECT ai.publisher_id, ai.duration, ai.score, "
-                      "ai.percent, ai.weight, pi.verified, pi.excluded, "
-                      "ai.month, ai.year, pi.name, pi.url, pi.provider, "
-                      "pi.favIcon, ai.reconcile_stamp, ai.visits "
-                      "FROM activity_info AS ai "
-                      "INNER JOIN publisher_info AS pi "
-                      "ON ai.publisher_id = pi.publisher_id "
-                      "WHERE 1 = 1";
-
-  if (!filter.id.empty()) {
-    query += " AND ai.publisher_id = ?";
-  }
-
-  if (filter.month != ledger::ACTIVITY_MONTH::ANY) {
-    query += " AND ai.month = ?";
-  }
-
-  if (filter.year > 0) {
-    query += " AND ai.year = ?";
-  }
-
-  if (filter.reconcile_stamp > 0) {
-    query += " AND ai.reconcile_stamp = ?";
-  }
-
-  if (filter.min_duration > 0) {
-    query += " AND ai.duration >= ?";
-  }
-
-  if (filter.excluded != ledger::EXCLUDE_FILTER::FILTER_ALL &&
-      filter.excluded !=
-        ledger::EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED) {
-    query += " AND pi.excluded = ?";
-  }
-
-  if (filter.excluded ==
-    ledger::EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED) {
-    query += " AND pi.excluded != ?";
-  }
-
-  if (filter.percent > 0) {
-    query += " AND ai.percent >= ?";
-  }
-
-  if (filter.min_visits > 0) {
-    query += " AND ai.visits >= ?";
-  }
+  FlushActivityInfo();
 
-  if (!filter.non_verified) {
-    query += " AND pi.verified = 1";
-  }
-
-  for (const auto& it : filter.order_by) {
-    query += " ORDER BY " + it.first;
-    query += (it.second ? " ASC" : " DESC");
+  sql::Transaction transaction(&GetDB());
+  if (!transaction.Begin()) {
+    return false;
   }
 
-  if (limit > 0) {
-    query += " LIMIT " + std::to_string(limit);
-
-    if (start > 1) {
-      query += " OFFSET " + std::to_string(start);
+  for (const auto& info : list) {
+    sql::Statement activity_info_update(
+      GetDB().GetCachedStatement(SQL_FROM_HERE,
+          "UPDATE activity_info SET score = ?, percent = ?, weight = ? "
+          "WHERE publisher_id = ? AND month = ? AND year = ? "
+          "AND reconcile_stamp = ?"));
+
+    activity_info_update.BindDouble(0, info.score);
+    activity_info_update.BindInt64(1, static_cast<int>(info.percent));
+    activity_info_update.BindDouble(2, info.weight);
+    activity_info_update.BindString(3, info.id);
+    activity_info_update.BindInt(4, info.month);
+    activity_info_update.BindInt(5, info.year);
+    activity_info_update.BindInt64(6, info.reconcile_stamp);
+
+    if (!activity_info_update.Run()) {
+      transaction.Rollback();
+      return false;
     }
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(query.c_str()));
+  return transaction.Commit();
+}
 
-  int column = 0;
-  if (!filter.id.empty()) {
-    info_sql.BindString(column++, filter.id);
-  }
+bool PublisherInfoDatabase::GetActivityList(
+    int start,
+    int limit,
+    const ledger::ActivityInfoFilter& filter,
+    ledger::PublisherInfoList* list) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::GetActivityList");
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  if (filter.month != ledger::ACTIVITY_MONTH::ANY) {
-    info_sql.BindInt(column++, filter.month);
-  }
+  CHECK(list);
 
-  if (filter.year > 0) {
-    info_sql.BindInt(column++, filter.year);
-  }
+  bool initialized = Init();
+  DCHECK(initialized);
 
-  if (filter.reconcile_stamp > 0) {
-    info_sql.BindInt64(column++, filter.reconcile_stamp);
+  if (!initialized) {
+    return false;
   }
 
-  if (filter.min_duration > 0) {
-    info_sql.BindInt(column++, filter.min_duration);
-  }
+  FlushActivityInfo();
 
-  if (filter.excluded != ledger::EXCLUDE_FILTER::FILTER_ALL &&
-      filter.excluded !=
-      ledger::EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED) {
-    info_sql.BindInt(column++, filter.excluded);
+  sql::Statement info_sql;
+  if (filter.id.empty()) {
+    info_sql.Assign(
+        GetDB().GetCachedStatement(SQL_FROM_HERE, kActivityListQuery));
+  } else {
+    info_sql.Assign(
+        GetDB().GetCachedStatement(SQL_FROM_HERE, kPublisherActivityListQuery));
   }
 
+  int excluded = -1;
+  int not_excluded = -1;
   if (filter.excluded ==
       ledger::EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED) {
-    info_sql.BindInt(column++, ledger::PUBLISHER_EXCLUDE::EXCLUDED);
-  }
-
-  if (filter.percent > 0) {
-    info_sql.BindInt(column++, filter.percent);
+    not_excluded = ledger::PUBLISHER_EXCLUDE::EXCLUDED;
+  } else if (filter.excluded != ledger::EXCLUDE_FILTER::FILTER_ALL) {
+    excluded = filter.excluded;
+  }
+
+  // Only the first order is used; more than one never made valid SQL. A
+  // keyset cursor needs the rows in key order, so it ignores |order_by|.
+  int order_column = 0;
+  int order_direction = 1;
+  if (!filter.order_by.empty() && filter.after_id.empty()) {
+    const auto& order = filter.order_by.front();
+    for (size_t i = 0; i < arraysize(kActivityListOrderColumns); i++) {
+      if (order.first == kActivityListOrderColumns[i]) {
+        order_column = static_cast<int>(i) + 1;
+        order_direction = order.second ? 1 : -1;
+        break;
+      }
+    }
   }
 
-  if (filter.min_visits > 0) {
-    info_sql.BindInt(column++, filter.min_visits);
-  }
+  info_sql.BindString(0, filter.id);
+  info_sql.BindInt(1, filter.month);
+  info_sql.BindInt(2, filter.year);
+  info_sql.BindInt64(3, filter.reconcile_stamp);
+  info_sql.BindInt64(4, filter.min_duration);
+  info_sql.BindInt(5, excluded);
+  info_sql.BindInt(6, not_excluded);
+  info_sql.BindInt64(7, filter.percent);
+  info_sql.BindInt64(8, filter.min_visits);
+  info_sql.BindBool(9, filter.non_verified);
+  info_sql.BindInt(10, order_column);
+  info_sql.BindInt(11, order_direction);
+  info_sql.BindInt(12, limit > 0 ? limit : -1);
+  info_sql.BindInt(13, limit > 0 && start > 1 ? start : 0);
+  info_sql.BindString(14, filter.after_id);
+  info_sql.BindInt(15, filter.after_month);
+  info_sql.BindInt(16, filter.after_year);
+  info_sql.BindInt64(17, filter.after_reconcile_stamp);
 
   while (info_sql.Step()) {
     std::string id(info_sql.ColumnString(0));
@@ -699,6 +879,7 @@ bool PublisherInfoDatabase::InsertOrUpdateMediaPublisherInfo(
 
 std::unique_ptr<ledger::PublisherInfo>
 PublisherInfoDatabase::GetMediaPublisherInfo(const std::string& media_key) {
+  TRACE_EVENT0("brave", "PublisherInfoDatabase::GetMediaPublisherInfo");
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   bool initialized = Init();
@@ -708,7 +889,9 @@ PublisherInfoDatabase::GetMediaPublisherInfo(const std::string& media_key) {
     return nullptr;
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(
+  FlushActivityInfo();
+
+  sql::Statement info_sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "SELECT pi.publisher_id, pi.name, pi.url, pi.favIcon, "
       "pi.provider, pi.verified, pi.excluded "
       "FROM media_publisher_info as mpi "
@@ -806,7 +989,9 @@ void PublisherInfoDatabase::GetRecurringDonations(
     return;
   }
 
-  sql::Statement info_sql(db_.GetUniqueStatement(
+  FlushActivityInfo();
+
+  sql::Statement info_sql(GetDB().GetCachedStatement(SQL_FROM_HERE,
       "SELECT pi.publisher_id, pi.name, pi.url, pi.favIcon, "
       "rd.amount, rd.added_date, pi.verified, pi.provider "
       "FROM recurring_donation as rd "
@@ -935,7 +1120,8 @@ double PublisherInfoDatabase::GetReservedAmount() {
   }
 
   sql::Statement info_sql(
-      db_.GetUniqueStatement("SELECT sum(amount) FROM pending_contribution"));
+      GetDB().GetCachedStatement(SQL_FROM_HERE,
+          "SELECT sum(amount) FROM pending_contribution"));
 
   if (info_sql.Step()) {
     amount = info_sql.ColumnDouble(0);
@@ -954,6 +1140,8 @@ void PublisherInfoDatabase::Vacuum() {
   if (!initialized_)
     return;
 
+  FlushActivityInfo();
+
   DCHECK_EQ(0, db_.transaction_nesting()) <<
       "Can not have a transaction when vacuuming.";
   ignore_result(db_.Execute("VACUUM"));
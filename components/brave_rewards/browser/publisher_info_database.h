@@ -5,8 +5,12 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_PUBLISHER_INFO_DATABASE_H_
 #define BRAVE_COMPONENTS_BRAVE_REWARDS_PUBLISHER_INFO_DATABASE_H_
 
+#include <map>
 #include <memory>
 #include <stddef.h>
+#include <string>
+#include <tuple>
+#include <utility>
 
 #include "base/compiler_specific.h"
 #include "base/files/file_path.h"
@@ -56,6 +60,24 @@ class PublisherInfoDatabase {
 
   bool InsertOrUpdateActivityInfos(const ledger::PublisherInfoList& list);
 
+  // Queues |info| to be written by the next FlushActivityInfo() instead of
+  // writing it now. A row queued again for the same publisher and period
+  // replaces the earlier one, and the queue is flushed once it is full.
+  // Everything else that reads or writes publishers flushes it first.
+  void QueueActivityInfo(const ledger::PublisherInfo& info);
+
+  // Same as QueueActivityInfo(), for a publisher_info row on its own. The
+  // ledger saves one for every new visit that is not counted, so these share
+  // the queue and its transaction.
+  void QueuePublisherInfo(const ledger::PublisherInfo& info);
+
+  // Writes all queued activity and publisher rows in a single transaction.
+  bool FlushActivityInfo();
+
+  // Stores the score, percent and weight of existing activity rows in a
+  // single transaction, leaving every other column alone.
+  bool UpdateActivityInfoWeights(const ledger::PublisherInfoList& list);
+
   bool GetActivityList(int start,
                        int limit,
                        const ledger::ActivityInfoFilter& filter,
@@ -110,6 +132,10 @@ class PublisherInfoDatabase {
   bool CreatePendingContributionsTable();
   bool CreatePendingContributionsIndex();
 
+  bool WritePublisherInfo(const ledger::PublisherInfo& info);
+
+  bool WriteActivityInfo(const ledger::PublisherInfo& info);
+
   void OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
@@ -128,6 +154,16 @@ class PublisherInfoDatabase {
   const base::FilePath db_path_;
   bool initialized_;
 
+  // publisher_id, month, year, reconcile_stamp
+  using ActivityKey = std::tuple<std::string, int, int, uint64_t>;
+  // Each row is kept with the order it was last queued in.
+  std::map<ActivityKey, std::pair<uint64_t, ledger::PublisherInfo>>
+      queued_activity_;
+  // publisher_id -> publisher row queued on its own, ordered as above.
+  std::map<std::string, std::pair<uint64_t, ledger::PublisherInfo>>
+      queued_publishers_;
+  uint64_t next_queued_activity_;
+
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   SEQUENCE_CHECKER(sequence_checker_);
@@ -748,4 +748,226 @@ TEST_F(PublisherInfoDatabaseTest, GetActivityList) {
   EXPECT_EQ(list_4.at(1).id, "publisher_6");
 }
 
+TEST_F(PublisherInfoDatabaseTest, GetActivityListOrderAndPaging) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+
+  ledger::PublisherInfo info;
+  info.excluded = ledger::PUBLISHER_EXCLUDE::DEFAULT;
+  info.month = ledger::ACTIVITY_MONTH::JANUARY;
+  info.year = 1970;
+  info.reconcile_stamp = 1;
+  const int percents[] = {20, 50, 10, 40};
+  for (size_t i = 0; i < arraysize(percents); i++) {
+    info.id = "publisher_" + std::to_string(i + 1);
+    info.percent = percents[i];
+    EXPECT_TRUE(publisher_info_database_->InsertOrUpdateActivityInfo(info));
+  }
+
+  ledger::ActivityInfoFilter filter;
+  filter.excluded = ledger::EXCLUDE_FILTER::FILTER_ALL;
+  filter.order_by.push_back(std::make_pair("ai.percent", false));
+
+  ledger::PublisherInfoList list_1;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 2, filter, &list_1));
+  ASSERT_EQ(list_1.size(), 2u);
+  EXPECT_EQ(list_1.at(0).id, "publisher_2");
+  EXPECT_EQ(list_1.at(1).id, "publisher_4");
+
+  ledger::PublisherInfoList list_2;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(2, 2, filter, &list_2));
+  ASSERT_EQ(list_2.size(), 2u);
+  EXPECT_EQ(list_2.at(0).id, "publisher_1");
+  EXPECT_EQ(list_2.at(1).id, "publisher_3");
+
+  // Columns that can't be ordered by are left out of the query.
+  filter.order_by.clear();
+  filter.order_by.push_back(std::make_pair("1; DROP TABLE activity_info", true));
+  ledger::PublisherInfoList list_3;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 0, filter, &list_3));
+  ASSERT_EQ(list_3.size(), 4u);
+  EXPECT_EQ(list_3.at(0).id, "publisher_1");
+
+  filter.order_by.clear();
+  filter.id = "publisher_3";
+  ledger::PublisherInfoList list_4;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 0, filter, &list_4));
+  ASSERT_EQ(list_4.size(), 1u);
+  EXPECT_EQ(list_4.at(0).percent, 10u);
+}
+
+TEST_F(PublisherInfoDatabaseTest, GetActivityListAfterKey) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+
+  ledger::PublisherInfo info;
+  info.excluded = ledger::PUBLISHER_EXCLUDE::DEFAULT;
+  info.month = ledger::ACTIVITY_MONTH::JANUARY;
+  info.year = 1970;
+  info.reconcile_stamp = 1;
+  for (int i = 1; i <= 4; i++) {
+    info.id = "publisher_" + std::to_string(i);
+    EXPECT_TRUE(publisher_info_database_->InsertOrUpdateActivityInfo(info));
+  }
+
+  ledger::ActivityInfoFilter filter;
+  filter.excluded = ledger::EXCLUDE_FILTER::FILTER_ALL;
+  filter.order_by.push_back(std::make_pair("ai.percent", false));
+
+  ledger::PublisherInfoList list_1;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 2, filter, &list_1));
+  ASSERT_EQ(list_1.size(), 2u);
+  EXPECT_EQ(list_1.at(1).id, "publisher_2");
+
+  // Rewriting a row of the first page gives it a new rowid, it must not show
+  // up again on the next page.
+  info.id = "publisher_1";
+  info.visits = 5;
+  EXPECT_TRUE(publisher_info_database_->InsertOrUpdateActivityInfo(info));
+
+  filter.after_id = list_1.at(1).id;
+  filter.after_month = list_1.at(1).month;
+  filter.after_year = list_1.at(1).year;
+  filter.after_reconcile_stamp = list_1.at(1).reconcile_stamp;
+  ledger::PublisherInfoList list_2;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 2, filter, &list_2));
+  ASSERT_EQ(list_2.size(), 2u);
+  EXPECT_EQ(list_2.at(0).id, "publisher_3");
+  EXPECT_EQ(list_2.at(1).id, "publisher_4");
+}
+
+TEST_F(PublisherInfoDatabaseTest, QueueActivityInfo) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+  EXPECT_TRUE(publisher_info_database_->Init());
+
+  ledger::PublisherInfo info;
+  info.id = "publisher_1";
+  info.url = "https://publisher1.com";
+  info.favicon_url = "https://publisher1.com/favicon.ico";
+  info.excluded = ledger::PUBLISHER_EXCLUDE::DEFAULT;
+  info.month = ledger::ACTIVITY_MONTH::JANUARY;
+  info.year = 1970;
+  info.reconcile_stamp = 1;
+  info.visits = 1;
+  publisher_info_database_->QueueActivityInfo(info);
+
+  // The same row again replaces the queued one but keeps its favicon.
+  info.favicon_url = "";
+  info.visits = 2;
+  publisher_info_database_->QueueActivityInfo(info);
+
+  info.id = "publisher_2";
+  info.url = "https://publisher2.com";
+  publisher_info_database_->QueueActivityInfo(info);
+
+  EXPECT_EQ(CountTableRows("activity_info"), 0);
+  EXPECT_EQ(CountTableRows("publisher_info"), 0);
+
+  // Reads see the queued rows.
+  ledger::PublisherInfoList list;
+  ledger::ActivityInfoFilter filter;
+  filter.excluded = ledger::EXCLUDE_FILTER::FILTER_ALL;
+  EXPECT_TRUE(publisher_info_database_->GetActivityList(0, 0, filter, &list));
+  ASSERT_EQ(list.size(), 2u);
+  EXPECT_EQ(list.at(0).id, "publisher_1");
+  EXPECT_EQ(list.at(0).visits, 2u);
+  EXPECT_EQ(list.at(0).favicon_url, "https://publisher1.com/favicon.ico");
+  EXPECT_EQ(list.at(1).id, "publisher_2");
+
+  // A full queue is written out without waiting for a flush.
+  for (int i = 0; i < 100; i++) {
+    info.id = "queued_" + std::to_string(i);
+    publisher_info_database_->QueueActivityInfo(info);
+  }
+  EXPECT_EQ(CountTableRows("activity_info"), 102);
+
+  // So is whatever is left when the database goes away.
+  info.id = "queued_last";
+  publisher_info_database_->QueueActivityInfo(info);
+  publisher_info_database_.reset();
+
+  publisher_info_database_ = std::make_unique<PublisherInfoDatabase>(db_file);
+  EXPECT_TRUE(publisher_info_database_->Init());
+  EXPECT_EQ(CountTableRows("activity_info"), 103);
+}
+
+TEST_F(PublisherInfoDatabaseTest, QueuePublisherInfo) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+  EXPECT_TRUE(publisher_info_database_->Init());
+
+  ledger::PublisherInfo info;
+  info.id = "publisher_1";
+  info.url = "https://publisher1.com";
+  info.excluded = ledger::PUBLISHER_EXCLUDE::DEFAULT;
+  publisher_info_database_->QueuePublisherInfo(info);
+
+  info.excluded = ledger::PUBLISHER_EXCLUDE::EXCLUDED;
+  publisher_info_database_->QueuePublisherInfo(info);
+  EXPECT_EQ(CountTableRows("publisher_info"), 0);
+
+  // Reads see the last queued row.
+  std::unique_ptr<ledger::PublisherInfo> result =
+      publisher_info_database_->GetPublisherInfo("publisher_1");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result->excluded, ledger::PUBLISHER_EXCLUDE::EXCLUDED);
+  EXPECT_EQ(CountTableRows("publisher_info"), 1);
+}
+
+TEST_F(PublisherInfoDatabaseTest, UpdateActivityInfoWeights) {
+  base::ScopedTempDir temp_dir;
+  base::FilePath db_file;
+  CreateTempDatabase(&temp_dir, &db_file);
+  EXPECT_TRUE(publisher_info_database_->Init());
+
+  ledger::PublisherInfoList list;
+  for (int i = 1; i <= 2; i++) {
+    ledger::PublisherInfo info;
+    info.id = "publisher_" + std::to_string(i);
+    info.name = "name_" + std::to_string(i);
+    info.month = ledger::ACTIVITY_MONTH::JANUARY;
+    info.year = 1970;
+    info.reconcile_stamp = 1;
+    info.duration = 10 * i;
+    info.visits = i;
+    info.score = 1.5;
+    info.percent = 50;
+    info.weight = 50.0;
+    list.push_back(info);
+  }
+  EXPECT_TRUE(publisher_info_database_->InsertOrUpdateActivityInfos(list));
+
+  // Only the key and the normalized columns are sent back.
+  ledger::PublisherInfo changed("publisher_2",
+                                ledger::ACTIVITY_MONTH::JANUARY,
+                                1970);
+  changed.reconcile_stamp = 1;
+  changed.score = 4.5;
+  changed.percent = 75;
+  changed.weight = 74.6;
+  EXPECT_TRUE(publisher_info_database_->UpdateActivityInfoWeights({changed}));
+
+  ledger::PublisherInfoList result;
+  ledger::ActivityInfoFilter filter;
+  filter.excluded = ledger::EXCLUDE_FILTER::FILTER_ALL;
+  EXPECT_TRUE(
+      publisher_info_database_->GetActivityList(0, 0, filter, &result));
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result.at(0).id, "publisher_1");
+  EXPECT_EQ(result.at(0).percent, 50u);
+  EXPECT_EQ(result.at(1).id, "publisher_2");
+  EXPECT_EQ(result.at(1).name, "name_2");
+  EXPECT_EQ(result.at(1).duration, 20u);
+  EXPECT_EQ(result.at(1).visits, 2u);
+  EXPECT_EQ(result.at(1).score, 4.5);
+  EXPECT_EQ(result.at(1).percent, 75u);
+  EXPECT_EQ(result.at(1).weight, 74.6);
+  EXPECT_EQ(CountTableRows("activity_info"), 2);
+}
+
 }  // namespace brave_rewards
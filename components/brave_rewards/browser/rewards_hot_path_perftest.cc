@@ -0,0 +1,63 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <vector>
+
+#include "base/time/time.h"
+#include "brave/components/brave_rewards/browser/rewards_hot_path_test_util.h"
+#include "testing/perf/perf_test.h"
+
+// npm run test -- brave_perftests --filter=RewardsHotPathTest.*
+
+// Times a synthetic trace through the ledger's visit pipeline and prints the
+// numbers in the perf_test format so they can be compared between runs.
+// Allocations per visit are not reported, this binary has no allocator hook
+// to count them.
+
+namespace brave_rewards {
+
+namespace {
+
+const int kTraceVisits = 2000;
+
+double Percentile(std::vector<double> values, size_t percentile) {
+  if (values.empty()) {
+    return 0.0;
+  }
+
+  std::sort(values.begin(), values.end());
+  size_t index = std::min(values.size() - 1,
+                          values.size() * percentile / 100);
+  return values[index];
+}
+
+}  // namespace
+
+TEST_F(RewardsHotPathTest, VisitTrace) {
+  uint64_t json_bytes_before = json_bytes();
+  base::TimeTicks trace_start = base::TimeTicks::Now();
+  std::vector<double> visit_latencies = RunVisits(kTraceVisits);
+  base::TimeDelta trace_time = base::TimeTicks::Now() - trace_start;
+  ExpectActivity(kTraceVisits);
+
+  perf_test::PrintResult("visits", "", "ledger_visit_trace",
+                         kTraceVisits / trace_time.InSecondsF(), "visits/s",
+                         true);
+  perf_test::PrintResult("visit_p50", "", "ledger_visit_trace",
+                         Percentile(visit_latencies, 50), "us", true);
+  perf_test::PrintResult("visit_p99", "", "ledger_visit_trace",
+                         Percentile(visit_latencies, 99), "us", true);
+  for (const auto& stage : stages()) {
+    perf_test::PrintResult(stage.first + "_p50", "", "ledger_visit_trace",
+                           Percentile(stage.second, 50), "us", false);
+    perf_test::PrintResult(stage.first + "_p99", "", "ledger_visit_trace",
+                           Percentile(stage.second, 99), "us", false);
+  }
+  perf_test::PrintResult("json", "", "ledger_visit_trace",
+      static_cast<double>(json_bytes() - json_bytes_before) / kTraceVisits,
+      "bytes/visit", true);
+}
+
+}  // namespace brave_rewards
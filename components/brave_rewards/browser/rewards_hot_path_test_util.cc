@@ -0,0 +1,440 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/rewards_hot_path_test_util.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <sstream>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "base/time/time.h"
+#include "bat/ledger/ledger.h"
+#include "bat/ledger/ledger_client.h"
+#include "brave/components/brave_rewards/browser/publisher_info_database.h"
+
+namespace brave_rewards {
+
+namespace {
+
+const int kPublishers = 500;
+const int kTabs = 10;
+// Every Nth visit is followed by a media request from the same tab.
+const int kMediaVisitInterval = 10;
+
+class NullLogStream : public ledger::LogStream {
+ public:
+  std::ostream& stream() override { return stream_; }
+
+ private:
+  std::ostringstream stream_;
+};
+
+}  // namespace
+
+// Answers ledger requests from |database| on the next RunUntilIdle() and
+// records how long each stage took.
+class HotPathLedgerClient : public ledger::LedgerHostClient {
+ public:
+  explicit HotPathLedgerClient(PublisherInfoDatabase* database)
+      : database_(database),
+        json_bytes_(0),
+        next_timer_id_(1) {
+  }
+
+  ~HotPathLedgerClient() override {
+  }
+
+  void RunUntilIdle() {
+    while (!tasks_.empty()) {
+      std::function<void()> task = std::move(tasks_.front());
+      tasks_.pop_front();
+      task();
+    }
+  }
+
+  void Record(const std::string& stage, base::TimeTicks start) {
+    stages_[stage].push_back(
+        (base::TimeTicks::Now() - start).InMicrosecondsF());
+  }
+
+  const std::map<std::string, std::vector<double>>& stages() const {
+    return stages_;
+  }
+
+  uint64_t json_bytes() const { return json_bytes_; }
+
+  // ledger::LedgerHostClient
+  void OnWalletInitialized(ledger::Result result) override {}
+  void FetchWalletProperties() override {}
+  void OnWalletProperties(ledger::Result result,
+                          std::unique_ptr<ledger::WalletInfo>) override {}
+  void OnReconcileComplete(ledger::Result result,
+                           const std::string& viewing_id,
+                           ledger::REWARDS_CATEGORY category,
+                           const std::string& probi) override {}
+
+  void LoadLedgerState(ledger::LedgerCallbackHandler* handler) override {
+    Post([handler]() {
+      handler->OnLedgerStateLoaded(ledger::Result::NO_LEDGER_STATE, "");
+    });
+  }
+
+  void SaveLedgerState(const std::string& ledger_state,
+                       ledger::LedgerCallbackHandler* handler) override {
+    json_bytes_ += ledger_state.size();
+    Post([handler]() {
+      handler->OnLedgerStateSaved(ledger::Result::LEDGER_OK);
+    });
+  }
+
+  void LoadPublisherState(ledger::LedgerCallbackHandler* handler) override {
+    Post([handler]() {
+      handler->OnPublisherStateLoaded(ledger::Result::NO_PUBLISHER_STATE, "");
+    });
+  }
+
+  void SavePublisherState(const std::string& publisher_state,
+                          ledger::LedgerCallbackHandler* handler) override {
+    json_bytes_ += publisher_state.size();
+    Post([handler]() {
+      handler->OnPublisherStateSaved(ledger::Result::LEDGER_OK);
+    });
+  }
+
+  void SavePublishersList(const std::string& publisher_state,
+                          ledger::LedgerCallbackHandler* handler) override {
+    json_bytes_ += publisher_state.size();
+    Post([handler]() {
+      handler->OnPublishersListSaved(ledger::Result::LEDGER_OK);
+    });
+  }
+
+  void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override {
+    Post([handler]() {
+      handler->OnPublisherListLoaded(ledger::Result::NO_PUBLISHER_LIST, "", 0);
+    });
+  }
+
+  void LoadNicewareList(ledger::GetNicewareListCallback callback) override {
+    Post([callback]() { callback(ledger::Result::LEDGER_ERROR, ""); });
+  }
+
+  void SavePublisherInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
+                         ledger::PublisherInfoCallback callback) override {
+    ledger::PublisherInfo info = *publisher_info;
+    Post([this, info, callback]() {
+      base::TimeTicks start = base::TimeTicks::Now();
+      bool success = database_->InsertOrUpdatePublisherInfo(info);
+      Record("save_publisher_info_db", start);
+
+      start = base::TimeTicks::Now();
+      callback(success ? ledger::Result::LEDGER_OK
+                       : ledger::Result::LEDGER_ERROR,
+               std::make_unique<ledger::PublisherInfo>(info));
+      Record("save_publisher_info_reply", start);
+    });
+  }
+
+  void SaveActivityInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
+                        ledger::PublisherInfoCallback callback) override {
+    ledger::PublisherInfo info = *publisher_info;
+    Post([this, info, callback]() {
+      base::TimeTicks start = base::TimeTicks::Now();
+      database_->QueueActivityInfo(info);
+      Record("save_activity_info_db", start);
+
+      start = base::TimeTicks::Now();
+      callback(ledger::Result::LEDGER_OK,
+               std::make_unique<ledger::PublisherInfo>(info));
+      Record("save_activity_info_reply", start);
+    });
+  }
+
+  void LoadPublisherInfo(const std::string& publisher_key,
+                         ledger::PublisherInfoCallback callback) override {
+    Post([this, publisher_key, callback]() {
+      base::TimeTicks start = base::TimeTicks::Now();
+      std::unique_ptr<ledger::PublisherInfo> info =
+          database_->GetPublisherInfo(publisher_key);
+      Record("load_publisher_info_db", start);
+
+      start = base::TimeTicks::Now();
+      ledger::Result result =
+          info ? ledger::Result::LEDGER_OK : ledger::Result::NOT_FOUND;
+      callback(result, std::move(info));
+      Record("load_publisher_info_reply", start);
+    });
+  }
+
+  void LoadActivityInfo(ledger::ActivityInfoFilter filter,
+                        ledger::PublisherInfoCallback callback) override {
+    Post([this, filter, callback]() {
+      base::TimeTicks start = base::TimeTicks::Now();
+      ledger::PublisherInfoList list;
+      // Same limit as RewardsServiceImpl::LoadActivityInfo.
+      database_->GetActivityList(0, 2, filter, &list);
+      Record("load_activity_info_db", start);
+
+      start = base::TimeTicks::Now();
+      if (list.size() == 0) {
+        callback(ledger::Result::NOT_FOUND,
+                 std::unique_ptr<ledger::PublisherInfo>());
+      } else if (list.size() > 1) {
+        callback(ledger::Result::TOO_MANY_RESULTS,
+                 std::unique_ptr<ledger::PublisherInfo>());
+      } else {
+        callback(ledger::Result::LEDGER_OK,
+                 std::make_unique<ledger::PublisherInfo>(list[0]));
+      }
+      Record("load_activity_info_reply", start);
+    });
+  }
+
+  void LoadPanelPublisherInfo(ledger::ActivityInfoFilter filter,
+                              ledger::PublisherInfoCallback callback) override {
+    Post([this, filter, callback]() {
+      std::unique_ptr<ledger::PublisherInfo> info =
+          database_->GetPanelPublisher(filter);
+      ledger::Result result =
+          info ? ledger::Result::LEDGER_OK : ledger::Result::NOT_FOUND;
+      callback(result, std::move(info));
+    });
+  }
+
+  void LoadMediaPublisherInfo(const std::string& media_key,
+                              ledger::PublisherInfoCallback callback) override {
+    Post([this, media_key, callback]() {
+      base::TimeTicks start = base::TimeTicks::Now();
+      std::unique_ptr<ledger::PublisherInfo> info =
+          database_->GetMediaPublisherInfo(media_key);
+      Record("load_media_publisher_info_db", start);
+
+      start = base::TimeTicks::Now();
+      ledger::Result result =
+          info ? ledger::Result::LEDGER_OK : ledger::Result::NOT_FOUND;
+      callback(result, std::move(info));
+      Record("load_media_publisher_info_reply", start);
+    });
+  }
+
+  void SaveMediaPublisherInfo(const std::string& media_key,
+                              const std::string& publisher_id) override {
+    database_->InsertOrUpdateMediaPublisherInfo(media_key, publisher_id);
+  }
+
+  void GetActivityInfoList(
+      uint32_t start,
+      uint32_t limit,
+      ledger::ActivityInfoFilter filter,
+      ledger::PublisherInfoListCallback callback) override {
+    Post([this, start, limit, filter, callback]() {
+      base::TimeTicks begin = base::TimeTicks::Now();
+      ledger::PublisherInfoList list;
+      database_->GetActivityList(start, limit, filter, &list);
+      Record("get_activity_info_list_db", begin);
+
+      begin = base::TimeTicks::Now();
+      callback(list, list.size() == limit ? start + limit : 0);
+      Record("get_activity_info_list_reply", begin);
+    });
+  }
+
+  void FetchGrant(const std::string& lang,
+                  const std::string& payment_id) override {}
+  void OnGrant(ledger::Result result, const ledger::Grant& grant) override {}
+  void GetGrantCaptcha() override {}
+  void OnGrantCaptcha(const std::string& image,
+                      const std::string& hint) override {}
+  void OnRecoverWallet(ledger::Result result,
+                       double balance,
+                       const std::vector<ledger::Grant>& grants) override {}
+  void OnGrantFinish(ledger::Result result,
+                     const ledger::Grant& grant) override {}
+  void OnPanelPublisherInfo(ledger::Result result,
+                            std::unique_ptr<ledger::PublisherInfo>,
+                            uint64_t windowId) override {}
+  void OnExcludedSitesChanged(const std::string& publisher_id) override {}
+
+  void FetchFavIcon(const std::string& url,
+                    const std::string& favicon_key,
+                    ledger::FetchIconCallback callback) override {
+    Post([callback]() { callback(false, ""); });
+  }
+
+  void SaveContributionInfo(const std::string& probi,
+                            const int month,
+                            const int year,
+                            const uint32_t date,
+                            const std::string& publisher_key,
+                            const ledger::REWARDS_CATEGORY category) override {}
+
+  void GetRecurringDonations(
+      ledger::PublisherInfoListCallback callback) override {
+    Post([this, callback]() {
+      ledger::PublisherInfoList list;
+      database_->GetRecurringDonations(&list);
+      callback(list, 0);
+    });
+  }
+
+  void OnRemoveRecurring(const std::string& publisher_key,
+                         ledger::RecurringRemoveCallback callback) override {
+    Post([callback]() { callback(ledger::Result::LEDGER_OK); });
+  }
+
+  // Timers never fire, the trace does not run long enough to need them.
+  void SetTimer(uint64_t time_offset, uint32_t& timer_id) override {
+    timer_id = next_timer_id_++;
+  }
+
+  // Offline: media lookups that would go to the network fail.
+  void LoadURL(const std::string& url,
+               const std::vector<std::string>& headers,
+               const std::string& content,
+               const std::string& contentType,
+               const ledger::URL_METHOD& method,
+               ledger::LoadURLCallback callback) override {
+    json_bytes_ += content.size();
+    Post([callback]() {
+      callback(false, "", std::map<std::string, std::string>());
+    });
+  }
+
+  void SetContributionAutoInclude(const std::string& publisher_key,
+                                  bool excluded,
+                                  uint64_t windowId) override {}
+
+  void SavePendingContribution(
+      const ledger::PendingContributionList& list) override {}
+
+  std::unique_ptr<ledger::LogStream> Log(
+      const char* file,
+      int line,
+      const ledger::LogLevel log_level) const override {
+    return std::make_unique<NullLogStream>();
+  }
+
+  std::unique_ptr<ledger::LogStream> VerboseLog(
+      const char* file,
+      int line,
+      int vlog_level) const override {
+    return std::make_unique<NullLogStream>();
+  }
+
+  void OnRestorePublishers(ledger::OnRestoreCallback callback) override {
+    Post([callback]() { callback(true); });
+  }
+
+  void SaveNormalizedPublisherList(
+      const ledger::PublisherInfoListStruct& normalized_list) override {
+    ledger::PublisherInfoList list = normalized_list.list;
+    Post([this, list]() {
+      base::TimeTicks start = base::TimeTicks::Now();
+      database_->UpdateActivityInfoWeights(list);
+      Record("save_normalized_publisher_list_db", start);
+    });
+  }
+
+ private:
+  void Post(std::function<void()> task) {
+    tasks_.push_back(std::move(task));
+  }
+
+  PublisherInfoDatabase* database_;  // NOT OWNED
+  std::deque<std::function<void()>> tasks_;
+  std::map<std::string, std::vector<double>> stages_;
+  uint64_t json_bytes_;
+  uint32_t next_timer_id_;
+};
+
+RewardsHotPathTest::RewardsHotPathTest() {
+}
+
+RewardsHotPathTest::~RewardsHotPathTest() {
+}
+
+void RewardsHotPathTest::SetUp() {
+  ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  database_ = std::make_unique<PublisherInfoDatabase>(
+      temp_dir_.GetPath().AppendASCII("RewardsHotPathTest.db"));
+  ASSERT_TRUE(database_->Init());
+
+  client_ = std::make_unique<HotPathLedgerClient>(database_.get());
+  ledger_.reset(ledger::Ledger::CreateInstance(client_.get()));
+  ledger_->SetRewardsMainEnabled(true);
+  ledger_->SetAutoContribute(true);
+  client_->RunUntilIdle();
+}
+
+std::vector<double> RewardsHotPathTest::RunVisits(int visits) {
+  uint64_t now = 1550000000;
+  std::vector<double> latencies;
+  latencies.reserve(visits);
+
+  for (int i = 0; i < visits; i++) {
+    uint32_t tab_id = i % kTabs;
+    std::string domain =
+        "site" + std::to_string((i * 7919) % kPublishers) + ".com";
+    ledger::VisitData visit_data(domain, domain, "/", tab_id,
+        ledger::ACTIVITY_MONTH::JANUARY, 2019, domain,
+        "https://" + domain + "/", "", "");
+
+    base::TimeTicks visit_start = base::TimeTicks::Now();
+    ledger_->OnLoad(visit_data, now);
+    ledger_->OnShow(tab_id, now);
+    now += 10 + i % 50;
+
+    if (i % kMediaVisitInterval == 0) {
+      std::map<std::string, std::string> parts;
+      parts["docid"] = "video" + std::to_string(i % 50);
+      parts["st"] = "0";
+      parts["et"] = "30";
+      ledger::VisitData media_data("", "", "", tab_id,
+          ledger::ACTIVITY_MONTH::JANUARY, 2019, "", "", "", "");
+      ledger_->OnXHRLoad(tab_id,
+          "https://www.youtube.com/api/stats/watchtime?docid=" +
+              parts["docid"] + "&st=0&et=30",
+          parts, "https://www.youtube.com/", "", media_data);
+    }
+
+    ledger_->OnHide(tab_id, now);
+    ledger_->OnUnload(tab_id, now);
+    client_->Record("ledger", visit_start);
+
+    client_->RunUntilIdle();
+    latencies.push_back(
+        (base::TimeTicks::Now() - visit_start).InMicrosecondsF());
+  }
+  return latencies;
+}
+
+void RewardsHotPathTest::ExpectActivity(int visits) {
+  ledger::ActivityInfoFilter filter;
+  filter.excluded = ledger::EXCLUDE_FILTER::FILTER_ALL;
+  ledger::PublisherInfoList list;
+  ASSERT_TRUE(database_->GetActivityList(0, 0, filter, &list));
+  ASSERT_EQ(static_cast<int>(list.size()), std::min(visits, kPublishers));
+  uint32_t total_percent = 0;
+  uint32_t total_visits = 0;
+  for (const auto& info : list) {
+    total_percent += info.percent;
+    total_visits += info.visits;
+  }
+  EXPECT_EQ(total_percent, 100u);
+  EXPECT_EQ(static_cast<int>(total_visits), visits);
+}
+
+const std::map<std::string, std::vector<double>>&
+RewardsHotPathTest::stages() const {
+  return client_->stages();
+}
+
+uint64_t RewardsHotPathTest::json_bytes() const {
+  return client_->json_bytes();
+}
+
+}  // namespace brave_rewards
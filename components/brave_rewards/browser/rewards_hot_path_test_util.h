@@ -0,0 +1,61 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_HOT_PATH_TEST_UTIL_H_
+#define BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_HOT_PATH_TEST_UTIL_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ledger {
+class Ledger;
+}
+
+namespace brave_rewards {
+
+class HotPathLedgerClient;
+class PublisherInfoDatabase;
+
+// Drives the ledger's visit pipeline the way RewardsServiceImpl does: tab
+// events go into the ledger, its database requests are answered from a
+// PublisherInfoDatabase and the replies are delivered asynchronously. The mojo
+// hop is left out, LedgerTypeConvertersTest covers what it costs.
+class RewardsHotPathTest : public ::testing::Test {
+ protected:
+  RewardsHotPathTest();
+  ~RewardsHotPathTest() override;
+
+  void SetUp() override;
+
+  // Runs |visits| visits over several tabs and returns how long each one took
+  // to settle, in microseconds.
+  std::vector<double> RunVisits(int visits);
+
+  // Every publisher was visited and the normalizer caught up with the last
+  // visit.
+  void ExpectActivity(int visits);
+
+  // How long each stage of the pipeline took, in microseconds.
+  const std::map<std::string, std::vector<double>>& stages() const;
+
+  // Bytes of JSON the ledger saved or sent so far.
+  uint64_t json_bytes() const;
+
+ private:
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<PublisherInfoDatabase> database_;
+  std::unique_ptr<HotPathLedgerClient> client_;
+  std::unique_ptr<ledger::Ledger> ledger_;
+};
+
+}  // namespace brave_rewards
+
+#endif  // BRAVE_COMPONENTS_BRAVE_REWARDS_BROWSER_REWARDS_HOT_PATH_TEST_UTIL_H_
@@ -0,0 +1,16 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_rewards/browser/rewards_hot_path_test_util.h"
+
+// npm run test -- brave_unit_tests --filter=RewardsHotPathTest.*
+
+namespace brave_rewards {
+
+TEST_F(RewardsHotPathTest, VisitsAreCounted) {
+  RunVisits(100);
+  ExpectActivity(100);
+}
+
+}  // namespace brave_rewards
@@ -7,7 +7,6 @@
 
 #include <algorithm>
 #include <functional>
-#include <limits>
 #include <utility>
 #include <vector>
 
@@ -16,7 +15,6 @@
 #include "base/containers/flat_map.h"
 #include "base/files/file_util.h"
 #include "base/files/important_file_writer.h"
-#include "base/guid.h"
 #include "base/i18n/time_formatting.h"
 #include "base/logging.h"
 #include "base/sequenced_task_runner.h"
@@ -26,6 +24,7 @@
 #include "base/task/post_task.h"
 #include "base/task_runner_util.h"
 #include "base/threading/sequenced_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #include "bat/ledger/ledger.h"
 #include "bat/ledger/auto_contribute_props.h"
 #include "bat/ledger/media_publisher_info.h"
@@ -47,6 +46,7 @@
 #include "brave/components/brave_rewards/browser/switches.h"
 #include "brave/components/brave_rewards/browser/wallet_properties.h"
 #include "brave/components/services/bat_ledger/public/cpp/ledger_client_mojo_proxy.h"
+#include "brave/components/services/bat_ledger/public/cpp/ledger_type_converters.h"
 #include "chrome/browser/bitmap_fetcher/bitmap_fetcher_service_factory.h"
 #include "chrome/browser/browser_process_impl.h"
 #include "chrome/browser/favicon/favicon_service_factory.h"
@@ -59,7 +59,6 @@
 #include "content/public/common/service_manager_connection.h"
 #include "extensions/buildflags/buildflags.h"
 #include "mojo/public/cpp/bindings/map.h"
-#include "net/base/escape.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "net/base/url_util.h"
 #include "net/url_request/url_fetcher.h"
@@ -219,19 +218,26 @@ LoadMediaPublisherInfoOnFileTaskRunner(
 bool SavePublisherInfoOnFileTaskRunner(
     const ledger::PublisherInfo publisher_info,
     PublisherInfoDatabase* backend) {
-  if (backend && backend->InsertOrUpdatePublisherInfo(publisher_info))
-    return true;
+  if (!backend || publisher_info.id.empty())
+    return false;
 
-  return false;
+  backend->QueuePublisherInfo(publisher_info);
+  return true;
 }
 
 bool SaveActivityInfoOnFileTaskRunner(
     const ledger::PublisherInfo publisher_info,
     PublisherInfoDatabase* backend) {
-  if (backend && backend->InsertOrUpdateActivityInfo(publisher_info))
-    return true;
+  if (!backend || publisher_info.id.empty())
+    return false;
 
-  return false;
+  backend->QueueActivityInfo(publisher_info);
+  return true;
+}
+
+void FlushActivityInfoOnFileTaskRunner(PublisherInfoDatabase* backend) {
+  if (backend)
+    ignore_result(backend->FlushActivityInfo());
 }
 
 ledger::PublisherInfoList GetActivityListOnFileTaskRunner(
@@ -298,6 +304,13 @@ const base::FilePath::StringType kPublisher_info_db("publisher_info_db");
 const base::FilePath::StringType kPublishers_list("publishers_list");
 #endif
 
+// Ledger state saves closer together than this are written once.
+const int kLedgerStateCommitIntervalSeconds = 1;
+
+// Activity saves are written to the database in one transaction this often,
+// or sooner if enough of them queue up.
+const int kActivityInfoFlushIntervalSeconds = 10;
+
 RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
     : profile_(profile),
       bat_ledger_client_binding_(new bat_ledger::LedgerClientMojoProxy(this)),
@@ -312,20 +325,25 @@ RewardsServiceImpl::RewardsServiceImpl(Profile* profile)
       publisher_state_path_(profile_->GetPath().Append(kPublisher_state)),
       publisher_info_db_path_(profile->GetPath().Append(kPublisher_info_db)),
       publisher_list_path_(profile->GetPath().Append(kPublishers_list)),
+      ledger_state_writer_(ledger_state_path_, file_task_runner_,
+          base::TimeDelta::FromSeconds(kLedgerStateCommitIntervalSeconds)),
       publisher_info_backend_(
           new PublisherInfoDatabase(publisher_info_db_path_)),
-      notification_service_(new RewardsNotificationServiceImpl(profile)),
+      notification_service_(new RewardsNotificationServiceImpl(profile))
 #if BUILDFLAG(ENABLE_EXTENSIONS)
-      private_observer_(
-          std::make_unique<ExtensionRewardsServiceObserver>(profile_)),
+      , private_observer_(
+          std::make_unique<ExtensionRewardsServiceObserver>(profile_))
 #endif
-      next_timer_id_(0) {
+      {
   // Set up the rewards data source
   content::URLDataSource::Add(profile_,
                               std::make_unique<BraveRewardsSource>(profile_));
 }
 
 RewardsServiceImpl::~RewardsServiceImpl() {
+  // Saves that arrived after Shutdown().
+  if (ledger_state_writer_.HasPendingWrite())
+    ledger_state_writer_.DoScheduledWrite();
   file_task_runner_->DeleteSoon(FROM_HERE, publisher_info_backend_.release());
   StopNotificationTimers();
 }
@@ -477,6 +495,7 @@ void RewardsServiceImpl::OnGetContentSiteList(
 }
 
 void RewardsServiceImpl::OnLoad(SessionID tab_id, const GURL& url) {
+  TRACE_EVENT0("brave", "RewardsServiceImpl::OnLoad");
   if (!Connected())
     return;
 
@@ -500,10 +519,12 @@ void RewardsServiceImpl::OnLoad(SessionID tab_id, const GURL& url) {
                          publisher_url,
                          "",
                          "");
-  bat_ledger_->OnLoad(data.ToJson(), GetCurrentTimestamp());
+  bat_ledger_->OnLoad(bat_ledger::mojom::VisitData::From(data),
+                      GetCurrentTimestamp());
 }
 
 void RewardsServiceImpl::OnUnload(SessionID tab_id) {
+  TRACE_EVENT0("brave", "RewardsServiceImpl::OnUnload");
   if (!Connected())
     return;
 
@@ -511,6 +532,7 @@ void RewardsServiceImpl::OnUnload(SessionID tab_id) {
 }
 
 void RewardsServiceImpl::OnShow(SessionID tab_id) {
+  TRACE_EVENT0("brave", "RewardsServiceImpl::OnShow");
   if (!Connected())
     return;
 
@@ -518,6 +540,7 @@ void RewardsServiceImpl::OnShow(SessionID tab_id) {
 }
 
 void RewardsServiceImpl::OnHide(SessionID tab_id) {
+  TRACE_EVENT0("brave", "RewardsServiceImpl::OnHide");
   if (!Connected())
     return;
 
@@ -557,6 +580,7 @@ void RewardsServiceImpl::OnPostData(SessionID tab_id,
                                     const GURL& first_party_url,
                                     const GURL& referrer,
                                     const std::string& post_data) {
+  TRACE_EVENT0("brave", "RewardsServiceImpl::OnPostData");
   if (!Connected())
     return;
 
@@ -589,13 +613,14 @@ void RewardsServiceImpl::OnPostData(SessionID tab_id,
                           first_party_url.spec(),
                           referrer.spec(),
                           output,
-                          visit_data.ToJson());
+                          bat_ledger::mojom::VisitData::From(visit_data));
 }
 
 void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
                                    const GURL& url,
                                    const GURL& first_party_url,
                                    const GURL& referrer) {
+  TRACE_EVENT0("brave", "RewardsServiceImpl::OnXHRLoad");
   if (!Connected())
     return;
 
@@ -615,7 +640,7 @@ void RewardsServiceImpl::OnXHRLoad(SessionID tab_id,
                      mojo::MapToFlatMap(parts),
                      first_party_url.spec(),
                      referrer.spec(),
-                     data.ToJson());
+                     bat_ledger::mojom::VisitData::From(data));
 }
 
 void RewardsServiceImpl::LoadPublisherInfo(
@@ -699,14 +724,6 @@ void RewardsServiceImpl::OnMediaPublisherInfoSaved(bool success) {
   }
 }
 
-std::string RewardsServiceImpl::URIEncode(const std::string& value) {
-  return net::EscapeQueryParamValue(value, false);
-}
-
-std::string RewardsServiceImpl::GenerateGUID() const {
-  return base::GenerateGUID();
-}
-
 void RewardsServiceImpl::Shutdown() {
   RemoveObserver(notification_service_.get());
 #if BUILDFLAG(ENABLE_EXTENSIONS)
@@ -726,6 +743,14 @@ void RewardsServiceImpl::Shutdown() {
   }
   fetchers_.clear();
 
+  if (ledger_state_writer_.HasPendingWrite())
+    ledger_state_writer_.DoScheduledWrite();
+
+  if (activity_info_flush_timer_ && activity_info_flush_timer_->IsRunning()) {
+    activity_info_flush_timer_->Stop();
+    FlushActivityInfo();
+  }
+
   bat_ledger_.reset();
   RewardsService::Shutdown();
 }
@@ -839,6 +864,9 @@ void RewardsServiceImpl::OnReconcileComplete(ledger::Result result,
 
 void RewardsServiceImpl::LoadLedgerState(
     ledger::LedgerCallbackHandler* handler) {
+  // The read is queued behind the write on the file task runner.
+  if (ledger_state_writer_.HasPendingWrite())
+    ledger_state_writer_.DoScheduledWrite();
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
       base::Bind(&LoadStateOnFileTaskRunner, ledger_state_path_),
       base::Bind(&RewardsServiceImpl::OnLedgerStateLoaded,
@@ -883,23 +911,35 @@ void RewardsServiceImpl::OnPublisherStateLoaded(
   handler->OnPublisherStateLoaded(
       data.empty() ? ledger::Result::NO_PUBLISHER_STATE
                    : ledger::Result::LEDGER_OK,
-      data);
+      data.data(), data.size());
 }
 
 void RewardsServiceImpl::SaveLedgerState(const std::string& ledger_state,
                                       ledger::LedgerCallbackHandler* handler) {
-  base::ImportantFileWriter writer(
-      ledger_state_path_, file_task_runner_);
+  // Only the latest state is written, a newer one replaces a pending write.
+  // Every save it covers is acknowledged once the write is done.
+  pending_ledger_state_ = ledger_state;
+  if (pending_ledger_state_handlers_.empty()) {
+    ledger_state_writer_.RegisterOnNextWriteCallbacks(
+        base::OnceClosure(),
+        base::BindOnce(&RewardsServiceImpl::OnLedgerStateWritten,
+                       AsWeakPtr()));
+  }
+  pending_ledger_state_handlers_.push_back(handler);
+  ledger_state_writer_.ScheduleWrite(this);
+}
 
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&RewardsServiceImpl::OnLedgerStateSaved, AsWeakPtr(),
-            base::Unretained(handler)),
-        base::SequencedTaskRunnerHandle::Get()));
+void RewardsServiceImpl::OnLedgerStateWritten(bool success) {
+  std::vector<ledger::LedgerCallbackHandler*> handlers;
+  handlers.swap(pending_ledger_state_handlers_);
+  for (auto* handler : handlers)
+    OnLedgerStateSaved(handler, success);
+}
 
-  writer.WriteNow(std::make_unique<std::string>(ledger_state));
+bool RewardsServiceImpl::SerializeData(std::string* data) {
+  data->swap(pending_ledger_state_);
+  pending_ledger_state_.clear();
+  return true;
 }
 
 void RewardsServiceImpl::OnLedgerStateSaved(
@@ -988,6 +1028,21 @@ void RewardsServiceImpl::SaveActivityInfo(
                      AsWeakPtr(),
                      callback,
                      base::Passed(std::move(publisher_info))));
+
+  if (!activity_info_flush_timer_)
+    activity_info_flush_timer_ = std::make_unique<base::OneShotTimer>();
+  if (!activity_info_flush_timer_->IsRunning()) {
+    activity_info_flush_timer_->Start(FROM_HERE,
+        base::TimeDelta::FromSeconds(kActivityInfoFlushIntervalSeconds),
+        base::Bind(&RewardsServiceImpl::FlushActivityInfo,
+                   base::Unretained(this)));
+  }
+}
+
+void RewardsServiceImpl::FlushActivityInfo() {
+  file_task_runner_->PostTask(FROM_HERE,
+      base::BindOnce(&FlushActivityInfoOnFileTaskRunner,
+                     publisher_info_backend_.get()));
 }
 
 void RewardsServiceImpl::OnActivityInfoSaved(
@@ -1526,31 +1581,6 @@ void RewardsServiceImpl::OnPublishersListSaved(
                                          : ledger::Result::LEDGER_ERROR);
 }
 
-void RewardsServiceImpl::SetTimer(uint64_t time_offset,
-                                  uint32_t& timer_id) {
-  if (next_timer_id_ == std::numeric_limits<uint32_t>::max())
-    next_timer_id_ = 1;
-  else
-    ++next_timer_id_;
-
-  timer_id = next_timer_id_;
-
-  timers_[next_timer_id_] = std::make_unique<base::OneShotTimer>();
-  timers_[next_timer_id_]->Start(FROM_HERE,
-      base::TimeDelta::FromSeconds(time_offset),
-      base::BindOnce(
-          &RewardsServiceImpl::OnTimer, AsWeakPtr(), next_timer_id_));
-}
-
-void RewardsServiceImpl::OnTimer(uint32_t timer_id) {
-  if (!Connected()) {
-    return;
-  }
-
-  timers_.erase(timer_id);
-  bat_ledger_->OnTimer(timer_id);
-}
-
 void RewardsServiceImpl::LoadPublisherList(
     ledger::LedgerCallbackHandler* handler) {
   base::PostTaskAndReplyWithResult(file_task_runner_.get(), FROM_HERE,
@@ -1677,7 +1707,7 @@ void RewardsServiceImpl::GetPublisherActivityFromUrl(
   visitData.favicon_url = favicon_url;
 
   bat_ledger_->GetPublisherActivityFromUrl(
-    windowId, visitData.ToJson(), publisher_blob);
+    windowId, bat_ledger::mojom::VisitData::From(visitData), publisher_blob);
 }
 
 void RewardsServiceImpl::OnExcludedSitesChanged(
@@ -1874,7 +1904,8 @@ void RewardsServiceImpl::OnDonate(const std::string& publisher_key, int amount,
     ledger::ACTIVITY_MONTH::ANY,
     -1);
 
-  bat_ledger_->DoDirectDonation(publisher.ToJson(), amount, "BAT");
+  bat_ledger_->DoDirectDonation(
+      bat_ledger::mojom::PublisherInfo::From(publisher), amount, "BAT");
 }
 
 bool SaveContributionInfoOnFileTaskRunner(
@@ -2397,35 +2428,19 @@ void RewardsServiceImpl::OnRestorePublishersInternal(
   callback(result);
 }
 
-std::unique_ptr<ledger::PublisherInfoList>
-SaveNormalizedPublisherListOnFileTaskRunner(PublisherInfoDatabase* backend,
+bool SaveNormalizedPublisherListOnFileTaskRunner(
+    PublisherInfoDatabase* backend,
     const ledger::PublisherInfoList& list) {
   if (!backend) {
-    return nullptr;
-  }
-
-  bool success = backend->InsertOrUpdateActivityInfos(list);
-
-  if (!success) {
-    return nullptr;
-  }
-
-  std::unique_ptr<ledger::PublisherInfoList> new_list(
-      new ledger::PublisherInfoList);
-
-  for (auto& publisher : list) {
-    new_list->push_back(publisher);
+    return false;
   }
 
-  return new_list;
+  return backend->UpdateActivityInfoWeights(list);
 }
 
 void RewardsServiceImpl::SaveNormalizedPublisherList(
       const ledger::PublisherInfoListStruct& list) {
   if (list.list.size() == 0) {
-    std::unique_ptr<ledger::PublisherInfoList> empty_list(
-        new ledger::PublisherInfoList);
-    OnPublisherListNormalizedSaved(std::move(empty_list));
     return;
   }
 
@@ -2439,23 +2454,15 @@ void RewardsServiceImpl::SaveNormalizedPublisherList(
                AsWeakPtr()));
 }
 
-void RewardsServiceImpl::OnPublisherListNormalizedSaved(
-    std::unique_ptr<ledger::PublisherInfoList> list) {
-  if (!list) {
+void RewardsServiceImpl::OnPublisherListNormalizedSaved(bool success) {
+  if (!success) {
     LOG(ERROR) << "Problem saving normalized publishers "
                   "in SaveNormalizedPublisherList";
     return;
   }
 
-  ContentSiteList site_list;
-  for (auto& publisher : *list) {
-    site_list.push_back(PublisherInfoToContentSite(publisher));
-  }
-
-  sort(site_list.begin(), site_list.end());
-
   for (auto& observer : observers_) {
-    observer.OnPublisherListNormalized(this, site_list);
+    observer.OnPublisherListNormalized(this);
   }
 }
 
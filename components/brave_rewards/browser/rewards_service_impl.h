@@ -9,10 +9,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "bat/ledger/ledger.h"
 #include "bat/ledger/wallet_info.h"
 #include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
 #include "base/observer_list.h"
 #include "base/memory/weak_ptr.h"
 #include "bat/ledger/ledger_client.h"
@@ -69,6 +71,7 @@ using GetShortRetriesCallback = base::Callback<void(bool)>;
 class RewardsServiceImpl : public RewardsService,
                             public ledger::LedgerClient,
                             public net::URLFetcherDelegate,
+                            public base::ImportantFileWriter::DataSerializer,
                             public base::SupportsWeakPtr<RewardsServiceImpl> {
  public:
   RewardsServiceImpl(Profile* profile);
@@ -118,7 +121,6 @@ class RewardsServiceImpl : public RewardsService,
                   const GURL& first_party_url,
                   const GURL& referrer,
                   const std::string& post_data) override;
-  std::string URIEncode(const std::string& value) override;
   void GetReconcileStamp(const GetReconcileStampCallback& callback) override;
   void GetAddresses(const GetAddressesCallback& callback) override;
   void GetAutoContribute(
@@ -189,8 +191,11 @@ class RewardsServiceImpl : public RewardsService,
   const extensions::OneShotEvent& ready() const { return ready_; }
   void OnLedgerStateSaved(ledger::LedgerCallbackHandler* handler,
                           bool success);
+  void OnLedgerStateWritten(bool success);
   void OnLedgerStateLoaded(ledger::LedgerCallbackHandler* handler,
                               const std::string& data);
+  // base::ImportantFileWriter::DataSerializer, for the ledger state.
+  bool SerializeData(std::string* data) override;
   void LoadNicewareList(ledger::GetNicewareListCallback callback) override;
   void OnPublisherStateSaved(ledger::LedgerCallbackHandler* handler,
                              bool success);
@@ -209,6 +214,7 @@ class RewardsServiceImpl : public RewardsService,
   void OnPublisherInfoSaved(ledger::PublisherInfoCallback callback,
                             std::unique_ptr<ledger::PublisherInfo> info,
                             bool success);
+  void FlushActivityInfo();
   void OnActivityInfoSaved(ledger::PublisherInfoCallback callback,
                             std::unique_ptr<ledger::PublisherInfo> info,
                             bool success);
@@ -225,7 +231,6 @@ class RewardsServiceImpl : public RewardsService,
                                  const ledger::PublisherInfoList& list);
   void OnPublishersListSaved(ledger::LedgerCallbackHandler* handler,
                              bool success);
-  void OnTimer(uint32_t timer_id);
   void OnPublisherListLoaded(ledger::LedgerCallbackHandler* handler,
                              const std::string& data);
 
@@ -248,7 +253,6 @@ class RewardsServiceImpl : public RewardsService,
   void MaybeShowAddFundsNotification(uint64_t reconcile_stamp);
 
   // ledger::LedgerClient
-  std::string GenerateGUID() const override;
   void OnWalletInitialized(ledger::Result result) override;
   void OnGrant(ledger::Result result, const ledger::Grant& grant) override;
   void OnGrantCaptcha(const std::string& image, const std::string& hint) override;
@@ -283,7 +287,6 @@ class RewardsServiceImpl : public RewardsService,
       ledger::PublisherInfoListCallback callback) override;
   void SavePublishersList(const std::string& publishers_list,
                           ledger::LedgerCallbackHandler* handler) override;
-  void SetTimer(uint64_t time_offset, uint32_t& timer_id) override;
   void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override;
 
   void LoadURL(const std::string& url,
@@ -347,8 +350,7 @@ class RewardsServiceImpl : public RewardsService,
   void SaveNormalizedPublisherList(
       const ledger::PublisherInfoListStruct& list) override;
 
-  void OnPublisherListNormalizedSaved(
-    std::unique_ptr<ledger::PublisherInfoList> list);
+  void OnPublisherListNormalizedSaved(bool success);
 
   // URLFetcherDelegate impl
   void OnURLFetchComplete(const net::URLFetcher* source) override;
@@ -395,7 +397,14 @@ class RewardsServiceImpl : public RewardsService,
   const base::FilePath publisher_state_path_;
   const base::FilePath publisher_info_db_path_;
   const base::FilePath publisher_list_path_;
+  // Coalesces ledger state saves into one write per commit interval.
+  base::ImportantFileWriter ledger_state_writer_;
+  std::string pending_ledger_state_;
+  // Saves waiting for the scheduled write to report its result.
+  std::vector<ledger::LedgerCallbackHandler*> pending_ledger_state_handlers_;
   std::unique_ptr<PublisherInfoDatabase> publisher_info_backend_;
+  // Writes out the activity rows the backend has queued.
+  std::unique_ptr<base::OneShotTimer> activity_info_flush_timer_;
   std::unique_ptr<RewardsNotificationServiceImpl> notification_service_;
   base::ObserverList<RewardsServicePrivateObserver> private_observers_;
 #if BUILDFLAG(ENABLE_EXTENSIONS)
@@ -404,14 +413,11 @@ class RewardsServiceImpl : public RewardsService,
 
   extensions::OneShotEvent ready_;
   std::map<const net::URLFetcher*, ledger::LoadURLCallback> fetchers_;
-  std::map<uint32_t, std::unique_ptr<base::OneShotTimer>> timers_;
   std::vector<std::string> current_media_fetchers_;
   std::vector<BitmapFetcherService::RequestId> request_ids_;
   std::unique_ptr<base::OneShotTimer> notification_startup_timer_;
   std::unique_ptr<base::RepeatingTimer> notification_periodic_timer_;
 
-  uint32_t next_timer_id_;
-
   DISALLOW_COPY_AND_ASSIGN(RewardsServiceImpl);
 };
 
@@ -58,9 +58,10 @@ class RewardsServiceObserver : public base::CheckedObserver {
   virtual void OnPendingContributionSaved(
       brave_rewards::RewardsService* rewards_service,
       int result) {};
+  // The auto-contribute percentages changed, observers that show them should
+  // reload the content site list.
   virtual void OnPublisherListNormalized(
-      RewardsService* rewards_service,
-      brave_rewards::ContentSiteList list) {};
+      RewardsService* rewards_service) {};
   // DO NOT ADD ANY MORE METHODS HERE UNLESS IT IS A BROADCAST NOTIFICATION
   // RewardsServiceObserver should not be used to return responses to the caller.
   // Method calls on RewardsService should use callbacks to return responses.
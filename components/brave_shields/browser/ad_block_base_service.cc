@@ -18,6 +18,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_restrictions.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/shields_decision_cache.h"
 #include "brave/vendor/ad-block/ad_block_client.h"
 
 
@@ -95,56 +96,106 @@ FilterOption ResourceTypeToFilterOption(content::ResourceType resource_type) {
 namespace brave_shields {
 
 AdBlockBaseService::AdBlockBaseService()
-    : BaseBraveShieldsService(),
-      ad_block_client_(new AdBlockClient()),
-      weak_factory_(this) {
+    : BaseBraveShieldsService() {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 AdBlockBaseService::~AdBlockBaseService() {
   Cleanup();
+  std::unique_ptr<DATFileMemoryDumpProvider> memory_dump_provider;
+  {
+    base::AutoLock lock(ad_block_client_lock_);
+    memory_dump_provider = std::move(memory_dump_provider_);
+  }
+  if (memory_dump_provider)
+    DATFileMemoryDumpProvider::Unregister(std::move(memory_dump_provider));
 }
 
 void AdBlockBaseService::Cleanup() {
-  ad_block_client_.reset();
+  {
+    base::AutoLock lock(ad_block_client_lock_);
+    ad_block_client_ = nullptr;
+  }
+  ShieldsDecisionCache::GetInstance()->Invalidate();
+}
+
+scoped_refptr<AdBlockBaseService::AdBlockClientData>
+AdBlockBaseService::GetAdBlockClientData() {
+  base::AutoLock lock(ad_block_client_lock_);
+  return ad_block_client_;
 }
 
 bool AdBlockBaseService::ShouldStartRequest(const GURL& url,
     content::ResourceType resource_type,
     const std::string& tab_host) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return !FindBlockingList({this}, url, resource_type, tab_host);
+}
+
+// static
+AdBlockBaseService* AdBlockBaseService::FindBlockingList(
+    const std::vector<AdBlockBaseService*>& lists,
+    const GURL& url,
+    content::ResourceType resource_type,
+    const std::string& tab_host) {
+  const char* spec = url.spec().c_str();
   FilterOption current_option = ResourceTypeToFilterOption(resource_type);
-  if (ad_block_client_->matches(url.spec().c_str(),
-        current_option,
-        tab_host.c_str())) {
-    // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: " << tab_host
-    //  << ", resource type: " << resource_type
-    //  << ", url.spec(): " << url.spec();
-    return false;
+  for (AdBlockBaseService* list : lists) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(list->sequence_checker_);
+    // Keeps the list alive even if an update swaps it while matching.
+    scoped_refptr<AdBlockClientData> ad_block_client =
+        list->GetAdBlockClientData();
+    if (ad_block_client &&
+        ad_block_client->client()->matches(spec, current_option,
+                                           tab_host.c_str())) {
+      return list;
+    }
   }
-
-  return true;
+  return nullptr;
 }
 
 void AdBlockBaseService::GetDATFileData(const base::FilePath& dat_file_path) {
-  GetTaskRunner()->PostTaskAndReply(
+  GetTaskRunner()->PostTask(
       FROM_HERE,
-      base::Bind(&brave_shields::GetDATFileData, dat_file_path, &buffer_),
-      base::Bind(&AdBlockBaseService::OnDATFileDataReady,
-                 weak_factory_.GetWeakPtr()));
+      base::Bind(&AdBlockBaseService::LoadDATFile,
+                 base::Unretained(this),
+                 dat_file_path));
 }
 
-void AdBlockBaseService::OnDATFileDataReady() {
-  if (buffer_.empty()) {
+void AdBlockBaseService::LoadDATFile(const base::FilePath& dat_file_path) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::unique_ptr<base::MemoryMappedFile> dat_file =
+      MapDATFile(dat_file_path);
+  if (!dat_file) {
     LOG(ERROR) << "Could not obtain ad block data";
     return;
   }
-  ad_block_client_.reset(new AdBlockClient());
-  if (!ad_block_client_->deserialize((char*)&buffer_.front())) {
-    ad_block_client_.reset();
+
+  std::unique_ptr<AdBlockClient> ad_block_client(new AdBlockClient());
+  if (!DeserializeDATFile(*dat_file, ad_block_client.get())) {
     LOG(ERROR) << "Failed to deserialize ad block data";
     return;
   }
+
+  scoped_refptr<AdBlockClientData> ad_block_client_data(
+      new AdBlockClientData(std::move(dat_file), std::move(ad_block_client)));
+  scoped_refptr<AdBlockClientData> old_ad_block_client;
+  {
+    base::AutoLock lock(ad_block_client_lock_);
+    old_ad_block_client.swap(ad_block_client_);
+    ad_block_client_ = ad_block_client_data;
+    if (!memory_dump_provider_) {
+      memory_dump_provider_ =
+          DATFileMemoryDumpProvider::Register("ad_block/" + GetListId());
+    }
+    memory_dump_provider_->set_mapped_size(
+        ad_block_client_data->mapped_size());
+  }
+  ShieldsDecisionCache::GetInstance()->Invalidate();
+
+  // Matching runs on this sequence too, so nothing else holds the old list.
+  // Unmap it now rather than keep the old version's file open.
+  DCHECK(!old_ad_block_client || old_ad_block_client->HasOneRef());
+  old_ad_block_client = nullptr;
 }
 
 bool AdBlockBaseService::Init() {
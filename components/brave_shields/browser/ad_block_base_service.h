@@ -12,7 +12,8 @@
 #include <vector>
 
 #include "base/files/file_path.h"
-#include "base/memory/weak_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
 #include "base/sequence_checker.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
@@ -29,24 +30,46 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   AdBlockBaseService();
   ~AdBlockBaseService() override;
 
+  // Must run on GetTaskRunner(), the vendored client updates its match
+  // statistics and is not safe to use from several threads at once.
   bool ShouldStartRequest(const GURL &url,
     content::ResourceType resource_type,
     const std::string& tab_host) override;
+  // Identifies the list in match results: "default" or a regional UUID.
+  virtual std::string GetListId() const = 0;
+
+  // Matches a request against every list in |lists| and returns the first
+  // one that blocks it, or nullptr. The URL spec and filter option are
+  // computed once and shared by all lists. Must run on GetTaskRunner().
+  static AdBlockBaseService* FindBlockingList(
+      const std::vector<AdBlockBaseService*>& lists,
+      const GURL& url,
+      content::ResourceType resource_type,
+      const std::string& tab_host);
 
  protected:
   bool Init() override;
   void Cleanup() override;
 
+  // Maps the DAT file and swaps in a new client for it on the task runner.
+  // The current client keeps serving requests until the new one is ready.
   void GetDATFileData(const base::FilePath& dat_file_path);
 
-  std::unique_ptr<AdBlockClient> ad_block_client_;
-  DATFileDataBuffer buffer_;
 
  private:
-  void OnDATFileDataReady();
+  using AdBlockClientData = DATFileClient<AdBlockClient>;
+
+  void LoadDATFile(const base::FilePath& dat_file_path);
+  scoped_refptr<AdBlockClientData> GetAdBlockClientData();
+
+  base::Lock ad_block_client_lock_;
+  scoped_refptr<AdBlockClientData> ad_block_client_;
+
+  // Created on the task runner and released by the destructor on another
+  // thread, so it is guarded by |ad_block_client_lock_|.
+  std::unique_ptr<DATFileMemoryDumpProvider> memory_dump_provider_;
 
   SEQUENCE_CHECKER(sequence_checker_);
-  base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(AdBlockBaseService);
 };
 
@@ -70,6 +70,10 @@ bool AdBlockRegionalService::UnregisterComponentByLocale(const std::string& loca
 
 }
 
+std::string AdBlockRegionalService::GetListId() const {
+  return uuid_;
+}
+
 bool AdBlockRegionalService::Init() {
   auto it =
       FindFilterListByLocale(g_brave_browser_process->GetApplicationLocale());
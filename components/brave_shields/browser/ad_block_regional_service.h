@@ -29,6 +29,7 @@ class AdBlockRegionalService : public AdBlockBaseService {
   static bool IsSupportedLocale(const std::string& locale);
   std::string GetUUID() const { return uuid_; }
   std::string GetTitle() const { return title_; }
+  std::string GetListId() const override;
   scoped_refptr<base::SequencedTaskRunner> GetTaskRunner() override;
 
  protected:
@@ -36,6 +36,10 @@ AdBlockService::AdBlockService() {
 AdBlockService::~AdBlockService() {
 }
 
+std::string AdBlockService::GetListId() const {
+  return "default";
+}
+
 bool AdBlockService::Init() {
   Register(kAdBlockComponentName, g_ad_block_component_id_,
            g_ad_block_component_base64_public_key_);
@@ -37,6 +37,8 @@ class AdBlockService : public AdBlockBaseService {
    AdBlockService();
    ~AdBlockService() override;
 
+  std::string GetListId() const override;
+
  protected:
   bool Init() override;
   void OnComponentReady(const std::string& component_id,
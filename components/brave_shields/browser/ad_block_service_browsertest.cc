@@ -9,6 +9,7 @@
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/test/base/ui_test_utils.h"
@@ -51,6 +52,8 @@ class AdBlockServiceTest : public ExtensionBrowserTest {
 
   void SetUpOnMainThread() override {
     ExtensionBrowserTest::SetUpOnMainThread();
+    // The tests check the blocked counters right after the page reports.
+    brave_shields::SetBlockedEventsFlushDelayForTest(base::TimeDelta());
     host_resolver()->AddRule("*", "127.0.0.1");
   }
 
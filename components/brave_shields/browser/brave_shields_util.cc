@@ -4,6 +4,11 @@
 
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "base/no_destructor.h"
 #include "base/task/post_task.h"
 #include "brave/common/shield_exceptions.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
@@ -33,6 +38,29 @@ namespace brave_shields {
 
 namespace {
 
+#define BLOCKED_EVENTS_FLUSH_DELAY_MS 100
+
+// Read on the IO thread, overridden from the UI thread by tests.
+std::atomic<int64_t> g_blocked_events_flush_delay_us(
+    BLOCKED_EVENTS_FLUSH_DELAY_MS * base::Time::kMicrosecondsPerMillisecond);
+
+// Only used on the IO thread.
+std::vector<BlockedEvent>* GetPendingBlockedEvents() {
+  static base::NoDestructor<std::vector<BlockedEvent>> pending_events;
+  return pending_events.get();
+}
+
+void FlushBlockedEventsOnIO() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  std::vector<BlockedEvent> events;
+  events.swap(*GetPendingBlockedEvents());
+  if (events.empty())
+    return;
+  base::PostTaskWithTraits(FROM_HERE, {BrowserThread::UI},
+      base::BindOnce(&BraveShieldsWebContentsObserver::DispatchBlockedEvents,
+          std::move(events)));
+}
+
 bool GetDefaultFromResourceIdentifier(const std::string& resource_identifier,
     const GURL& primary_url, const GURL& secondary_url) {
   if (resource_identifier == brave_shields::kAds) {
@@ -51,6 +79,8 @@ bool GetDefaultFromResourceIdentifier(const std::string& resource_identifier,
   return false;
 }
 
+}  // namespace
+
 bool IsAllowContentSetting(HostContentSettingsMap* content_settings,
                            const GURL& primary_url,
                            const GURL& secondary_url,
@@ -74,8 +104,6 @@ bool IsAllowContentSetting(HostContentSettingsMap* content_settings,
   return setting == CONTENT_SETTING_ALLOW;
 }
 
-}  // namespace
-
 bool IsAllowContentSettingFromIO(const net::URLRequest* request,
     const GURL& primary_url, const GURL& secondary_url,
     ContentSettingsType setting_type,
@@ -124,6 +152,25 @@ bool IsAllowContentSettingWithIOData(ProfileIOData* io_data,
                                resource_identifier);
 }
 
+ShieldsSettings GetShieldsSettingsFromIO(const net::URLRequest* request,
+                                         const GURL& tab_origin) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  const content::ResourceRequestInfo* resource_info =
+      content::ResourceRequestInfo::ForRequest(request);
+  if (!resource_info)
+    return ShieldsSettings();
+  return GetShieldsSettingsWithIOData(
+      ProfileIOData::FromResourceContext(resource_info->GetContext()),
+      tab_origin);
+}
+
+ShieldsSettings GetShieldsSettingsWithIOData(ProfileIOData* io_data,
+                                             const GURL& tab_origin) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  return ShieldsSettingsCache::GetInstance()->Get(
+      io_data ? io_data->GetHostContentSettingsMap() : nullptr, tab_origin);
+}
+
 void GetRenderFrameInfo(const URLRequest* request,
     int* render_frame_id,
     int* render_process_id,
@@ -154,10 +201,26 @@ void DispatchBlockedEventFromIO(const GURL &request_url, int render_frame_id,
     int render_process_id, int frame_tree_node_id,
     const std::string& block_type) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
-  base::PostTaskWithTraits(FROM_HERE, {BrowserThread::UI},
-      base::BindOnce(&BraveShieldsWebContentsObserver::DispatchBlockedEvent,
-          block_type, request_url.spec(),
-          render_process_id, render_frame_id, frame_tree_node_id));
+  std::vector<BlockedEvent>* pending_events = GetPendingBlockedEvents();
+  pending_events->emplace_back(block_type, request_url.spec(),
+      render_process_id, render_frame_id, frame_tree_node_id);
+
+  const base::TimeDelta flush_delay = base::TimeDelta::FromMicroseconds(
+      g_blocked_events_flush_delay_us.load(std::memory_order_relaxed));
+  if (flush_delay.is_zero()) {
+    FlushBlockedEventsOnIO();
+    return;
+  }
+  // The first event of a batch schedules the flush, the others join it.
+  if (pending_events->size() == 1) {
+    base::PostDelayedTaskWithTraits(FROM_HERE, {BrowserThread::IO},
+        base::BindOnce(&FlushBlockedEventsOnIO), flush_delay);
+  }
+}
+
+void SetBlockedEventsFlushDelayForTest(base::TimeDelta delay) {
+  g_blocked_events_flush_delay_us.store(delay.InMicroseconds(),
+                                        std::memory_order_relaxed);
 }
 
 bool ShouldSetReferrer(bool allow_referrers, bool shields_up,
@@ -8,6 +8,8 @@
 #include <stdint.h>
 #include <string>
 
+#include "base/time/time.h"
+#include "brave/components/brave_shields/browser/shields_settings_cache.h"
 #include "components/content_settings/core/common/content_settings_types.h"
 #include "services/network/public/mojom/referrer_policy.mojom.h"
 
@@ -20,11 +22,18 @@ struct Referrer;
 }
 
 class GURL;
+class HostContentSettingsMap;
 class Profile;
 class ProfileIOData;
 
 namespace brave_shields {
 
+bool IsAllowContentSetting(HostContentSettingsMap* content_settings,
+                           const GURL& primary_url,
+                           const GURL& secondary_url,
+                           ContentSettingsType setting_type,
+                           const std::string& resource_identifier);
+
 bool IsAllowContentSettingWithIOData(ProfileIOData* io_data,
     const GURL& primary_url, const GURL& secondary_url,
     ContentSettingsType setting_type,
@@ -41,10 +50,23 @@ bool IsAllowContentSettingFromIO(const net::URLRequest* request,
     ContentSettingsType setting_type,
     const std::string& resource_identifier);
 
+// Returns the shields settings of |tab_origin| in the profile of the request,
+// read once per origin and kept until the shields settings change.
+ShieldsSettings GetShieldsSettingsFromIO(const net::URLRequest* request,
+                                         const GURL& tab_origin);
+
+ShieldsSettings GetShieldsSettingsWithIOData(ProfileIOData* io_data,
+                                             const GURL& tab_origin);
+
+// Queues the event on the IO thread. Queued events are sent to the UI thread
+// together, at most 100 ms after the first one.
 void DispatchBlockedEventFromIO(const GURL &request_url, int render_frame_id,
     int render_process_id, int frame_tree_node_id,
     const std::string& block_type);
 
+// A zero delay sends every event to the UI thread as it is reported.
+void SetBlockedEventsFlushDelayForTest(base::TimeDelta delay);
+
 void GetRenderFrameInfo(const net::URLRequest* request,
     int* render_frame_id,
     int* render_process_id,
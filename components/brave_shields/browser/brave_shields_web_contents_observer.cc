@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/strings/utf_string_conversions.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/common/extensions/api/brave_shields.h"
 #include "brave/common/pref_names.h"
 #include "brave/common/render_messages.h"
@@ -100,6 +101,26 @@ WebContents* GetWebContents(
 
 namespace brave_shields {
 
+BlockedEvent::BlockedEvent()
+    : render_process_id(-1),
+      render_frame_id(-1),
+      frame_tree_node_id(-1) {}
+
+BlockedEvent::BlockedEvent(const std::string& block_type,
+                           const std::string& subresource,
+                           int render_process_id,
+                           int render_frame_id,
+                           int frame_tree_node_id)
+    : block_type(block_type),
+      subresource(subresource),
+      render_process_id(render_process_id),
+      render_frame_id(render_frame_id),
+      frame_tree_node_id(frame_tree_node_id) {}
+
+BlockedEvent::BlockedEvent(BlockedEvent&& other) = default;
+BlockedEvent& BlockedEvent::operator=(BlockedEvent&& other) = default;
+BlockedEvent::~BlockedEvent() = default;
+
 base::Lock BraveShieldsWebContentsObserver::frame_data_map_lock_;
 std::map<BraveShieldsWebContentsObserver::RenderFrameIdKey, GURL>
     BraveShieldsWebContentsObserver::frame_key_to_tab_url_;
@@ -219,45 +240,103 @@ void BraveShieldsWebContentsObserver::AddBlockedSubresource(
 }
 
 // static
-void BraveShieldsWebContentsObserver::DispatchBlockedEvent(
-    std::string block_type,
-    std::string subresource,
-    int render_process_id,
-    int render_frame_id,
-    int frame_tree_node_id) {
+void BraveShieldsWebContentsObserver::DispatchBlockedEvents(
+    std::vector<BlockedEvent> events) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  TRACE_EVENT1("brave_shields",
+               "BraveShieldsWebContentsObserver::DispatchBlockedEvents",
+               "events", events.size());
+
+  // Blocked resources per tab, so that each tab gets a single extension event
+  // for the whole batch.
+  std::map<WebContents*, std::vector<const BlockedEvent*>> tab_events;
+  // New blocks per pref, summed per profile so that each counter is written
+  // once for the whole batch.
+  std::map<PrefService*, std::map<std::string, uint64_t>> new_blocks;
+  for (const BlockedEvent& event : events) {
+    WebContents* web_contents = GetWebContents(event.render_process_id,
+        event.render_frame_id, event.frame_tree_node_id);
+    if (!web_contents)
+      continue;
+    tab_events[web_contents].push_back(&event);
 
-  WebContents* web_contents = GetWebContents(render_process_id,
-    render_frame_id, frame_tree_node_id);
-  DispatchBlockedEventForWebContents(block_type, subresource, web_contents);
-
-  if (web_contents) {
     BraveShieldsWebContentsObserver* observer =
         BraveShieldsWebContentsObserver::FromWebContents(web_contents);
-    if (observer &&
-        !observer->IsBlockedSubresource(subresource)) {
-      observer->AddBlockedSubresource(subresource);
-      PrefService* prefs = Profile::FromBrowserContext(
-          web_contents->GetBrowserContext())->
-          GetOriginalProfile()->
-          GetPrefs();
-
-      if (block_type == kAds) {
-        prefs->SetUint64(kAdsBlocked, prefs->GetUint64(kAdsBlocked) + 1);
-      } else if (block_type == kTrackers) {
-        prefs->SetUint64(kTrackersBlocked,
-            prefs->GetUint64(kTrackersBlocked) + 1);
-      } else if (block_type == kHTTPUpgradableResources) {
-        prefs->SetUint64(kHttpsUpgrades, prefs->GetUint64(kHttpsUpgrades) + 1);
-      } else if (block_type == kJavaScript) {
-        prefs->SetUint64(kJavascriptBlocked,
-            prefs->GetUint64(kJavascriptBlocked) + 1);
-      } else if (block_type == kFingerprinting) {
-        prefs->SetUint64(kFingerprintingBlocked,
-            prefs->GetUint64(kFingerprintingBlocked) + 1);
-      }
+    if (!observer || observer->IsBlockedSubresource(event.subresource))
+      continue;
+    observer->AddBlockedSubresource(event.subresource);
+
+    const char* pref_name = nullptr;
+    if (event.block_type == kAds) {
+      pref_name = kAdsBlocked;
+    } else if (event.block_type == kTrackers) {
+      pref_name = kTrackersBlocked;
+    } else if (event.block_type == kHTTPUpgradableResources) {
+      pref_name = kHttpsUpgrades;
+    } else if (event.block_type == kJavaScript) {
+      pref_name = kJavascriptBlocked;
+    } else if (event.block_type == kFingerprinting) {
+      pref_name = kFingerprintingBlocked;
+    }
+    if (!pref_name)
+      continue;
+
+    PrefService* prefs = Profile::FromBrowserContext(
+        web_contents->GetBrowserContext())->
+        GetOriginalProfile()->
+        GetPrefs();
+    new_blocks[prefs][pref_name]++;
+  }
+
+  for (const auto& profile_blocks : new_blocks) {
+    PrefService* prefs = profile_blocks.first;
+    for (const auto& pref_blocks : profile_blocks.second) {
+      prefs->SetUint64(pref_blocks.first,
+          prefs->GetUint64(pref_blocks.first) + pref_blocks.second);
+    }
+  }
+
+  for (const auto& tab : tab_events)
+    DispatchBlockedEventsForWebContents(tab.second, tab.first);
+}
+
+// static
+void BraveShieldsWebContentsObserver::DispatchBlockedEventsForWebContents(
+    const std::vector<const BlockedEvent*>& events,
+    WebContents* web_contents) {
+  Profile* profile =
+      Profile::FromBrowserContext(web_contents->GetBrowserContext());
+  EventRouter* event_router = EventRouter::Get(profile);
+  if (!profile || !event_router)
+    return;
+
+  if (!event_router->HasEventListener(
+          extensions::api::brave_shields::OnBlockedBatch::kEventName)) {
+    // Listeners which still expect one onBlocked event per resource.
+    for (const BlockedEvent* event : events) {
+      DispatchBlockedEventForWebContents(event->block_type, event->subresource,
+                                         web_contents);
     }
+    return;
+  }
+
+  extensions::api::brave_shields::OnBlockedBatch::Details details;
+  details.tab_id = extensions::ExtensionTabUtil::GetTabId(web_contents);
+  details.blocks.reserve(events.size());
+  for (const BlockedEvent* event : events) {
+    extensions::api::brave_shields::BlockedResource block;
+    block.block_type = event->block_type;
+    block.subresource = event->subresource;
+    details.blocks.push_back(std::move(block));
   }
+  std::unique_ptr<base::ListValue> args(
+      extensions::api::brave_shields::OnBlockedBatch::Create(details)
+        .release());
+  std::unique_ptr<Event> event(
+      new Event(extensions::events::BRAVE_AD_BLOCKED_BATCH,
+        extensions::api::brave_shields::OnBlockedBatch::kEventName,
+        std::move(args)));
+  event_router->BroadcastEvent(std::move(event));
 }
 
 // static
@@ -270,7 +349,9 @@ void BraveShieldsWebContentsObserver::DispatchBlockedEventForWebContents(
   Profile* profile =
       Profile::FromBrowserContext(web_contents->GetBrowserContext());
   EventRouter* event_router = EventRouter::Get(profile);
-  if (profile && event_router) {
+  if (profile && event_router &&
+      event_router->HasEventListener(
+          extensions::api::brave_shields::OnBlocked::kEventName)) {
     extensions::api::brave_shields::OnBlocked::Details details;
     details.tab_id = extensions::ExtensionTabUtil::GetTabId(web_contents);
     details.block_type = block_type;
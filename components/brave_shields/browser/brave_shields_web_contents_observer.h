@@ -25,6 +25,25 @@ class PrefRegistrySimple;
 
 namespace brave_shields {
 
+// A blocked subresource reported from the IO thread.
+struct BlockedEvent {
+  BlockedEvent();
+  BlockedEvent(const std::string& block_type,
+               const std::string& subresource,
+               int render_process_id,
+               int render_frame_id,
+               int frame_tree_node_id);
+  BlockedEvent(BlockedEvent&& other);
+  BlockedEvent& operator=(BlockedEvent&& other);
+  ~BlockedEvent();
+
+  std::string block_type;
+  std::string subresource;
+  int render_process_id;
+  int render_frame_id;
+  int frame_tree_node_id;
+};
+
 class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
     public content::WebContentsUserData<BraveShieldsWebContentsObserver> {
  public:
@@ -36,11 +55,10 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       const std::string& block_type,
       const std::string& subresource,
       content::WebContents* web_contents);
-  static void DispatchBlockedEvent(
-      std::string block_type,
-      std::string subresource,
-      int render_process_id,
-      int render_frame_id, int frame_tree_node_id);
+  // Dispatches a batch of events collected on the IO thread. Counters are
+  // summed per profile and written once per batch, and each tab gets a single
+  // onBlockedBatch extension event.
+  static void DispatchBlockedEvents(std::vector<BlockedEvent> events);
   static GURL GetTabURLFromRenderFrameInfo(int render_process_id,
                                            int render_frame_id,
                                            int render_frame_tree_node_id);
@@ -94,6 +112,9 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
 
  private:
   friend class content::WebContentsUserData<BraveShieldsWebContentsObserver>;
+  static void DispatchBlockedEventsForWebContents(
+      const std::vector<const BlockedEvent*>& events,
+      content::WebContents* web_contents);
   std::vector<std::string> allowed_script_origins_;
   // We keep a set of the current page's blocked URLs in case the page
   // continually tries to load the same blocked URLs.
@@ -4,8 +4,16 @@
 
 #include "brave/components/brave_shields/browser/dat_file_util.h"
 
+#include <utility>
+
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/strings/string_util.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
 
 namespace brave_shields {
 
@@ -28,4 +36,62 @@ void GetDATFileData(const base::FilePath& file_path,
   }
 }
 
+std::unique_ptr<base::MemoryMappedFile> MapDATFile(
+    const base::FilePath& file_path) {
+  base::File file(file_path, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                                 base::File::FLAG_SHARE_DELETE);
+  std::unique_ptr<base::MemoryMappedFile> dat_file(
+      new base::MemoryMappedFile());
+  if (!file.IsValid() ||
+      !dat_file->Initialize(std::move(file)) ||
+      0 == dat_file->length()) {
+    LOG(ERROR) << "MapDATFile: "
+               << "the dat file is not found or corrupted "
+               << file_path;
+    return nullptr;
+  }
+  return dat_file;
+}
+
+DATFileMemoryDumpProvider::DATFileMemoryDumpProvider(const std::string& name)
+    : name_(base::ToLowerASCII(name)),
+      mapped_size_(0) {
+  // Allocator dump names only allow [a-z0-9_/], regional lists use UUIDs.
+  for (char& c : name_) {
+    if (!base::IsAsciiAlpha(c) && !base::IsAsciiDigit(c) && c != '/')
+      c = '_';
+  }
+}
+
+DATFileMemoryDumpProvider::~DATFileMemoryDumpProvider() {
+}
+
+// static
+std::unique_ptr<DATFileMemoryDumpProvider> DATFileMemoryDumpProvider::Register(
+    const std::string& name) {
+  std::unique_ptr<DATFileMemoryDumpProvider> provider(
+      new DATFileMemoryDumpProvider(name));
+  base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+      provider.get(), "BraveShieldsDATFile", nullptr);
+  return provider;
+}
+
+// static
+void DATFileMemoryDumpProvider::Unregister(
+    std::unique_ptr<DATFileMemoryDumpProvider> provider) {
+  base::trace_event::MemoryDumpManager::GetInstance()->
+      UnregisterAndDeleteDumpProviderSoon(std::move(provider));
+}
+
+bool DATFileMemoryDumpProvider::OnMemoryDump(
+    const base::trace_event::MemoryDumpArgs& args,
+    base::trace_event::ProcessMemoryDump* pmd) {
+  base::trace_event::MemoryAllocatorDump* dump =
+      pmd->CreateAllocatorDump("brave_shields/" + name_);
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameSize,
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  mapped_size_);
+  return true;
+}
+
 }  // namespace brave_shields
@@ -5,9 +5,20 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_DAT_FILE_UTIL_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_DAT_FILE_UTIL_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/callback_forward.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/trace_event/memory_dump_provider.h"
 
 namespace base {
 class FilePath;
@@ -20,6 +31,77 @@ using DATFileDataBuffer = std::vector<unsigned char>;
 void GetDATFileData(const base::FilePath& file_path,
                     DATFileDataBuffer* buffer);
 
+// Maps the DAT file read-only. Unlike GetDATFileData the pages are backed by
+// the file, so they are clean and can be evicted by the OS. Returns nullptr if
+// the file is missing, empty or cannot be mapped.
+//
+// The file is opened with delete sharing, so a component update can remove
+// the old version's directory on Windows while it is still mapped.
+std::unique_ptr<base::MemoryMappedFile> MapDATFile(
+    const base::FilePath& file_path);
+
+// Deserializes |client| from the mapped |dat_file|. The vendored
+// deserializers take a char* but only read from it, and |client| keeps
+// pointing into the mapping. Since the mapping is read-only, a write would
+// fault instead of silently changing the data; dat_file_util_unittest.cc
+// deserializes the shipped lists from a mapping to check this.
+template <class T>
+bool DeserializeDATFile(const base::MemoryMappedFile& dat_file, T* client) {
+  return client->deserialize(
+      reinterpret_cast<char*>(const_cast<uint8_t*>(dat_file.data())));
+}
+
+// A deserialized DAT file client together with the mapped file it points
+// into. The mapping is released with the last reference.
+template <class T>
+class DATFileClient : public base::RefCountedThreadSafe<DATFileClient<T>> {
+ public:
+  DATFileClient(std::unique_ptr<base::MemoryMappedFile> dat_file,
+                std::unique_ptr<T> client)
+      : dat_file_(std::move(dat_file)),
+        client_(std::move(client)) {}
+
+  T* client() const { return client_.get(); }
+  size_t mapped_size() const { return dat_file_->length(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<DATFileClient<T>>;
+  // |client_| is declared after |dat_file_|, so it goes away first.
+  ~DATFileClient() {}
+
+  std::unique_ptr<base::MemoryMappedFile> dat_file_;
+  std::unique_ptr<T> client_;
+
+  DISALLOW_COPY_AND_ASSIGN(DATFileClient);
+};
+
+// Reports the size of a loaded DAT file to memory-infra as
+// "brave_shields/<name>". Pass ownership to Unregister() when the owner goes
+// away, since dumps can be requested from any thread.
+class DATFileMemoryDumpProvider
+    : public base::trace_event::MemoryDumpProvider {
+ public:
+  static std::unique_ptr<DATFileMemoryDumpProvider> Register(
+      const std::string& name);
+  static void Unregister(std::unique_ptr<DATFileMemoryDumpProvider> provider);
+
+  ~DATFileMemoryDumpProvider() override;
+
+  void set_mapped_size(size_t size) { mapped_size_ = size; }
+
+  // base::trace_event::MemoryDumpProvider implementation.
+  bool OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                    base::trace_event::ProcessMemoryDump* pmd) override;
+
+ private:
+  explicit DATFileMemoryDumpProvider(const std::string& name);
+
+  std::string name_;
+  std::atomic<size_t> mapped_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(DATFileMemoryDumpProvider);
+};
+
 }  // namespace brave_shields
 
 #endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_DAT_FILE_UTIL_H_
@@ -0,0 +1,77 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/dat_file_util.h"
+
+#include <memory>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/path_service.h"
+#include "brave/common/brave_paths.h"
+#include "brave/vendor/ad-block/ad_block_client.h"
+#include "brave/vendor/tracking-protection/TPParser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=DATFileUtilTest.*
+
+namespace brave_shields {
+
+namespace {
+
+base::FilePath GetTestDataDir() {
+  base::FilePath test_dir;
+  base::PathService::Get(brave::DIR_TEST_DATA, &test_dir);
+  return test_dir;
+}
+
+}  // namespace
+
+TEST(DATFileUtilTest, MapDATFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath dat_file_path = temp_dir.GetPath().AppendASCII("test.dat");
+
+  EXPECT_FALSE(MapDATFile(dat_file_path));
+  ASSERT_EQ(0, base::WriteFile(dat_file_path, "", 0));
+  EXPECT_FALSE(MapDATFile(dat_file_path));
+
+  ASSERT_EQ(4, base::WriteFile(dat_file_path, "data", 4));
+  std::unique_ptr<base::MemoryMappedFile> dat_file =
+      MapDATFile(dat_file_path);
+  ASSERT_TRUE(dat_file);
+  EXPECT_EQ(4u, dat_file->length());
+
+  // Still mapped, the file can be removed like an outdated component
+  EXPECT_TRUE(base::DeleteFile(dat_file_path, false));
+}
+
+// The mapping is read-only, so these crash if a deserializer writes to the
+// data it is given.
+TEST(DATFileUtilTest, DeserializeAdBlockFromMapping) {
+  std::unique_ptr<base::MemoryMappedFile> dat_file = MapDATFile(
+      GetTestDataDir().AppendASCII("adblock-data")
+          .AppendASCII("adblock-default").AppendASCII("4")
+          .AppendASCII("ABPFilterParserData.dat"));
+  ASSERT_TRUE(dat_file);
+
+  AdBlockClient client;
+  EXPECT_TRUE(DeserializeDATFile(*dat_file, &client));
+  client.matches("https://brave.com/ad_banner.png", FOImage, "brave.com");
+}
+
+TEST(DATFileUtilTest, DeserializeTrackingProtectionFromMapping) {
+  std::unique_ptr<base::MemoryMappedFile> dat_file = MapDATFile(
+      GetTestDataDir().AppendASCII("tracking-protection-data")
+          .AppendASCII("1").AppendASCII("TrackingProtection.dat"));
+  ASSERT_TRUE(dat_file);
+
+  CTPParser parser;
+  EXPECT_TRUE(DeserializeDATFile(*dat_file, &parser));
+  parser.matchesTracker("brave.com", "google-analytics.com");
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,184 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_index.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kIndexMagic[8] = {'H', 'T', 'T', 'P', 'S', 'E', 'I', 'X'};
+const uint32_t kIndexVersion = 1;
+
+struct IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t count;
+};
+
+}  // namespace
+
+struct HTTPSERuleIndex::Entry {
+  uint32_t key_offset;
+  uint32_t key_size;
+  uint32_t value_offset;
+  uint32_t value_size;
+};
+
+HTTPSERuleIndex::HTTPSERuleIndex() = default;
+HTTPSERuleIndex::~HTTPSERuleIndex() = default;
+
+// static
+bool HTTPSERuleIndex::Write(const Entries& entries,
+                            const base::FilePath& index_path) {
+  if (entries.size() > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  IndexHeader header;
+  memcpy(header.magic, kIndexMagic, sizeof(kIndexMagic));
+  header.version = kIndexVersion;
+  header.count = static_cast<uint32_t>(entries.size());
+
+  std::vector<Entry> table;
+  table.reserve(entries.size());
+  std::string blob;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (i > 0 && entries[i - 1].first >= entries[i].first) {
+      LOG(ERROR) << "HTTPSE index entries are not sorted";
+      return false;
+    }
+    if (blob.size() + entries[i].first.size() + entries[i].second.size() >
+        std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+    Entry entry;
+    entry.key_offset = static_cast<uint32_t>(blob.size());
+    entry.key_size = static_cast<uint32_t>(entries[i].first.size());
+    blob.append(entries[i].first);
+    entry.value_offset = static_cast<uint32_t>(blob.size());
+    entry.value_size = static_cast<uint32_t>(entries[i].second.size());
+    blob.append(entries[i].second);
+    table.push_back(entry);
+  }
+
+  std::string data;
+  data.reserve(sizeof(header) + table.size() * sizeof(Entry) + blob.size());
+  data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!table.empty()) {
+    data.append(reinterpret_cast<const char*>(table.data()),
+                table.size() * sizeof(Entry));
+  }
+  data.append(blob);
+
+  base::FilePath temp_path = index_path.AddExtension(FILE_PATH_LITERAL("tmp"));
+  if (base::WriteFile(temp_path, data.data(), data.size()) !=
+      static_cast<int>(data.size())) {
+    LOG(ERROR) << "Failed to write HTTPSE index " << temp_path.value();
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+  if (!base::ReplaceFile(temp_path, index_path, nullptr)) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+  return true;
+}
+
+// static
+bool HTTPSERuleIndex::BuildFromLevelDB(const base::FilePath& level_db_path,
+                                       const base::FilePath& index_path) {
+  leveldb::DB* db = nullptr;
+  leveldb::Options options;
+  leveldb::Status status =
+      leveldb::DB::Open(options, level_db_path.AsUTF8Unsafe(), &db);
+  if (!status.ok() || !db) {
+    LOG(ERROR) << "Level db open error " << level_db_path.value()
+               << ", error: " << status.ToString();
+    return false;
+  }
+  std::unique_ptr<leveldb::DB> db_owner(db);
+
+  // leveldb iterates in bytewise key order, which is the index order.
+  Entries entries;
+  std::unique_ptr<leveldb::Iterator> it(
+      db->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next())
+    entries.emplace_back(it->key().ToString(), it->value().ToString());
+  if (!it->status().ok())
+    return false;
+
+  return Write(entries, index_path);
+}
+
+bool HTTPSERuleIndex::Load(const base::FilePath& index_path) {
+  if (!file_.Initialize(index_path))
+    return false;
+
+  if (file_.length() < sizeof(IndexHeader))
+    return false;
+  const IndexHeader* header =
+      reinterpret_cast<const IndexHeader*>(file_.data());
+  if (memcmp(header->magic, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+      header->version != kIndexVersion) {
+    return false;
+  }
+
+  size_t table_size = static_cast<size_t>(header->count) * sizeof(Entry);
+  if (file_.length() - sizeof(IndexHeader) < table_size)
+    return false;
+
+  const uint8_t* table = file_.data() + sizeof(IndexHeader);
+  entries_ = reinterpret_cast<const Entry*>(table);
+  blob_ = reinterpret_cast<const char*>(table + table_size);
+  blob_size_ = file_.length() - sizeof(IndexHeader) - table_size;
+  count_ = header->count;
+  return true;
+}
+
+bool HTTPSERuleIndex::Find(base::StringPiece key,
+                           base::StringPiece* value) const {
+  size_t low = 0;
+  size_t high = count_;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    base::StringPiece middle_key;
+    // A malformed entry fails the lookup instead of reading out of bounds.
+    if (!GetString(entries_[middle].key_offset, entries_[middle].key_size,
+                   &middle_key)) {
+      return false;
+    }
+    int result = middle_key.compare(key);
+    if (result == 0) {
+      return GetString(entries_[middle].value_offset,
+                       entries_[middle].value_size, value);
+    }
+    if (result < 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return false;
+}
+
+bool HTTPSERuleIndex::GetString(uint32_t offset, uint32_t size,
+                                base::StringPiece* result) const {
+  if (offset > blob_size_ || size > blob_size_ - offset)
+    return false;
+  *result = base::StringPiece(blob_ + offset, size);
+  return true;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,72 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace brave_shields {
+
+// Read-only, memory-mapped table of HTTPS Everywhere rule sets keyed by
+// reversed host ("com.example.*"). The file is a header, a table of fixed
+// size entries sorted by key and a blob holding the keys and rule set JSON,
+// so loading it needs no parsing and a lookup is a binary search over the
+// mapped pages.
+class HTTPSERuleIndex {
+ public:
+  using Entries = std::vector<std::pair<std::string, std::string>>;
+
+  HTTPSERuleIndex();
+  ~HTTPSERuleIndex();
+
+  // Writes |entries|, which must be sorted by key and unique, as an index
+  // file at |index_path|. The file is written next to |index_path| first and
+  // then moved into place, so a reader never sees a partial index.
+  static bool Write(const Entries& entries, const base::FilePath& index_path);
+
+  // Converts the leveldb database at |level_db_path| into an index file.
+  static bool BuildFromLevelDB(const base::FilePath& level_db_path,
+                               const base::FilePath& index_path);
+
+  bool Load(const base::FilePath& index_path);
+
+  // Sets |value| to the rule set JSON stored under |key|. |value| points into
+  // the mapped file and stays valid as long as this index.
+  bool Find(base::StringPiece key, base::StringPiece* value) const;
+
+  size_t size() const { return count_; }
+
+ private:
+  struct Entry;
+
+  bool GetString(uint32_t offset, uint32_t size,
+                 base::StringPiece* result) const;
+
+  base::MemoryMappedFile file_;
+  const Entry* entries_ = nullptr;
+  const char* blob_ = nullptr;
+  size_t blob_size_ = 0;
+  size_t count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERuleIndex);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_INDEX_H_
@@ -0,0 +1,68 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_index.h"
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+class HTTPSERuleIndexTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    index_path_ = temp_dir_.GetPath().AppendASCII("httpse.index");
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath index_path_;
+};
+
+TEST_F(HTTPSERuleIndexTest, WriteAndFind) {
+  HTTPSERuleIndex::Entries entries = {
+    {"com.example", "[1]"},
+    {"com.example.*", "[2]"},
+    {"com.example.www", "[3]"},
+    {"org.example.*", ""},
+  };
+  ASSERT_TRUE(HTTPSERuleIndex::Write(entries, index_path_));
+
+  HTTPSERuleIndex index;
+  ASSERT_TRUE(index.Load(index_path_));
+  EXPECT_EQ(4u, index.size());
+
+  for (const auto& entry : entries) {
+    base::StringPiece value;
+    EXPECT_TRUE(index.Find(entry.first, &value)) << entry.first;
+    EXPECT_EQ(entry.second, value);
+  }
+
+  base::StringPiece value;
+  EXPECT_FALSE(index.Find("com", &value));
+  EXPECT_FALSE(index.Find("com.example.w", &value));
+  EXPECT_FALSE(index.Find("net.example.*", &value));
+}
+
+TEST_F(HTTPSERuleIndexTest, RejectsUnsortedEntries) {
+  HTTPSERuleIndex::Entries entries = {
+    {"org.example", "[1]"},
+    {"com.example", "[2]"},
+  };
+  EXPECT_FALSE(HTTPSERuleIndex::Write(entries, index_path_));
+  EXPECT_FALSE(base::PathExists(index_path_));
+}
+
+TEST_F(HTTPSERuleIndexTest, RejectsCorruptedFile) {
+  const char kGarbage[] = "not an index";
+  ASSERT_EQ(static_cast<int>(sizeof(kGarbage)),
+            base::WriteFile(index_path_, kGarbage, sizeof(kGarbage)));
+  HTTPSERuleIndex index;
+  EXPECT_FALSE(index.Load(index_path_));
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,202 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+namespace {
+
+std::unique_ptr<re2::RE2> CompilePattern(const std::string& pattern,
+                                         size_t* memory_usage) {
+  RE2::Options options;
+  options.set_log_errors(false);
+  auto regexp = std::make_unique<re2::RE2>(pattern, options);
+  *memory_usage += sizeof(re2::RE2) + pattern.size();
+  if (regexp->ok())
+    *memory_usage += regexp->ProgramSize() * sizeof(void*);
+  return regexp;
+}
+
+}  // namespace
+
+HTTPSERuleSet::Rule::Rule() = default;
+HTTPSERuleSet::Rule::Rule(Rule&& other) = default;
+HTTPSERuleSet::Rule::~Rule() = default;
+
+HTTPSERuleSet::Target::Target() = default;
+HTTPSERuleSet::Target::Target(Target&& other) = default;
+HTTPSERuleSet::Target::~Target() = default;
+
+HTTPSERuleSet::HTTPSERuleSet() = default;
+HTTPSERuleSet::~HTTPSERuleSet() = default;
+
+// static
+std::unique_ptr<HTTPSERuleSet> HTTPSERuleSet::Parse(base::StringPiece json) {
+  std::unique_ptr<base::Value> json_object = base::JSONReader::Read(json);
+  if (!json_object)
+    return nullptr;
+
+  const base::ListValue* top_values = nullptr;
+  if (!json_object->GetAsList(&top_values))
+    return nullptr;
+
+  std::unique_ptr<HTTPSERuleSet> rule_set(new HTTPSERuleSet());
+  for (size_t i = 0; i < top_values->GetSize(); ++i) {
+    const base::DictionaryValue* target_dictionary = nullptr;
+    if (!top_values->GetDictionary(i, &target_dictionary))
+      continue;
+
+    Target target;
+    const base::ListValue* e_values = nullptr;
+    if (target_dictionary->GetList("e", &e_values)) {
+      for (size_t j = 0; j < e_values->GetSize(); ++j) {
+        const base::DictionaryValue* p_dictionary = nullptr;
+        std::string pattern;
+        if (!e_values->GetDictionary(j, &p_dictionary) ||
+            !p_dictionary->GetString("p", &pattern)) {
+          continue;
+        }
+        target.exclusions.push_back(
+            CompilePattern(CorrectToRuleToRE2Engine(pattern),
+                           &rule_set->memory_usage_));
+      }
+    }
+
+    const base::ListValue* r_values = nullptr;
+    if (target_dictionary->GetList("r", &r_values)) {
+      target.has_rules = true;
+      for (size_t j = 0; j < r_values->GetSize(); ++j) {
+        const base::DictionaryValue* p_dictionary = nullptr;
+        if (!r_values->GetDictionary(j, &p_dictionary))
+          continue;
+
+        Rule rule;
+        if (p_dictionary->HasKey("d")) {
+          rule.is_default = true;
+          target.rules.push_back(std::move(rule));
+          continue;
+        }
+
+        std::string from, to;
+        if (!p_dictionary->GetString("f", &from) ||
+            !p_dictionary->GetString("t", &to)) {
+          continue;
+        }
+        rule.from = CompilePattern(from, &rule_set->memory_usage_);
+        rule.to = CorrectToRuleToRE2Engine(to);
+        rule_set->memory_usage_ += rule.to.size();
+        target.rules.push_back(std::move(rule));
+      }
+    }
+
+    rule_set->memory_usage_ += sizeof(Target) +
+        target.exclusions.size() * sizeof(std::unique_ptr<re2::RE2>) +
+        target.rules.size() * sizeof(Rule);
+    rule_set->targets_.push_back(std::move(target));
+  }
+
+  return rule_set;
+}
+
+std::string HTTPSERuleSet::Apply(const std::string& original_url) const {
+  for (const Target& target : targets_) {
+    for (const auto& exclusion : target.exclusions) {
+      if (RE2::FullMatch(original_url, *exclusion))
+        return "";
+    }
+
+    if (!target.has_rules)
+      return "";
+
+    for (const Rule& rule : target.rules) {
+      if (rule.is_default) {
+        std::string new_url(original_url);
+        return new_url.insert(4, "s");
+      }
+
+      std::string new_url(original_url);
+      if (RE2::Replace(&new_url, *rule.from, rule.to) &&
+          new_url != original_url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+// static
+std::string HTTPSERuleSet::CorrectToRuleToRE2Engine(const std::string& to) {
+  std::string corrected_to(to);
+  size_t pos = corrected_to.find("$");
+  while (std::string::npos != pos) {
+    corrected_to[pos] = '\\';
+    pos = corrected_to.find("$", pos + 1);
+  }
+
+  return corrected_to;
+}
+
+HTTPSERuleSetCache::HTTPSERuleSetCache(size_t max_bytes)
+    : cache_(base::MRUCache<std::string,
+                            std::unique_ptr<HTTPSERuleSet>>::NO_AUTO_EVICT),
+      max_bytes_(max_bytes) {
+}
+
+HTTPSERuleSetCache::~HTTPSERuleSetCache() = default;
+
+bool HTTPSERuleSetCache::Get(const std::string& key,
+                             const HTTPSERuleSet** rule_set) {
+  auto it = cache_.Get(key);
+  if (it == cache_.end())
+    return false;
+  *rule_set = it->second.get();
+  return true;
+}
+
+const HTTPSERuleSet* HTTPSERuleSetCache::Put(
+    const std::string& key,
+    std::unique_ptr<HTTPSERuleSet> rule_set) {
+  auto existing = cache_.Peek(key);
+  if (existing != cache_.end()) {
+    memory_usage_ -= EntryCost(existing->first, existing->second.get());
+    cache_.Erase(existing);
+  }
+
+  memory_usage_ += EntryCost(key, rule_set.get());
+  auto it = cache_.Put(key, std::move(rule_set));
+  const HTTPSERuleSet* result = it->second.get();
+  EvictToBudget();
+  return result;
+}
+
+void HTTPSERuleSetCache::Clear() {
+  cache_.Clear();
+  memory_usage_ = 0;
+}
+
+// static
+size_t HTTPSERuleSetCache::EntryCost(const std::string& key,
+                                     const HTTPSERuleSet* rule_set) {
+  return key.size() + sizeof(HTTPSERuleSet*) +
+      (rule_set ? sizeof(HTTPSERuleSet) + rule_set->EstimateMemoryUsage() : 0);
+}
+
+void HTTPSERuleSetCache::EvictToBudget() {
+  // Never evict the most recently used entry, the caller holds on to it.
+  while (memory_usage_ > max_bytes_ && cache_.size() > 1) {
+    auto oldest = cache_.rbegin();
+    memory_usage_ -= EntryCost(oldest->first, oldest->second.get());
+    cache_.Erase(oldest);
+  }
+}
+
+}  // namespace brave_shields
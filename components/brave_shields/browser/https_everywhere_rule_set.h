@@ -0,0 +1,109 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_SET_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_SET_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace re2 {
+class RE2;
+}
+
+namespace brave_shields {
+
+// A parsed and compiled HTTPS Everywhere rule set, as stored under a single
+// lookup key of the rules database. Parsing the JSON and building the RE2
+// programs happens once in Parse(), so Apply() only runs the regexps.
+class HTTPSERuleSet {
+ public:
+  ~HTTPSERuleSet();
+
+  // Returns nullptr if |json| is not a list of rule sets.
+  static std::unique_ptr<HTTPSERuleSet> Parse(base::StringPiece json);
+
+  // Returns the upgraded URL, or an empty string if no rule applies or the
+  // URL matches an exclusion.
+  std::string Apply(const std::string& original_url) const;
+
+  // Approximate heap footprint, used to bound the compiled rules cache.
+  size_t EstimateMemoryUsage() const { return memory_usage_; }
+
+  // The rule engine uses \1 for back references, HTTPS Everywhere uses $1.
+  static std::string CorrectToRuleToRE2Engine(const std::string& to);
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(Rule&& other);
+    ~Rule();
+
+    // "d" rules only insert the 's' into the scheme.
+    bool is_default = false;
+    std::unique_ptr<re2::RE2> from;
+    std::string to;
+  };
+
+  struct Target {
+    Target();
+    Target(Target&& other);
+    ~Target();
+
+    std::vector<std::unique_ptr<re2::RE2>> exclusions;
+    std::vector<Rule> rules;
+    // A target without a valid "r" list stops the evaluation.
+    bool has_rules = false;
+  };
+
+  HTTPSERuleSet();
+
+  std::vector<Target> targets_;
+  size_t memory_usage_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERuleSet);
+};
+
+// LRU cache of compiled rule sets keyed by the rules database key. A null
+// entry records that the key has no rule set, so negative lookups are not
+// repeated against the database either. Not thread safe; it is only used on
+// the HTTPS Everywhere service sequence.
+class HTTPSERuleSetCache {
+ public:
+  explicit HTTPSERuleSetCache(size_t max_bytes);
+  ~HTTPSERuleSetCache();
+
+  // Returns true if |key| is cached. |*rule_set| is set to the cached value,
+  // which may be nullptr for a key without rules.
+  bool Get(const std::string& key, const HTTPSERuleSet** rule_set);
+  const HTTPSERuleSet* Put(const std::string& key,
+                           std::unique_ptr<HTTPSERuleSet> rule_set);
+  void Clear();
+
+  size_t size() const { return cache_.size(); }
+  size_t memory_usage() const { return memory_usage_; }
+
+ private:
+  static size_t EntryCost(const std::string& key,
+                          const HTTPSERuleSet* rule_set);
+  void EvictToBudget();
+
+  base::MRUCache<std::string, std::unique_ptr<HTTPSERuleSet>> cache_;
+  const size_t max_bytes_;
+  size_t memory_usage_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERuleSetCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_SET_H_
@@ -0,0 +1,91 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+
+#include <memory>
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kRuleSet[] =
+    "[{\"e\":[{\"p\":\"^http://www\\\\.example\\\\.com/nossl/\"}],"
+    "\"r\":[{\"f\":\"^http://(www\\\\.)?example\\\\.com/\","
+    "\"t\":\"https://$1example.com/\"}]}]";
+
+const char kDefaultRuleSet[] = "[{\"r\":[{\"d\":1}]}]";
+
+}  // namespace
+
+TEST(HTTPSERuleSetTest, ParseInvalid) {
+  EXPECT_EQ(nullptr, HTTPSERuleSet::Parse(""));
+  EXPECT_EQ(nullptr, HTTPSERuleSet::Parse("{}"));
+  EXPECT_NE(nullptr, HTTPSERuleSet::Parse("[]"));
+}
+
+TEST(HTTPSERuleSetTest, ApplyRules) {
+  std::unique_ptr<HTTPSERuleSet> rule_set = HTTPSERuleSet::Parse(kRuleSet);
+  ASSERT_NE(nullptr, rule_set);
+  EXPECT_EQ("https://www.example.com/a.js",
+            rule_set->Apply("http://www.example.com/a.js"));
+  EXPECT_EQ("https://example.com/a.js",
+            rule_set->Apply("http://example.com/a.js"));
+  EXPECT_EQ("", rule_set->Apply("http://www.example.com/nossl/a.js"));
+  EXPECT_EQ("", rule_set->Apply("http://www.example.org/a.js"));
+
+  // Compiled rules give the same answer when applied repeatedly.
+  EXPECT_EQ("https://www.example.com/a.js",
+            rule_set->Apply("http://www.example.com/a.js"));
+}
+
+TEST(HTTPSERuleSetTest, ApplyDefaultRule) {
+  std::unique_ptr<HTTPSERuleSet> rule_set =
+      HTTPSERuleSet::Parse(kDefaultRuleSet);
+  ASSERT_NE(nullptr, rule_set);
+  EXPECT_EQ("https://example.net/", rule_set->Apply("http://example.net/"));
+}
+
+TEST(HTTPSERuleSetTest, CorrectToRule) {
+  EXPECT_EQ("https://\\1example.com/\\2",
+            HTTPSERuleSet::CorrectToRuleToRE2Engine(
+                "https://$1example.com/$2"));
+}
+
+TEST(HTTPSERuleSetCacheTest, CachesNegativeLookups) {
+  HTTPSERuleSetCache cache(1024 * 1024);
+  const HTTPSERuleSet* rule_set = nullptr;
+  EXPECT_FALSE(cache.Get("com.example", &rule_set));
+  EXPECT_EQ(nullptr, cache.Put("com.example", nullptr));
+  EXPECT_TRUE(cache.Get("com.example", &rule_set));
+  EXPECT_EQ(nullptr, rule_set);
+}
+
+TEST(HTTPSERuleSetCacheTest, EvictsLeastRecentlyUsed) {
+  std::unique_ptr<HTTPSERuleSet> first = HTTPSERuleSet::Parse(kRuleSet);
+  size_t budget = first->EstimateMemoryUsage() * 2 + 256;
+  HTTPSERuleSetCache cache(budget);
+
+  cache.Put("com.example", std::move(first));
+  cache.Put("org.example", HTTPSERuleSet::Parse(kRuleSet));
+  const HTTPSERuleSet* rule_set = nullptr;
+  // Touch the first entry so the second one is evicted next.
+  EXPECT_TRUE(cache.Get("com.example", &rule_set));
+  cache.Put("net.example", HTTPSERuleSet::Parse(kRuleSet));
+
+  EXPECT_LE(cache.memory_usage(), budget);
+  EXPECT_TRUE(cache.Get("net.example", &rule_set));
+  EXPECT_TRUE(cache.Get("com.example", &rule_set));
+  EXPECT_FALSE(cache.Get("org.example", &rule_set));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.memory_usage());
+}
+
+}  // namespace brave_shields
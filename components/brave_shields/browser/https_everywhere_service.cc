@@ -6,28 +6,32 @@
 #include "brave/components/brave_shields/browser/https_everywhere_service.h"
 
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/base_paths.h"
-#include "base/json/json_reader.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_index.h"
 #include "chrome/browser/browser_process.h"
-#include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
 #define DAT_FILE_VERSION "6.0"
+#define INDEX_FILE "httpse.index"
 #define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
+#define HTTPSE_RULE_SET_CACHE_MAX_BYTES     (4 * 1024 * 1024)
+#define HTTPSE_RECENTLY_USED_CACHE_MAX_BYTES (1024 * 1024)
+#define HTTPSE_RECENTLY_USED_CACHE_SHARDS   16
 
 namespace {
 
@@ -66,15 +70,6 @@ std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
   }
   return resultDomains;
 }
-std::string leveldbGet(leveldb::DB* db, const std::string &key) {
-  if (!db) {
-    return "";
-  }
-
-  std::string value;
-  leveldb::Status s = db->Get(leveldb::ReadOptions(), key, &value);
-  return s.ok() ? value : "";
-}
 
 }  // namespace
 
@@ -87,18 +82,23 @@ std::string
 HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
     kHTTPSEverywhereComponentBase64PublicKey);
 
-HTTPSEverywhereService::HTTPSEverywhereService() : level_db_(nullptr) {
+HTTPSEverywhereService::HTTPSEverywhereService()
+    : recently_used_cache_(HTTPSE_RECENTLY_USED_CACHE_MAX_BYTES,
+                           HTTPSE_RECENTLY_USED_CACHE_SHARDS),
+      rule_set_cache_(HTTPSE_RULE_SET_CACHE_MAX_BYTES) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 HTTPSEverywhereService::~HTTPSEverywhereService() {
-  Cleanup();
+  // The owner deletes the service on its task runner, after the tasks that
+  // were posted with an unretained pointer to it.
+  StopOnTaskRunner();
 }
 
 void HTTPSEverywhereService::Cleanup() {
   GetTaskRunner()->PostTask(
       FROM_HERE,
-      base::Bind(&HTTPSEverywhereService::CloseDatabase,
+      base::Bind(&HTTPSEverywhereService::StopOnTaskRunner,
                  base::Unretained(this)));
 }
 
@@ -112,29 +112,58 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   base::FilePath zip_db_file_path =
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
-  base::FilePath unzipped_level_db_path = zip_db_file_path.RemoveExtension();
-  base::FilePath destination = zip_db_file_path.DirName();
-  if (!zip::Unzip(zip_db_file_path, destination)) {
-    LOG(ERROR) << "Failed to unzip database file "
-               << zip_db_file_path.value().c_str();
+  base::FilePath index_path =
+      zip_db_file_path.DirName().AppendASCII(INDEX_FILE);
+
+  // The index is built once per component version, later starts only map it.
+  if (!base::PathExists(index_path) && !BuildIndex(zip_db_file_path,
+                                                   index_path)) {
     return;
   }
 
   CloseDatabase();
 
-  leveldb::Options options;
-  leveldb::Status status =
-      leveldb::DB::Open(options,
-                        unzipped_level_db_path.AsUTF8Unsafe(),
-                        &level_db_);
-  if (!status.ok() || !level_db_) {
-    level_db_ = nullptr;
-    LOG(ERROR) << "Level db open error "
-               << unzipped_level_db_path.value().c_str()
-               << ", error: " << status.ToString();
-    CloseDatabase();
+  std::unique_ptr<HTTPSERuleIndex> rule_index(new HTTPSERuleIndex());
+  if (!rule_index->Load(index_path)) {
+    LOG(ERROR) << "Failed to load HTTPSE index "
+               << index_path.value().c_str();
+    // Drop a stale or corrupted index so that the next update rebuilds it.
+    base::DeleteFile(index_path, false);
     return;
   }
+  rule_index_ = std::move(rule_index);
+
+  if (!memory_pressure_listener_) {
+    memory_pressure_listener_.reset(new base::MemoryPressureListener(
+        base::Bind(&HTTPSEverywhereService::OnMemoryPressure,
+                   base::Unretained(this))));
+  }
+}
+
+// static
+bool HTTPSEverywhereService::BuildIndex(const base::FilePath& zip_db_file_path,
+                                        const base::FilePath& index_path) {
+  base::ScopedTempDir temp_dir;
+  if (!temp_dir.CreateUniqueTempDirUnderPath(zip_db_file_path.DirName())) {
+    LOG(ERROR) << "Failed to create a temporary directory for "
+               << zip_db_file_path.value().c_str();
+    return false;
+  }
+  if (!zip::Unzip(zip_db_file_path, temp_dir.GetPath())) {
+    LOG(ERROR) << "Failed to unzip database file "
+               << zip_db_file_path.value().c_str();
+    return false;
+  }
+
+  base::FilePath unzipped_level_db_path =
+      temp_dir.GetPath().Append(zip_db_file_path.BaseName().RemoveExtension());
+  if (!HTTPSERuleIndex::BuildFromLevelDB(unzipped_level_db_path,
+                                         index_path)) {
+    LOG(ERROR) << "Failed to build HTTPSE index from "
+               << unzipped_level_db_path.value().c_str();
+    return false;
+  }
+  return true;
 }
 
 void HTTPSEverywhereService::OnComponentReady(
@@ -150,20 +179,20 @@ void HTTPSEverywhereService::OnComponentReady(
 
 bool HTTPSEverywhereService::GetHTTPSURL(
     const GURL* url, const uint64_t& request_identifier,
-    std::string& new_url) {
+    HTTPSECacheScope cache_scope, std::string& new_url) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   if (!url->is_valid())
     return false;
 
-  if (!IsInitialized() || !level_db_ || url->scheme() == url::kHttpsScheme) {
+  if (!IsInitialized() || !rule_index_ || url->scheme() == url::kHttpsScheme) {
     return false;
   }
   if (!ShouldHTTPSERedirect(request_identifier)) {
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), &new_url)) {
+  if (recently_used_cache_.Get({cache_scope, url->spec()}, &new_url)) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
@@ -177,24 +206,25 @@ bool HTTPSEverywhereService::GetHTTPSURL(
 
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      new_url = ApplyHTTPSRule(candidate_url.spec(), value);
+  for (const auto& domain : domains) {
+    const HTTPSERuleSet* rule_set = GetRuleSet(domain);
+    if (rule_set) {
+      new_url = rule_set->Apply(candidate_url.spec());
       if (0 != new_url.length()) {
-        recently_used_cache_.add(candidate_url.spec(), new_url);
+        recently_used_cache_.Put({cache_scope, candidate_url.spec()}, new_url);
         AddHTTPSEUrlToRedirectList(request_identifier);
         return true;
       }
     }
   }
-  recently_used_cache_.remove(candidate_url.spec());
+  recently_used_cache_.Remove({cache_scope, candidate_url.spec()});
   return false;
 }
 
 bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     const GURL* url,
     const uint64_t& request_identifier,
+    HTTPSECacheScope cache_scope,
     std::string& cached_url) {
   if (!url->is_valid())
     return false;
@@ -206,13 +236,65 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), &cached_url)) {
+  if (recently_used_cache_.Get({cache_scope, url->spec()}, &cached_url)) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
   return false;
 }
 
+ShardedLRUCacheStats HTTPSEverywhereService::GetRecentlyUsedCacheStats() {
+  return recently_used_cache_.GetStats();
+}
+
+void HTTPSEverywhereService::ClearCacheScope(HTTPSECacheScope cache_scope) {
+  // Entries are added on the task runner, so this runs after the lookups
+  // already queued for the profile.
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::Bind(&HTTPSEverywhereService::ClearCacheScopeOnTaskRunner,
+                 base::Unretained(this),
+                 cache_scope));
+}
+
+void HTTPSEverywhereService::ClearCacheScopeOnTaskRunner(
+    HTTPSECacheScope cache_scope) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  recently_used_cache_.RemoveIf(
+      [cache_scope](const RecentlyUsedCacheKey& key, const std::string&) {
+        return key.first == cache_scope;
+      });
+}
+
+// static
+size_t HTTPSEverywhereService::RecentlyUsedCacheTraits::ShardHash(
+    const RecentlyUsedCacheKey& key) {
+  return std::hash<std::string>()(key.second);
+}
+
+// static
+size_t HTTPSEverywhereService::RecentlyUsedCacheTraits::EntryCost(
+    const RecentlyUsedCacheKey& key,
+    const std::string& new_url) {
+  return key.second.size() + new_url.size();
+}
+
+void HTTPSEverywhereService::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      recently_used_cache_.Trim(0.5);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      recently_used_cache_.Clear();
+      rule_set_cache_.Clear();
+      break;
+  }
+}
+
 bool HTTPSEverywhereService::ShouldHTTPSERedirect(
     const uint64_t& request_identifier) {
   std::lock_guard<std::mutex> guard(httpse_get_urls_redirects_count_mutex_);
@@ -255,130 +337,31 @@ void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
   }
 }
 
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  std::unique_ptr<base::Value> json_object = base::JSONReader::Read(rule);
-  if (nullptr == json_object.get()) {
-    return "";
-  }
-
-  const base::ListValue* topValues = nullptr;
-  json_object->GetAsList(&topValues);
-  if (nullptr == topValues) {
-    return "";
-  }
-
-  for (size_t i = 0; i < topValues->GetSize(); ++i) {
-    const base::Value* childTopValue = nullptr;
-    if (!topValues->Get(i, &childTopValue)) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    childTopValue->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetSize(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetSize(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
-
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
-
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
-  }
-  return "";
+const HTTPSERuleSet* HTTPSEverywhereService::GetRuleSet(
+    const std::string& key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const HTTPSERuleSet* rule_set = nullptr;
+  if (rule_set_cache_.Get(key, &rule_set))
+    return rule_set;
+
+  std::unique_ptr<HTTPSERuleSet> compiled;
+  base::StringPiece value;
+  if (rule_index_ && rule_index_->Find(key, &value) && !value.empty())
+    compiled = HTTPSERuleSet::Parse(value);
+  return rule_set_cache_.Put(key, std::move(compiled));
 }
 
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
-  }
-
-  return correctedto;
+void HTTPSEverywhereService::CloseDatabase() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  rule_set_cache_.Clear();
+  rule_index_.reset();
 }
 
-void HTTPSEverywhereService::CloseDatabase() {
+void HTTPSEverywhereService::StopOnTaskRunner() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  if (level_db_) {
-    delete level_db_;
-    level_db_ = nullptr;
-  }
+  // The listener calls back on this sequence with an unretained pointer.
+  memory_pressure_listener_.reset();
+  CloseDatabase();
 }
 
 // static
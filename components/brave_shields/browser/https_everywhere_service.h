@@ -9,19 +9,18 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <mutex>
 
 #include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/sequence_checker.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
-#include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+#include "brave/components/brave_shields/browser/sharded_lru_cache.h"
 #include "content/public/common/resource_type.h"
 
-namespace leveldb {
-class DB;
-}
-
 class HTTPSEverywhereServiceTest;
 
 namespace brave_shields {
@@ -50,14 +49,27 @@ public:
     unsigned int redirects_;
 };
 
+class HTTPSERuleIndex;
+
+// Identifies the profile an entry of the recently used cache belongs to.
+// Every profile, including each off-the-record profile, uses its own scope
+// so that a cache hit can never reveal what was loaded in another profile.
+using HTTPSECacheScope = const void*;
+
 class HTTPSEverywhereService : public BaseBraveShieldsService {
  public:
    HTTPSEverywhereService();
    ~HTTPSEverywhereService() override;
   bool GetHTTPSURL(const GURL* url, const uint64_t& request_id,
-      std::string& new_url);
+      HTTPSECacheScope cache_scope, std::string& new_url);
   bool GetHTTPSURLFromCacheOnly(const GURL* url,
-      const uint64_t& request_id, std::string& cached_url);
+      const uint64_t& request_id, HTTPSECacheScope cache_scope,
+      std::string& cached_url);
+  ShardedLRUCacheStats GetRecentlyUsedCacheStats();
+  // Drops the recently used entries of a profile which is going away, so
+  // that a new off-the-record profile reusing the address of its context
+  // starts with an empty cache.
+  void ClearCacheScope(HTTPSECacheScope cache_scope);
 
  protected:
   bool Init() override;
@@ -68,9 +80,9 @@ class HTTPSEverywhereService : public BaseBraveShieldsService {
 
   void AddHTTPSEUrlToRedirectList(const uint64_t& request_id);
   bool ShouldHTTPSERedirect(const uint64_t& request_id);
-  std::string ApplyHTTPSRule(const std::string& originalUrl,
-      const std::string& rule);
-  std::string CorrecttoRuleToRE2Engine(const std::string& to);
+  // Returns the compiled rule set stored under |key|, loading and compiling
+  // it on a cache miss. Returns nullptr if there are no rules for |key|.
+  const HTTPSERuleSet* GetRuleSet(const std::string& key);
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
@@ -83,13 +95,30 @@ class HTTPSEverywhereService : public BaseBraveShieldsService {
       const std::string& component_base64_public_key);
 
   void CloseDatabase();
+  void ClearCacheScopeOnTaskRunner(HTTPSECacheScope cache_scope);
+  void StopOnTaskRunner();
 
   void InitDB(const base::FilePath& install_dir);
+  static bool BuildIndex(const base::FilePath& zip_db_file_path,
+                         const base::FilePath& index_path);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
   std::mutex httpse_get_urls_redirects_count_mutex_;
   std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
-  HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
-  leveldb::DB* level_db_;
+  // (scope, URL) -> upgraded URL.
+  using RecentlyUsedCacheKey = std::pair<HTTPSECacheScope, std::string>;
+  struct RecentlyUsedCacheTraits {
+    static size_t ShardHash(const RecentlyUsedCacheKey& key);
+    static size_t EntryCost(const RecentlyUsedCacheKey& key,
+                            const std::string& new_url);
+  };
+
+  ShardedLRUCache<RecentlyUsedCacheKey, std::string, RecentlyUsedCacheTraits>
+      recently_used_cache_;
+  HTTPSERuleSetCache rule_set_cache_;
+  std::unique_ptr<HTTPSERuleIndex> rule_index_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 
   SEQUENCE_CHECKER(sequence_checker_);
   DISALLOW_COPY_AND_ASSIGN(HTTPSEverywhereService);
@@ -0,0 +1,177 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHARDED_LRU_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHARDED_LRU_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+
+namespace brave_shields {
+
+struct ShardedLRUCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t entries = 0;
+  size_t memory_usage = 0;
+};
+
+// LRU cache split into lock-striped shards, so that lookups for different
+// keys rarely contend on the same lock. Safe to use on any thread.
+//
+// The keys are usually full URLs, so every shard is bounded by the bytes its
+// entries hold rather than by their number. |Traits| provides:
+//   // Picks the shard of |key|; may only look at part of it.
+//   static size_t ShardHash(const Key& key);
+//   // Heap bytes held by an entry, on top of sizeof(Key) + sizeof(Value).
+//   static size_t EntryCost(const Key& key, const Value& value);
+template <class Key, class Value, class Traits>
+class ShardedLRUCache {
+ public:
+  ShardedLRUCache(size_t max_bytes, size_t shard_count) {
+    DCHECK_GT(shard_count, 0u);
+    size_t bytes_per_shard = std::max<size_t>(1, max_bytes / shard_count);
+    for (size_t i = 0; i < shard_count; ++i)
+      shards_.push_back(std::make_unique<Shard>(bytes_per_shard));
+  }
+
+  bool Get(const Key& key, Value* value) {
+    Shard* shard = GetShard(key);
+    base::AutoLock lock(shard->lock);
+
+    auto it = shard->entries.Get(key);
+    if (it == shard->entries.end()) {
+      shard->misses++;
+      return false;
+    }
+    shard->hits++;
+    *value = it->second;
+    return true;
+  }
+
+  void Put(const Key& key, const Value& value) {
+    Shard* shard = GetShard(key);
+    base::AutoLock lock(shard->lock);
+
+    auto existing = shard->entries.Peek(key);
+    if (existing != shard->entries.end()) {
+      shard->memory_usage -= EntryCost(existing->first, existing->second);
+      shard->entries.Erase(existing);
+    }
+    shard->memory_usage += EntryCost(key, value);
+    shard->entries.Put(key, value);
+    EvictToBudget(shard, shard->max_bytes);
+  }
+
+  void Remove(const Key& key) {
+    Shard* shard = GetShard(key);
+    base::AutoLock lock(shard->lock);
+
+    auto it = shard->entries.Peek(key);
+    if (it == shard->entries.end())
+      return;
+    shard->memory_usage -= EntryCost(it->first, it->second);
+    shard->entries.Erase(it);
+  }
+
+  // Removes every entry for which |predicate(key, value)| returns true.
+  template <class Predicate>
+  void RemoveIf(Predicate predicate) {
+    for (auto& shard : shards_) {
+      base::AutoLock lock(shard->lock);
+      auto it = shard->entries.begin();
+      while (it != shard->entries.end()) {
+        if (!predicate(it->first, it->second)) {
+          ++it;
+          continue;
+        }
+        shard->memory_usage -= EntryCost(it->first, it->second);
+        it = shard->entries.Erase(it);
+      }
+    }
+  }
+
+  void Clear() {
+    for (auto& shard : shards_) {
+      base::AutoLock lock(shard->lock);
+      shard->entries.Clear();
+      shard->memory_usage = 0;
+    }
+  }
+
+  // Keeps only the most recently used entries of every shard, up to
+  // |fraction| of the bytes the shard holds now.
+  void Trim(double fraction) {
+    for (auto& shard : shards_) {
+      base::AutoLock lock(shard->lock);
+      EvictToBudget(shard.get(),
+                    static_cast<size_t>(shard->memory_usage * fraction));
+    }
+  }
+
+  ShardedLRUCacheStats GetStats() {
+    ShardedLRUCacheStats stats;
+    for (auto& shard : shards_) {
+      base::AutoLock lock(shard->lock);
+      stats.hits += shard->hits;
+      stats.misses += shard->misses;
+      stats.evictions += shard->evictions;
+      stats.entries += shard->entries.size();
+      stats.memory_usage += shard->memory_usage;
+    }
+    return stats;
+  }
+
+ private:
+  using Entries = base::MRUCache<Key, Value>;
+
+  struct Shard {
+    explicit Shard(size_t max_bytes)
+        : entries(Entries::NO_AUTO_EVICT), max_bytes(max_bytes) {}
+
+    base::Lock lock;
+    Entries entries;
+    const size_t max_bytes;
+    size_t memory_usage = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+  };
+
+  static size_t EntryCost(const Key& key, const Value& value) {
+    return sizeof(Key) + sizeof(Value) + Traits::EntryCost(key, value);
+  }
+
+  static void EvictToBudget(Shard* shard, size_t max_bytes) {
+    while (shard->memory_usage > max_bytes && !shard->entries.empty()) {
+      auto oldest = shard->entries.rbegin();
+      shard->memory_usage -= EntryCost(oldest->first, oldest->second);
+      shard->entries.Erase(oldest);
+      shard->evictions++;
+    }
+  }
+
+  Shard* GetShard(const Key& key) {
+    return shards_[Traits::ShardHash(key) % shards_.size()].get();
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShardedLRUCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHARDED_LRU_CACHE_H_
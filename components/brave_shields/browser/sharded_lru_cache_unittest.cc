@@ -0,0 +1,120 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/sharded_lru_cache.h"
+
+#include <functional>
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+struct StringTraits {
+  static size_t ShardHash(const std::string& key) {
+    return std::hash<std::string>()(key);
+  }
+  static size_t EntryCost(const std::string& key, const std::string& value) {
+    return key.size() + value.size();
+  }
+};
+
+using StringCache = ShardedLRUCache<std::string, std::string, StringTraits>;
+
+const size_t kEntryOverhead = 2 * sizeof(std::string);
+
+}  // namespace
+
+TEST(ShardedLRUCacheTest, GetPutRemove) {
+  StringCache cache(4096, 4);
+  cache.Put("http://a.com/", "https://a.com/");
+
+  std::string value;
+  EXPECT_TRUE(cache.Get("http://a.com/", &value));
+  EXPECT_EQ("https://a.com/", value);
+  EXPECT_FALSE(cache.Get("http://b.com/", &value));
+
+  cache.Remove("http://a.com/");
+  EXPECT_FALSE(cache.Get("http://a.com/", &value));
+
+  ShardedLRUCacheStats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(0u, stats.entries);
+  EXPECT_EQ(0u, stats.memory_usage);
+}
+
+TEST(ShardedLRUCacheTest, RemoveIf) {
+  StringCache cache(4096, 4);
+  cache.Put("http://a.com/", "https://a.com/");
+  cache.Put("http://b.com/", "https://b.com/");
+  cache.Put("http://c.com/", "http://c.com/");
+
+  cache.RemoveIf([](const std::string& key, const std::string& value) {
+    return value.compare(0, 8, "https://") == 0;
+  });
+
+  std::string value;
+  EXPECT_FALSE(cache.Get("http://a.com/", &value));
+  EXPECT_FALSE(cache.Get("http://b.com/", &value));
+  EXPECT_TRUE(cache.Get("http://c.com/", &value));
+
+  ShardedLRUCacheStats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.entries);
+  EXPECT_EQ(kEntryOverhead + 2 * std::string("http://c.com/").size(),
+            stats.memory_usage);
+}
+
+TEST(ShardedLRUCacheTest, IsBoundedByBytes) {
+  const size_t kMaxBytes = 16 * 1024;
+  StringCache cache(kMaxBytes, 4);
+  for (int i = 0; i < 1000; ++i) {
+    std::string url = "http://" + base::IntToString(i) + ".com/";
+    cache.Put(url, url);
+  }
+
+  ShardedLRUCacheStats stats = cache.GetStats();
+  EXPECT_LE(stats.memory_usage, kMaxBytes);
+  EXPECT_EQ(1000u, stats.entries + stats.evictions);
+
+  cache.Trim(0.5);
+  EXPECT_LE(cache.GetStats().memory_usage, stats.memory_usage / 2);
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetStats().entries);
+  EXPECT_EQ(0u, cache.GetStats().memory_usage);
+}
+
+TEST(ShardedLRUCacheTest, LongKeysTakeMoreRoom) {
+  StringCache cache(4 * (1000 + kEntryOverhead), 1);
+  for (int i = 0; i < 10; ++i)
+    cache.Put(std::string(999, 'a') + base::IntToString(i), std::string());
+  EXPECT_EQ(4u, cache.GetStats().entries);
+
+  // The least recently used entries go first.
+  std::string value;
+  EXPECT_TRUE(cache.Get(std::string(999, 'a') + "9", &value));
+  EXPECT_FALSE(cache.Get(std::string(999, 'a') + "5", &value));
+
+  // An entry bigger than the whole shard is not kept.
+  cache.Put(std::string(10000, 'b'), std::string());
+  EXPECT_EQ(0u, cache.GetStats().entries);
+}
+
+TEST(ShardedLRUCacheTest, PutReplacesValue) {
+  StringCache cache(4096, 1);
+  cache.Put("http://a.com/", std::string(100, 'x'));
+  cache.Put("http://a.com/", "https://a.com/");
+
+  ShardedLRUCacheStats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.entries);
+  EXPECT_EQ(kEntryOverhead + 2 * std::string("http://a.com/").size() + 1,
+            stats.memory_usage);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,78 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_decision_cache.h"
+
+#include <functional>
+
+#include "base/no_destructor.h"
+#include "url/gurl.h"
+
+#define SHIELDS_DECISION_CACHE_MAX_BYTES (1024 * 1024)
+#define SHIELDS_DECISION_CACHE_SHARDS 16
+
+namespace brave_shields {
+
+// static
+size_t ShieldsDecisionCache::KeyTraits::ShardHash(const Key& key) {
+  return std::hash<std::string>()(std::get<0>(key));
+}
+
+// static
+size_t ShieldsDecisionCache::KeyTraits::EntryCost(const Key& key,
+                                                  Decision decision) {
+  return std::get<0>(key).size() + std::get<1>(key).size();
+}
+
+ShieldsDecisionCache::ShieldsDecisionCache(size_t max_bytes,
+                                           size_t shard_count)
+    : entries_(max_bytes, shard_count),
+      generation_(0) {
+}
+
+ShieldsDecisionCache::~ShieldsDecisionCache() = default;
+
+// static
+ShieldsDecisionCache* ShieldsDecisionCache::GetInstance() {
+  static base::NoDestructor<ShieldsDecisionCache> instance(
+      SHIELDS_DECISION_CACHE_MAX_BYTES, SHIELDS_DECISION_CACHE_SHARDS);
+  return instance.get();
+}
+
+bool ShieldsDecisionCache::Get(const std::string& tab_host,
+                               const GURL& url,
+                               content::ResourceType resource_type,
+                               Decision* decision) {
+  return entries_.Get(
+      Key(url.spec(), tab_host, resource_type, generation_.load()),
+      decision);
+}
+
+void ShieldsDecisionCache::Put(const std::string& tab_host,
+                               const GURL& url,
+                               content::ResourceType resource_type,
+                               Decision decision,
+                               uint64_t generation) {
+  // A stale decision that gets past this check is stored under its old
+  // generation, where Get() never looks, and ages out.
+  if (generation != generation_)
+    return;
+  entries_.Put(Key(url.spec(), tab_host, resource_type, generation),
+               decision);
+}
+
+void ShieldsDecisionCache::Invalidate() {
+  generation_++;
+  entries_.Clear();
+}
+
+ShieldsDecisionCache::Stats ShieldsDecisionCache::GetStats() {
+  Stats stats;
+  static_cast<ShardedLRUCacheStats&>(stats) = entries_.GetStats();
+  stats.invalidations = generation_;
+  return stats;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,92 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_DECISION_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_DECISION_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <tuple>
+
+#include "base/macros.h"
+#include "brave/components/brave_shields/browser/sharded_lru_cache.h"
+#include "content/public/common/resource_type.h"
+
+class GURL;
+
+namespace brave_shields {
+
+// Remembers what the tracking protection and ad-block matchers decided for a
+// (tab host, request URL, resource type) triple, so that beacons and CDN
+// scripts loaded again and again across tabs are only matched once.
+//
+// Only the matcher results are cached. The shields content settings are
+// checked for every request before the cache is consulted, so a settings
+// change applies to the next request without touching the cache. A DAT file
+// swap does change the matcher results, so every service that swaps one must
+// call Invalidate() after publishing the new data.
+//
+// Safe to use on any thread.
+class ShieldsDecisionCache {
+ public:
+  enum Decision {
+    kAllow,
+    kBlockedByTrackingProtection,
+    kBlockedByAdBlock,
+  };
+
+  struct Stats : ShardedLRUCacheStats {
+    uint64_t invalidations = 0;
+  };
+
+  ShieldsDecisionCache(size_t max_bytes, size_t shard_count);
+  ~ShieldsDecisionCache();
+
+  // The cache shared by all profiles. Decisions do not depend on the
+  // profile, only on the lists.
+  static ShieldsDecisionCache* GetInstance();
+
+  // Read this before matching a request and pass it to Put(), so a decision
+  // computed against lists that were swapped in the meantime is dropped.
+  uint64_t generation() const { return generation_; }
+
+  bool Get(const std::string& tab_host,
+           const GURL& url,
+           content::ResourceType resource_type,
+           Decision* decision);
+  void Put(const std::string& tab_host,
+           const GURL& url,
+           content::ResourceType resource_type,
+           Decision decision,
+           uint64_t generation);
+
+  // Drops every cached decision.
+  void Invalidate();
+
+  Stats GetStats();
+
+ private:
+  // (request URL, tab host, resource type, generation). Keeping the
+  // generation in the key means a decision put after Invalidate() for older
+  // lists can never be found.
+  using Key = std::tuple<std::string, std::string, int, uint64_t>;
+
+  struct KeyTraits {
+    static size_t ShardHash(const Key& key);
+    static size_t EntryCost(const Key& key, Decision decision);
+  };
+
+  ShardedLRUCache<Key, Decision, KeyTraits> entries_;
+  std::atomic<uint64_t> generation_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsDecisionCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_DECISION_CACHE_H_
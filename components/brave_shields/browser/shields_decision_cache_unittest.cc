@@ -0,0 +1,72 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_decision_cache.h"
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+TEST(ShieldsDecisionCacheTest, KeyedByTabHostURLAndResourceType) {
+  ShieldsDecisionCache cache(4096, 4);
+  GURL url("https://tracker.example/beacon.js");
+  cache.Put("a.com", url, content::RESOURCE_TYPE_SCRIPT,
+            ShieldsDecisionCache::kBlockedByAdBlock, cache.generation());
+
+  ShieldsDecisionCache::Decision decision;
+  EXPECT_TRUE(cache.Get("a.com", url, content::RESOURCE_TYPE_SCRIPT,
+                        &decision));
+  EXPECT_EQ(ShieldsDecisionCache::kBlockedByAdBlock, decision);
+  EXPECT_FALSE(cache.Get("b.com", url, content::RESOURCE_TYPE_SCRIPT,
+                         &decision));
+  EXPECT_FALSE(cache.Get("a.com", url, content::RESOURCE_TYPE_IMAGE,
+                         &decision));
+  EXPECT_FALSE(cache.Get("a.com", GURL("https://tracker.example/other.js"),
+                         content::RESOURCE_TYPE_SCRIPT, &decision));
+
+  ShieldsDecisionCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+  EXPECT_EQ(1u, stats.entries);
+}
+
+TEST(ShieldsDecisionCacheTest, InvalidateDropsDecisions) {
+  ShieldsDecisionCache cache(4096, 4);
+  GURL url("https://cdn.example/lib.js");
+  uint64_t generation = cache.generation();
+  cache.Put("a.com", url, content::RESOURCE_TYPE_SCRIPT,
+            ShieldsDecisionCache::kAllow, generation);
+  cache.Invalidate();
+
+  ShieldsDecisionCache::Decision decision;
+  EXPECT_FALSE(cache.Get("a.com", url, content::RESOURCE_TYPE_SCRIPT,
+                         &decision));
+
+  // A decision computed against the lists from before the swap is dropped.
+  cache.Put("a.com", url, content::RESOURCE_TYPE_SCRIPT,
+            ShieldsDecisionCache::kAllow, generation);
+  EXPECT_FALSE(cache.Get("a.com", url, content::RESOURCE_TYPE_SCRIPT,
+                         &decision));
+  EXPECT_EQ(1u, cache.GetStats().invalidations);
+}
+
+TEST(ShieldsDecisionCacheTest, IsBoundedByBytes) {
+  ShieldsDecisionCache cache(16 * 1024, 4);
+  for (int i = 0; i < 1000; ++i) {
+    GURL url("https://" + base::IntToString(i) + ".example/");
+    cache.Put("a.com", url, content::RESOURCE_TYPE_IMAGE,
+              ShieldsDecisionCache::kAllow, cache.generation());
+  }
+
+  ShieldsDecisionCache::Stats stats = cache.GetStats();
+  EXPECT_LE(stats.memory_usage, 16u * 1024);
+  EXPECT_EQ(1000u, stats.entries + stats.evictions);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,97 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_settings_cache.h"
+
+#include "base/no_destructor.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "url/gurl.h"
+
+#define SHIELDS_SETTINGS_CACHE_ENTRIES 256
+
+namespace brave_shields {
+
+namespace {
+
+ShieldsSettings ReadShieldsSettings(HostContentSettingsMap* map,
+                                    const GURL& tab_origin) {
+  ShieldsSettings settings;
+  settings.allow_brave_shields = IsAllowContentSetting(map,
+      tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS, kBraveShields);
+  settings.shields_up = IsAllowContentSetting(map,
+      tab_origin, GURL(), CONTENT_SETTINGS_TYPE_PLUGINS, kBraveShields);
+  settings.allow_ads = IsAllowContentSetting(map,
+      tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS, kAds);
+  settings.allow_http_upgradable_resources = IsAllowContentSetting(map,
+      tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS,
+      kHTTPUpgradableResources);
+  settings.allow_1p_cookies = IsAllowContentSetting(map,
+      tab_origin, GURL("https://firstParty/"), CONTENT_SETTINGS_TYPE_PLUGINS,
+      kCookies);
+  settings.allow_3p_cookies = IsAllowContentSetting(map,
+      tab_origin, GURL(), CONTENT_SETTINGS_TYPE_PLUGINS, kCookies);
+  settings.allow_referrers = IsAllowContentSetting(map,
+      tab_origin, tab_origin, CONTENT_SETTINGS_TYPE_PLUGINS, kReferrers);
+  return settings;
+}
+
+}  // namespace
+
+ShieldsSettingsCache::ShieldsSettingsCache(size_t max_entries)
+    : entries_(max_entries),
+      version_(0) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+ShieldsSettingsCache::~ShieldsSettingsCache() = default;
+
+// static
+ShieldsSettingsCache* ShieldsSettingsCache::GetInstance() {
+  static base::NoDestructor<ShieldsSettingsCache> instance(
+      SHIELDS_SETTINGS_CACHE_ENTRIES);
+  return instance.get();
+}
+
+ShieldsSettings ShieldsSettingsCache::Get(HostContentSettingsMap* map,
+                                          const GURL& tab_origin) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!map)
+    return ShieldsSettings();
+
+  // Read before the settings, so a change notified while they are read
+  // leaves the new entry stale.
+  uint64_t version = version_;
+  Key key(map, tab_origin.spec());
+  auto it = entries_.Get(key);
+  if (it != entries_.end() && it->second.version == version) {
+    hits_++;
+    return it->second.settings;
+  }
+
+  misses_++;
+  Entry entry;
+  entry.version = version;
+  entry.settings = ReadShieldsSettings(map, tab_origin);
+  entries_.Put(key, entry);
+  return entry.settings;
+}
+
+void ShieldsSettingsCache::Invalidate() {
+  version_++;
+}
+
+ShieldsSettingsCache::Stats ShieldsSettingsCache::GetStats() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.invalidations = version_;
+  stats.entries = entries_.size();
+  return stats;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,90 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <utility>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/sequence_checker.h"
+
+class GURL;
+class HostContentSettingsMap;
+
+namespace brave_shields {
+
+// The shields content settings of one tab origin.
+struct ShieldsSettings {
+  // Shields are not turned off for the tab origin.
+  bool allow_brave_shields = true;
+  // Same as |allow_brave_shields|, but only looks at rules that apply to
+  // every secondary URL.
+  bool shields_up = true;
+  bool allow_ads = false;
+  bool allow_http_upgradable_resources = false;
+  bool allow_1p_cookies = true;
+  bool allow_3p_cookies = false;
+  bool allow_referrers = false;
+};
+
+// Keeps the ShieldsSettings of recently seen (profile, tab origin) pairs on
+// the IO thread, so the requests of a page do not walk the content settings
+// patterns again for every network delegate event.
+//
+// Entries carry the version they were read at. A ShieldsSettingsObserver
+// calls Invalidate() on every shields content settings change of any profile,
+// which makes all entries stale at once.
+class ShieldsSettingsCache {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+  };
+
+  explicit ShieldsSettingsCache(size_t max_entries);
+  ~ShieldsSettingsCache();
+
+  // The cache shared by all profiles, only used on the IO thread.
+  static ShieldsSettingsCache* GetInstance();
+
+  // Returns the settings |map| has for |tab_origin|. A null |map| gives the
+  // defaults. Must be called on a single sequence.
+  ShieldsSettings Get(HostContentSettingsMap* map, const GURL& tab_origin);
+
+  // Makes every cached entry stale. Safe to call on any thread.
+  void Invalidate();
+
+  Stats GetStats();
+
+ private:
+  using Key = std::pair<const HostContentSettingsMap*, std::string>;
+
+  struct Entry {
+    uint64_t version;
+    ShieldsSettings settings;
+  };
+
+  base::MRUCache<Key, Entry> entries_;
+  std::atomic<uint64_t> version_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsSettingsCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_CACHE_H_
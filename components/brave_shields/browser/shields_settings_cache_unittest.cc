@@ -0,0 +1,102 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_settings_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "brave/components/brave_shields/browser/shields_settings_observer.h"
+#include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+class ShieldsSettingsCacheTest : public testing::Test {
+ public:
+  ShieldsSettingsCacheTest() : cache_(16) {}
+
+  void SetUp() override {
+    map_ = HostContentSettingsMapFactory::GetForProfile(&profile_);
+    observer_ = std::make_unique<ShieldsSettingsObserver>(map_, &cache_);
+  }
+
+  void TearDown() override {
+    observer_->Shutdown();
+  }
+
+  void SetShieldsSetting(const GURL& origin,
+                         const std::string& resource_identifier,
+                         ContentSetting setting) {
+    map_->SetContentSettingCustomScope(
+        ContentSettingsPattern::FromURL(origin),
+        ContentSettingsPattern::Wildcard(), CONTENT_SETTINGS_TYPE_PLUGINS,
+        resource_identifier, setting);
+  }
+
+ protected:
+  content::TestBrowserThreadBundle test_browser_thread_bundle_;
+  TestingProfile profile_;
+  HostContentSettingsMap* map_;
+  ShieldsSettingsCache cache_;
+  std::unique_ptr<ShieldsSettingsObserver> observer_;
+};
+
+TEST_F(ShieldsSettingsCacheTest, Defaults) {
+  ShieldsSettings settings = cache_.Get(map_, GURL("https://a.com/"));
+  EXPECT_TRUE(settings.allow_brave_shields);
+  EXPECT_TRUE(settings.shields_up);
+  EXPECT_FALSE(settings.allow_ads);
+  EXPECT_FALSE(settings.allow_http_upgradable_resources);
+  EXPECT_TRUE(settings.allow_1p_cookies);
+  EXPECT_FALSE(settings.allow_3p_cookies);
+  EXPECT_FALSE(settings.allow_referrers);
+
+  settings = cache_.Get(nullptr, GURL("https://a.com/"));
+  EXPECT_TRUE(settings.allow_brave_shields);
+  EXPECT_FALSE(settings.allow_ads);
+}
+
+TEST_F(ShieldsSettingsCacheTest, ReadOncePerOrigin) {
+  GURL tab_origin("https://a.com/");
+  SetShieldsSetting(tab_origin, kAds, CONTENT_SETTING_ALLOW);
+  EXPECT_TRUE(cache_.Get(map_, tab_origin).allow_ads);
+  EXPECT_TRUE(cache_.Get(map_, tab_origin).allow_ads);
+  EXPECT_TRUE(cache_.Get(map_, tab_origin).allow_ads);
+  EXPECT_FALSE(cache_.Get(map_, GURL("https://b.com/")).allow_ads);
+
+  ShieldsSettingsCache::Stats stats = cache_.GetStats();
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(2u, stats.entries);
+}
+
+TEST_F(ShieldsSettingsCacheTest, ContentSettingChangeInvalidates) {
+  GURL tab_origin("https://a.com/");
+  EXPECT_TRUE(cache_.Get(map_, tab_origin).allow_brave_shields);
+
+  SetShieldsSetting(tab_origin, kBraveShields, CONTENT_SETTING_BLOCK);
+  ShieldsSettings settings = cache_.Get(map_, tab_origin);
+  EXPECT_FALSE(settings.allow_brave_shields);
+  EXPECT_FALSE(settings.shields_up);
+
+  SetShieldsSetting(tab_origin, kBraveShields, CONTENT_SETTING_ALLOW);
+  EXPECT_TRUE(cache_.Get(map_, tab_origin).allow_brave_shields);
+  EXPECT_EQ(0u, cache_.GetStats().hits);
+}
+
+TEST_F(ShieldsSettingsCacheTest, IsBounded) {
+  for (int i = 0; i < 100; ++i)
+    cache_.Get(map_, GURL("https://" + base::IntToString(i) + ".com/"));
+  EXPECT_EQ(16u, cache_.GetStats().entries);
+}
+
+}  // namespace brave_shields
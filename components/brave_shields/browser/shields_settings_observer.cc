@@ -0,0 +1,40 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_settings_observer.h"
+
+#include "brave/components/brave_shields/browser/shields_settings_cache.h"
+
+namespace brave_shields {
+
+ShieldsSettingsObserver::ShieldsSettingsObserver(HostContentSettingsMap* map,
+                                                 ShieldsSettingsCache* cache)
+    : cache_(cache),
+      observer_(this) {
+  observer_.Add(map);
+}
+
+ShieldsSettingsObserver::~ShieldsSettingsObserver() = default;
+
+void ShieldsSettingsObserver::Shutdown() {
+  observer_.RemoveAll();
+  // Entries are keyed by the map pointer, which a later profile may reuse.
+  cache_->Invalidate();
+}
+
+void ShieldsSettingsObserver::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type,
+    const std::string& resource_identifier) {
+  // The shields settings are stored as plugins settings with a resource
+  // identifier. CONTENT_SETTINGS_TYPE_DEFAULT means that every type changed.
+  if (content_type == CONTENT_SETTINGS_TYPE_PLUGINS ||
+      content_type == CONTENT_SETTINGS_TYPE_DEFAULT) {
+    cache_->Invalidate();
+  }
+}
+
+}  // namespace brave_shields
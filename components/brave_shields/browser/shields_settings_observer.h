@@ -0,0 +1,50 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_OBSERVER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_OBSERVER_H_
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/scoped_observer.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "components/keyed_service/core/keyed_service.h"
+
+namespace brave_shields {
+
+class ShieldsSettingsCache;
+
+// Invalidates |cache| whenever the shields content settings of |map| change.
+// There is one per profile, including off-the-record ones, which have their
+// own HostContentSettingsMap.
+class ShieldsSettingsObserver : public KeyedService,
+                                public content_settings::Observer {
+ public:
+  ShieldsSettingsObserver(HostContentSettingsMap* map,
+                          ShieldsSettingsCache* cache);
+  ~ShieldsSettingsObserver() override;
+
+  // KeyedService:
+  void Shutdown() override;
+
+  // content_settings::Observer:
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type,
+                               const std::string& resource_identifier) override;
+
+ private:
+  ShieldsSettingsCache* cache_;
+  ScopedObserver<HostContentSettingsMap, content_settings::Observer>
+      observer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsSettingsObserver);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_OBSERVER_H_
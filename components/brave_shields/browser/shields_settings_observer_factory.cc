@@ -0,0 +1,51 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_settings_observer_factory.h"
+
+#include "brave/components/brave_shields/browser/shields_settings_cache.h"
+#include "brave/components/brave_shields/browser/shields_settings_observer.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/browser/profiles/incognito_helpers.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+
+namespace brave_shields {
+
+// static
+ShieldsSettingsObserverFactory* ShieldsSettingsObserverFactory::GetInstance() {
+  return base::Singleton<ShieldsSettingsObserverFactory>::get();
+}
+
+ShieldsSettingsObserverFactory::ShieldsSettingsObserverFactory()
+    : BrowserContextKeyedServiceFactory(
+          "ShieldsSettingsObserver",
+          BrowserContextDependencyManager::GetInstance()) {
+  DependsOn(HostContentSettingsMapFactory::GetInstance());
+}
+
+ShieldsSettingsObserverFactory::~ShieldsSettingsObserverFactory() {
+}
+
+KeyedService* ShieldsSettingsObserverFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new ShieldsSettingsObserver(
+      HostContentSettingsMapFactory::GetForProfile(
+          Profile::FromBrowserContext(context)),
+      ShieldsSettingsCache::GetInstance());
+}
+
+content::BrowserContext* ShieldsSettingsObserverFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  // Off-the-record profiles have their own HostContentSettingsMap.
+  return chrome::GetBrowserContextOwnInstanceInIncognito(context);
+}
+
+bool ShieldsSettingsObserverFactory::ServiceIsCreatedWithBrowserContext()
+    const {
+  return true;
+}
+
+}  // namespace brave_shields
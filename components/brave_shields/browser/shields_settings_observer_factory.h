@@ -0,0 +1,39 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_OBSERVER_FACTORY_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_OBSERVER_FACTORY_H_
+
+#include "base/memory/singleton.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace brave_shields {
+
+// Creates a ShieldsSettingsObserver together with every profile, so the IO
+// thread ShieldsSettingsCache never serves settings that changed.
+class ShieldsSettingsObserverFactory
+    : public BrowserContextKeyedServiceFactory {
+ public:
+  static ShieldsSettingsObserverFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<ShieldsSettingsObserverFactory>;
+
+  ShieldsSettingsObserverFactory();
+  ~ShieldsSettingsObserverFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+  bool ServiceIsCreatedWithBrowserContext() const override;
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsSettingsObserverFactory);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_OBSERVER_FACTORY_H_
@@ -4,7 +4,6 @@
 
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 
-#include <algorithm>
 #include <utility>
 
 #include "base/base_paths.h"
@@ -18,17 +17,18 @@
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/local_data_files_service.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/shields_decision_cache.h"
+#include "brave/components/brave_shields/browser/tracking_protection_third_party_hosts.h"
 #include "brave/vendor/tracking-protection/TPParser.h"
 
 #define DAT_FILE "TrackingProtection.dat"
 #define DAT_FILE_VERSION "1"
-#define THIRD_PARTY_HOSTS_CACHE_SIZE 20
+#define THIRD_PARTY_HOSTS_CACHE_SIZE 100
 
 namespace brave_shields {
 
 TrackingProtectionService::TrackingProtectionService()
-  : tracking_protection_client_(new CTPParser()),
-    // See comment in tracking_protection_service.h for white_list_
+  : // See comment in tracking_protection_service.h for white_list_
     white_list_({
       "connect.facebook.net",
       "connect.facebook.com",
@@ -40,59 +40,97 @@ TrackingProtectionService::TrackingProtectionService()
       "platform.twitter.com",
       "syndication.twitter.com",
       "cdn.syndication.twimg.com"
-    }),
-    weak_factory_(this) {
+    }) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 TrackingProtectionService::~TrackingProtectionService() {
-  tracking_protection_client_.reset();
+  std::unique_ptr<DATFileMemoryDumpProvider> memory_dump_provider;
+  {
+    base::AutoLock lock(tracking_protection_client_lock_);
+    tracking_protection_client_ = nullptr;
+    third_party_host_index_ = nullptr;
+    memory_dump_provider = std::move(memory_dump_provider_);
+  }
+  if (memory_dump_provider)
+    DATFileMemoryDumpProvider::Unregister(std::move(memory_dump_provider));
 }
 
 bool TrackingProtectionService::ShouldStartRequest(const GURL& url,
     content::ResourceType resource_type,
     const std::string &tab_host) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Keeps the data alive even if an update swaps it while matching.
+  scoped_refptr<TrackingProtectionClientData> tracking_protection_client;
+  scoped_refptr<ThirdPartyHostIndex> third_party_host_index;
+  GetTrackingProtectionClientData(&tracking_protection_client,
+                                  &third_party_host_index);
+  if (!tracking_protection_client)
+    return true;
+
   std::string host = url.host();
-  if (!tracking_protection_client_->matchesTracker(
+  if (!tracking_protection_client->client()->matchesTracker(
         tab_host.c_str(), host.c_str())) {
     return true;
   }
 
-  std::vector<std::string> hosts(GetThirdPartyHosts(tab_host));
-  for (size_t i = 0; i < hosts.size(); i++) {
-    if (host == hosts[i] ||
-        host.find((std::string)"." + hosts[i]) != std::string::npos) {
-      return true;
-    }
-    size_t iPos = host.find((std::string)"." + hosts[i]);
-    if (iPos == std::string::npos) {
-      continue;
-    }
-    if (hosts[i].length() + ((std::string)".").length() + iPos ==
-        host.length()) {
-      return true;
-    }
-  }
-
-  if (std::find(white_list_.begin(), white_list_.end(), host) !=
-      white_list_.end()) {
+  scoped_refptr<ThirdPartyHosts> third_party_hosts =
+      GetThirdPartyHosts(tracking_protection_client->client(),
+                         third_party_host_index.get(), tab_host);
+  if (third_party_hosts && third_party_hosts->Matches(host))
     return true;
-  }
-  return false;
+
+  return white_list_.find(host) != white_list_.end();
 }
 
-void TrackingProtectionService::OnDATFileDataReady() {
-  if (buffer_.empty()) {
+void TrackingProtectionService::LoadDATFile(
+    const base::FilePath& dat_file_path) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::unique_ptr<base::MemoryMappedFile> dat_file =
+      MapDATFile(dat_file_path);
+  if (!dat_file) {
     LOG(ERROR) << "Could not obtain tracking protection data";
     return;
   }
-  tracking_protection_client_.reset(new CTPParser());
-  if (!tracking_protection_client_->deserialize((char*)&buffer_.front())) {
-    tracking_protection_client_.reset();
+
+  std::unique_ptr<CTPParser> tracking_protection_client(new CTPParser());
+  if (!DeserializeDATFile(*dat_file, tracking_protection_client.get())) {
     LOG(ERROR) << "Failed to deserialize tracking protection data";
     return;
   }
+
+  scoped_refptr<TrackingProtectionClientData> tracking_protection_client_data(
+      new TrackingProtectionClientData(std::move(dat_file),
+                                       std::move(tracking_protection_client)));
+  scoped_refptr<TrackingProtectionClientData> old_tracking_protection_client;
+  {
+    base::AutoLock lock(tracking_protection_client_lock_);
+    old_tracking_protection_client.swap(tracking_protection_client_);
+    tracking_protection_client_ = tracking_protection_client_data;
+    third_party_host_index_ =
+        new ThirdPartyHostIndex(THIRD_PARTY_HOSTS_CACHE_SIZE);
+    if (!memory_dump_provider_) {
+      memory_dump_provider_ =
+          DATFileMemoryDumpProvider::Register("tracking_protection");
+    }
+    memory_dump_provider_->set_mapped_size(
+        tracking_protection_client_data->mapped_size());
+  }
+  ShieldsDecisionCache::GetInstance()->Invalidate();
+
+  // Matching runs on this sequence too, so nothing else holds the old data.
+  // Unmap it now rather than keep the old version's file open.
+  DCHECK(!old_tracking_protection_client ||
+         old_tracking_protection_client->HasOneRef());
+  old_tracking_protection_client = nullptr;
+}
+
+void TrackingProtectionService::GetTrackingProtectionClientData(
+    scoped_refptr<TrackingProtectionClientData>* tracking_protection_client,
+    scoped_refptr<ThirdPartyHostIndex>* third_party_host_index) {
+  base::AutoLock lock(tracking_protection_client_lock_);
+  *tracking_protection_client = tracking_protection_client_;
+  *third_party_host_index = third_party_host_index_;
 }
 
 void TrackingProtectionService::OnComponentReady(
@@ -102,66 +140,30 @@ void TrackingProtectionService::OnComponentReady(
   base::FilePath dat_file_path =
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
 
-  GetTaskRunner()->PostTaskAndReply(
+  GetTaskRunner()->PostTask(
       FROM_HERE,
-      base::Bind(&GetDATFileData, dat_file_path, &buffer_),
-      base::Bind(&TrackingProtectionService::OnDATFileDataReady,
-                 weak_factory_.GetWeakPtr()));
+      base::Bind(&TrackingProtectionService::LoadDATFile,
+                 base::Unretained(this),
+                 dat_file_path));
 }
 
 // Ported from Android: net/blockers/blockers_worker.cc
-std::vector<std::string>
-TrackingProtectionService::GetThirdPartyHosts(const std::string& base_host) {
-  {
-    std::lock_guard<std::mutex> guard(third_party_hosts_mutex_);
-    std::map<std::string, std::vector<std::string>>::const_iterator iter =
-      third_party_hosts_cache_.find(base_host);
-    if (third_party_hosts_cache_.end() != iter) {
-      if (third_party_base_hosts_.size() != 0
-          && third_party_base_hosts_[third_party_hosts_cache_.size() - 1] !=
-          base_host) {
-        for (size_t i = 0; i < third_party_base_hosts_.size(); i++) {
-          if (third_party_base_hosts_[i] == base_host) {
-            third_party_base_hosts_.erase(third_party_base_hosts_.begin() + i);
-            third_party_base_hosts_.push_back(base_host);
-            break;
-          }
-        }
-      }
-      return iter->second;
-    }
+scoped_refptr<ThirdPartyHosts> TrackingProtectionService::GetThirdPartyHosts(
+    CTPParser* client,
+    ThirdPartyHostIndex* third_party_host_index,
+    const std::string& base_host) {
+  scoped_refptr<ThirdPartyHosts> hosts;
+  if (third_party_host_index->Find(base_host, &hosts))
+    return hosts;
+
+  // Parsed once per first-party host and data version. Concurrent misses
+  // for the same host may both parse it, the results are identical.
+  char* third_party_hosts = client->findFirstPartyHosts(base_host.c_str());
+  if (third_party_hosts) {
+    hosts = ThirdPartyHosts::Parse(third_party_hosts);
+    delete []third_party_hosts;
   }
-
-  char* thirdPartyHosts =
-    tracking_protection_client_->findFirstPartyHosts(base_host.c_str());
-  std::vector<std::string> hosts;
-  if (nullptr != thirdPartyHosts) {
-    std::string strThirdPartyHosts = thirdPartyHosts;
-    size_t iPos = strThirdPartyHosts.find(",");
-    while (iPos != std::string::npos) {
-      std::string thirdParty = strThirdPartyHosts.substr(0, iPos);
-      strThirdPartyHosts = strThirdPartyHosts.substr(iPos + 1);
-      iPos = strThirdPartyHosts.find(",");
-      hosts.push_back(thirdParty);
-    }
-    if (0 != strThirdPartyHosts.length()) {
-      hosts.push_back(strThirdPartyHosts);
-    }
-    delete []thirdPartyHosts;
-  }
-
-  {
-    std::lock_guard<std::mutex> guard(third_party_hosts_mutex_);
-    if (third_party_hosts_cache_.size() == THIRD_PARTY_HOSTS_CACHE_SIZE &&
-        third_party_base_hosts_.size() == THIRD_PARTY_HOSTS_CACHE_SIZE) {
-      third_party_hosts_cache_.erase(third_party_base_hosts_[0]);
-      third_party_base_hosts_.erase(third_party_base_hosts_.begin());
-    }
-    third_party_base_hosts_.push_back(base_host);
-    third_party_hosts_cache_.insert(
-        std::pair<std::string, std::vector<std::string>>(base_host, hosts));
-  }
-
+  third_party_host_index->Insert(base_host, hosts);
   return hosts;
 }
 
@@ -7,18 +7,18 @@
 
 #include <stdint.h>
 
-#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
-#include <vector>
 
+#include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
-#include "base/memory/weak_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "base/sequence_checker.h"
 #include "base/sequenced_task_runner.h"
+#include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_local_data_files_observer.h"
 #include "brave/components/brave_shields/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/tracking_protection_third_party_hosts.h"
 #include "content/public/common/resource_type.h"
 #include "url/gurl.h"
 
@@ -33,6 +33,7 @@ class TrackingProtectionService : public BaseLocalDataFilesObserver {
   TrackingProtectionService();
   ~TrackingProtectionService() override;
 
+  // Must run on GetTaskRunner(), like the ad-block lists.
   bool ShouldStartRequest(const GURL& spec,
                           content::ResourceType resource_type,
                           const std::string& tab_host);
@@ -44,20 +45,28 @@ class TrackingProtectionService : public BaseLocalDataFilesObserver {
                         const std::string& manifest) override;
 
  private:
-  void OnDATFileDataReady();
-  std::vector<std::string> GetThirdPartyHosts(const std::string& base_host);
-
-  brave_shields::DATFileDataBuffer buffer_;
-
-  std::unique_ptr<CTPParser> tracking_protection_client_;
+  using TrackingProtectionClientData = DATFileClient<CTPParser>;
+
+  void LoadDATFile(const base::FilePath& dat_file_path);
+  void GetTrackingProtectionClientData(
+      scoped_refptr<TrackingProtectionClientData>* tracking_protection_client,
+      scoped_refptr<ThirdPartyHostIndex>* third_party_host_index);
+  scoped_refptr<ThirdPartyHosts> GetThirdPartyHosts(
+      CTPParser* client,
+      ThirdPartyHostIndex* third_party_host_index,
+      const std::string& base_host);
+
+  base::Lock tracking_protection_client_lock_;
+  scoped_refptr<TrackingProtectionClientData> tracking_protection_client_;
+  // Published together with |tracking_protection_client_|.
+  scoped_refptr<ThirdPartyHostIndex> third_party_host_index_;
   // TODO: Temporary hack which matches both browser-laptop and Android code
-  std::vector<std::string> white_list_;
-  std::vector<std::string> third_party_base_hosts_;
-  std::map<std::string, std::vector<std::string>> third_party_hosts_cache_;
-  std::mutex third_party_hosts_mutex_;
+  const base::flat_set<std::string> white_list_;
+  // Created on the task runner and released by the destructor on another
+  // thread, so it is guarded by |tracking_protection_client_lock_|.
+  std::unique_ptr<DATFileMemoryDumpProvider> memory_dump_provider_;
 
   SEQUENCE_CHECKER(sequence_checker_);
-  base::WeakPtrFactory<TrackingProtectionService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(TrackingProtectionService);
 };
 
@@ -9,6 +9,7 @@
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/brave_paths.h"
 #include "brave/common/pref_names.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/local_data_files_service.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "chrome/browser/ui/browser.h"
@@ -56,6 +57,8 @@ public:
 
   void SetUpOnMainThread() override {
     ExtensionBrowserTest::SetUpOnMainThread();
+    // The tests check the blocked counters right after the page reports.
+    brave_shields::SetBlockedEventsFlushDelayForTest(base::TimeDelta());
     base::PostTaskWithTraits(FROM_HERE, {content::BrowserThread::IO},
         base::BindOnce(&chrome_browser_net::SetUrlRequestMocksEnabled, true));
     host_resolver()->AddRule("*", "127.0.0.1");
@@ -0,0 +1,75 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/tracking_protection_third_party_hosts.h"
+
+#include <utility>
+
+namespace brave_shields {
+
+ThirdPartyHosts::ThirdPartyHosts() = default;
+ThirdPartyHosts::~ThirdPartyHosts() = default;
+
+// static
+scoped_refptr<ThirdPartyHosts> ThirdPartyHosts::Parse(
+    base::StringPiece hosts) {
+  scoped_refptr<ThirdPartyHosts> result(new ThirdPartyHosts());
+  hosts.CopyToString(&result->buffer_);
+
+  base::StringPiece remaining(result->buffer_);
+  while (!remaining.empty()) {
+    size_t comma = remaining.find(',');
+    base::StringPiece host = remaining.substr(0, comma);
+    // An empty entry would otherwise match every host.
+    if (!host.empty())
+      result->hosts_.insert(host);
+    if (comma == base::StringPiece::npos)
+      break;
+    remaining.remove_prefix(comma + 1);
+  }
+  return result;
+}
+
+bool ThirdPartyHosts::Matches(base::StringPiece host) const {
+  // Tries |host| and then each parent domain of it.
+  while (!host.empty()) {
+    if (hosts_.count(host))
+      return true;
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+ThirdPartyHostIndex::ThirdPartyHostIndex(size_t max_first_party_hosts)
+    : entries_(max_first_party_hosts) {
+}
+
+ThirdPartyHostIndex::~ThirdPartyHostIndex() = default;
+
+bool ThirdPartyHostIndex::Find(const std::string& first_party_host,
+                               scoped_refptr<ThirdPartyHosts>* hosts) {
+  base::AutoLock lock(lock_);
+  auto it = entries_.Get(first_party_host);
+  if (it == entries_.end())
+    return false;
+  *hosts = it->second;
+  return true;
+}
+
+void ThirdPartyHostIndex::Insert(const std::string& first_party_host,
+                                 scoped_refptr<ThirdPartyHosts> hosts) {
+  base::AutoLock lock(lock_);
+  entries_.Put(first_party_host, std::move(hosts));
+}
+
+size_t ThirdPartyHostIndex::size() {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,79 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_TRACKING_PROTECTION_THIRD_PARTY_HOSTS_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_TRACKING_PROTECTION_THIRD_PARTY_HOSTS_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <unordered_set>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+
+namespace brave_shields {
+
+// The third-party hosts a first-party host is allowed to load trackers from,
+// parsed once from the comma separated list of the tracking protection data.
+// The host names are stored in a single buffer and hashed, so matching a
+// request host does not allocate.
+class ThirdPartyHosts : public base::RefCountedThreadSafe<ThirdPartyHosts> {
+ public:
+  static scoped_refptr<ThirdPartyHosts> Parse(base::StringPiece hosts);
+
+  // Returns true if |host| is one of the hosts or a subdomain of one.
+  bool Matches(base::StringPiece host) const;
+
+  size_t size() const { return hosts_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<ThirdPartyHosts>;
+
+  ThirdPartyHosts();
+  ~ThirdPartyHosts();
+
+  // |hosts_| points into |buffer_|.
+  std::string buffer_;
+  std::unordered_set<base::StringPiece, base::StringPieceHash> hosts_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThirdPartyHosts);
+};
+
+// Bounded index of ThirdPartyHosts by first-party host, belonging to one
+// version of the tracking protection data. A new index is published with
+// every data update, so an entry parsed from old data can never outlive it.
+// The lock only covers the hash lookup, matching runs on the returned set.
+class ThirdPartyHostIndex
+    : public base::RefCountedThreadSafe<ThirdPartyHostIndex> {
+ public:
+  explicit ThirdPartyHostIndex(size_t max_first_party_hosts);
+
+  // Returns true if |first_party_host| is indexed. |*hosts| is set to its
+  // third-party hosts, which may be nullptr if it has none.
+  bool Find(const std::string& first_party_host,
+            scoped_refptr<ThirdPartyHosts>* hosts);
+  void Insert(const std::string& first_party_host,
+              scoped_refptr<ThirdPartyHosts> hosts);
+
+  size_t size();
+
+ private:
+  friend class base::RefCountedThreadSafe<ThirdPartyHostIndex>;
+
+  ~ThirdPartyHostIndex();
+
+  base::Lock lock_;
+  base::MRUCache<std::string, scoped_refptr<ThirdPartyHosts>> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThirdPartyHostIndex);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_TRACKING_PROTECTION_THIRD_PARTY_HOSTS_H_
@@ -0,0 +1,66 @@
+/* Copyright (c) 2019 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/tracking_protection_third_party_hosts.h"
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+TEST(ThirdPartyHostsTest, MatchesHostsAndSubdomains) {
+  scoped_refptr<ThirdPartyHosts> hosts =
+      ThirdPartyHosts::Parse("fbcdn.net,facebook.net,,twimg.com");
+  EXPECT_EQ(3u, hosts->size());
+
+  EXPECT_TRUE(hosts->Matches("fbcdn.net"));
+  EXPECT_TRUE(hosts->Matches("scontent.xx.fbcdn.net"));
+  EXPECT_TRUE(hosts->Matches("connect.facebook.net"));
+  EXPECT_TRUE(hosts->Matches("pbs.twimg.com"));
+
+  EXPECT_FALSE(hosts->Matches("net"));
+  EXPECT_FALSE(hosts->Matches("notfbcdn.net"));
+  EXPECT_FALSE(hosts->Matches("fbcdn.net.evil.com"));
+  EXPECT_FALSE(hosts->Matches(""));
+}
+
+TEST(ThirdPartyHostsTest, EmptyList) {
+  scoped_refptr<ThirdPartyHosts> hosts = ThirdPartyHosts::Parse("");
+  EXPECT_EQ(0u, hosts->size());
+  EXPECT_FALSE(hosts->Matches("example.com"));
+}
+
+TEST(ThirdPartyHostIndexTest, FindInserted) {
+  scoped_refptr<ThirdPartyHostIndex> index(new ThirdPartyHostIndex(4));
+
+  scoped_refptr<ThirdPartyHosts> hosts;
+  EXPECT_FALSE(index->Find("www.example.com", &hosts));
+  index->Insert("www.example.com",
+                ThirdPartyHosts::Parse("cdn0.example.net,cdn1.example.net"));
+
+  ASSERT_TRUE(index->Find("www.example.com", &hosts));
+  EXPECT_TRUE(hosts->Matches("img.cdn0.example.net"));
+  EXPECT_TRUE(hosts->Matches("cdn1.example.net"));
+  EXPECT_FALSE(hosts->Matches("cdn2.example.net"));
+  EXPECT_FALSE(index->Find("example.com", &hosts));
+}
+
+TEST(ThirdPartyHostIndexTest, NegativeEntriesAndBound) {
+  scoped_refptr<ThirdPartyHostIndex> index(new ThirdPartyHostIndex(4));
+  index->Insert("no-list.com", nullptr);
+
+  scoped_refptr<ThirdPartyHosts> hosts = ThirdPartyHosts::Parse("a.com");
+  EXPECT_TRUE(index->Find("no-list.com", &hosts));
+  EXPECT_FALSE(hosts);
+
+  for (int i = 0; i < 10; ++i)
+    index->Insert(base::IntToString(i) + ".com", nullptr);
+  EXPECT_EQ(4u, index->size());
+  EXPECT_FALSE(index->Find("no-list.com", &hosts));
+}
+
+}  // namespace brave_shields
@@ -5,10 +5,42 @@
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 
 namespace brave_sync {
 
+namespace {
+
+// Reads the next non-empty component of |order| at or after |*pos|, with the
+// same trimming and checks as OrderToIntVect. Returns false at the end.
+bool NextOrderComponent(const std::string& order, size_t* pos, int* value) {
+  while (*pos < order.size()) {
+    size_t begin = *pos;
+    size_t end = order.find('.', begin);
+    if (end == std::string::npos)
+      end = order.size();
+    *pos = end + 1;
+
+    while (begin < end && base::IsAsciiWhitespace(order[begin]))
+      ++begin;
+    while (end > begin && base::IsAsciiWhitespace(order[end - 1]))
+      --end;
+    if (begin == end)
+      continue;
+
+    bool b = base::StringToInt(
+        base::StringPiece(order.data() + begin, end - begin), value);
+    CHECK(b);
+    CHECK(*value >= 0);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 std::vector<int> OrderToIntVect(const std::string& s) {
   std::vector<std::string> vec_s = SplitString(
       s,
@@ -29,12 +61,22 @@ std::vector<int> OrderToIntVect(const std::string& s) {
 
 bool CompareOrder(const std::string& left, const std::string& right) {
   // Return: true if left <  right
-  // Split each and use C++ stdlib
-  std::vector<int> vec_left = OrderToIntVect(left);
-  std::vector<int> vec_right = OrderToIntVect(right);
-
-  return std::lexicographical_compare(vec_left.begin(), vec_left.end(),
-    vec_right.begin(), vec_right.end());
+  // Same as comparing the OrderToIntVect results, but walks both strings in
+  // place since this runs for every probe of a sibling search
+  size_t left_pos = 0;
+  size_t right_pos = 0;
+  int left_value = 0;
+  int right_value = 0;
+  while (true) {
+    bool has_left = NextOrderComponent(left, &left_pos, &left_value);
+    bool has_right = NextOrderComponent(right, &right_pos, &right_value);
+    if (!has_right)
+      return false;
+    if (!has_left)
+      return true;
+    if (left_value != right_value)
+      return left_value < right_value;
+  }
 }
 
 } // namespace brave_sync
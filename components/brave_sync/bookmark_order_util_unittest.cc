@@ -4,6 +4,10 @@
 
 #include "brave/components/brave_sync/bookmark_order_util.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_sync {
@@ -60,4 +64,20 @@ TEST_F(BookmarkOrderUtilTest, CompareOrder) {
   EXPECT_FALSE(CompareOrder("1.7.0.2", "1.7.0.1"));
 }
 
+TEST_F(BookmarkOrderUtilTest, CompareOrder_SameAsIntVect) {
+  const std::vector<std::string> orders = {"", "..", ".5.", "1", "1.",
+      "1.1", "1..1", " 1 . 2 ", "1.2", "2", "11", "1.7.0.1", "1.7.1",
+      "2.234.1", "63.17.1.45.2"};
+  for (const auto& left : orders) {
+    for (const auto& right : orders) {
+      std::vector<int> vec_left = OrderToIntVect(left);
+      std::vector<int> vec_right = OrderToIntVect(right);
+      EXPECT_EQ(CompareOrder(left, right),
+                std::lexicographical_compare(vec_left.begin(), vec_left.end(),
+                    vec_right.begin(), vec_right.end()))
+          << "left=" << left << " right=" << right;
+    }
+  }
+}
+
 } // namespace brave_sync
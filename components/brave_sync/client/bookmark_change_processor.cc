@@ -5,9 +5,11 @@
 
 #include "brave/components/brave_sync/client/bookmark_change_processor.h"
 
+#include <algorithm>
 #include <string>
 #include <tuple>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -31,21 +33,6 @@ using bookmarks::BookmarkModel;
 
 namespace {
 
-class ScopedPauseObserver {
- public:
-  explicit ScopedPauseObserver(brave_sync::BookmarkChangeProcessor* processor) :
-      processor_(processor) {
-    DCHECK_NE(processor_, nullptr);
-    processor_->Stop();
-  }
-  ~ScopedPauseObserver() {
-    processor_->Start();
-  }
-
- private:
-  brave_sync::BookmarkChangeProcessor* processor_;  // Not owned
-};
-
 const char kDeletedBookmarksTitle[] = "Deleted Bookmarks";
 const char kPendingBookmarksTitle[] = "Pending Bookmarks";
 
@@ -132,8 +119,9 @@ void GetPrevObjectId(const bookmarks::BookmarkNode* parent,
     prev_node->GetMetaInfo("object_id", prev_object_id);
 }
 
-const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
-                                        const std::string& object_id) {
+const bookmarks::BookmarkNode* FindByObjectIdSlow(
+    bookmarks::BookmarkModel* model,
+    const std::string& object_id) {
   ui::TreeNodeIterator<const bookmarks::BookmarkNode>
       iterator(model->root_node());
   while (iterator.has_next()) {
@@ -147,21 +135,37 @@ const bookmarks::BookmarkNode* FindByObjectId(bookmarks::BookmarkModel* model,
   return nullptr;
 }
 
+// Index of the first child at or after |index| which has an order, or
+// child_count() if there is none
+int GetNextOrderedChild(const bookmarks::BookmarkNode* parent,
+                        int index,
+                        std::string* order) {
+  for (; index < parent->child_count(); ++index) {
+    if (parent->GetChild(index)->GetMetaInfo("order", order) &&
+        !order->empty())
+      return index;
+  }
+  return index;
+}
+
 uint64_t GetIndexByOrder(const bookmarks::BookmarkNode* root_node,
                   const std::string& record_order) {
-  int index = 0;
-  while (index < root_node->child_count()) {
-    const bookmarks::BookmarkNode* node = root_node->GetChild(index);
-    std::string node_order;
-    node->GetMetaInfo("order", &node_order);
-
-    if (!node_order.empty() &&
+  // Children with an order are sorted by it, the ones not synced yet have
+  // none and are stepped over. Binary search for the first ordered child
+  // which goes after |record_order|.
+  std::string node_order;
+  int low = 0;
+  int high = root_node->child_count();
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    int ordered = GetNextOrderedChild(root_node, middle, &node_order);
+    if (ordered == root_node->child_count() ||
         brave_sync::CompareOrder(record_order, node_order))
-      return index;
-
-    ++index;
+      high = middle;
+    else
+      low = ordered + 1;
   }
-  return index;
+  return GetNextOrderedChild(root_node, low, &node_order);
 }
 
 uint64_t GetIndex(const bookmarks::BookmarkNode* root_node,
@@ -169,6 +173,42 @@ uint64_t GetIndex(const bookmarks::BookmarkNode* root_node,
   return GetIndexByOrder(root_node, record.order);
 }
 
+bool IsUnsynced(const bookmarks::BookmarkNode* node) {
+  std::string sync_timestamp;
+  node->GetMetaInfo("sync_timestamp", &sync_timestamp);
+
+  if (sync_timestamp.empty())
+    return true;
+
+  std::string last_updated_time;
+  node->GetMetaInfo("last_updated_time", &last_updated_time);
+
+  return !last_updated_time.empty() &&
+      base::Time::FromJsTime(std::stod(last_updated_time)) >
+      base::Time::FromJsTime(std::stod(sync_timestamp));
+}
+
+// Child indices from the root down to |node|, for sorting nodes in tree
+// order. |indices| caches the children of every parent seen so far, so
+// large folders are only scanned once.
+std::vector<int> GetTreePath(
+    const bookmarks::BookmarkNode* node,
+    std::unordered_map<const bookmarks::BookmarkNode*, int>* indices) {
+  std::vector<int> path;
+  for (; node->parent(); node = node->parent()) {
+    auto it = indices->find(node);
+    if (it == indices->end()) {
+      const bookmarks::BookmarkNode* parent = node->parent();
+      for (int i = 0; i < parent->child_count(); ++i)
+        (*indices)[parent->GetChild(i)] = i;
+      it = indices->find(node);
+    }
+    path.push_back(it->second);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
 // this should only be called for resolved records we get from the server
 void UpdateNode(bookmarks::BookmarkModel* model,
                 const bookmarks::BookmarkNode* node,
@@ -204,35 +244,31 @@ void UpdateNode(bookmarks::BookmarkModel* model,
   }
 }
 
-const bookmarks::BookmarkNode* FindParent(bookmarks::BookmarkModel* model,
-                                          const jslib::Bookmark& bookmark,
-                                          bookmarks::BookmarkNode*
-                                                            pending_node_root) {
-  auto* parent_node = FindByObjectId(model, bookmark.parentFolderObjectId);
+}  // namespace
 
-  if (!parent_node) {
-    if (!bookmark.parentFolderObjectId.empty()) {
-      return pending_node_root;
-    }
-    if (
-        // this flag is a bit odd, but if the node doesn't have a parent and
-        // hideInToolbar is false, then this bookmark should go in the
-        // toolbar root. We don't care about this flag for records with
-        // a parent id because they will be inserted into the correct
-        // parent folder
-        !bookmark.hideInToolbar ||
-        // mobile generated bookmarks go also in bookmark bar
-        (!bookmark.order.empty() && bookmark.order.at(0) == '2')) {
-      parent_node = model->bookmark_bar_node();
-    } else {
-      parent_node = model->other_node();
+// Detaches the processor from the model while sync records are applied, so
+// the changes are not echoed back as local ones. The object id index stays
+// valid because ApplyChangesFromSyncModel maintains it itself.
+class BookmarkChangeProcessor::ScopedPauseObserver {
+ public:
+  explicit ScopedPauseObserver(BookmarkChangeProcessor* processor) :
+      processor_(processor) {
+    DCHECK_NE(processor_, nullptr);
+    processor_->bookmark_model_->RemoveObserver(processor_);
+    if (!processor_->observing_) {
+      // Nothing was tracked while stopped
+      processor_->ClearObjectIdIndex();
+      processor_->ClearUnsyncedNodes();
+      processor_->observing_ = true;
     }
   }
+  ~ScopedPauseObserver() {
+    processor_->bookmark_model_->AddObserver(processor_);
+  }
 
-  return parent_node;
-}
-
-}  // namespace
+ private:
+  BookmarkChangeProcessor* processor_;  // Not owned
+};
 
 // static
 BookmarkChangeProcessor* BookmarkChangeProcessor::Create(
@@ -252,7 +288,10 @@ BookmarkChangeProcessor::BookmarkChangeProcessor(
       bookmark_model_(BookmarkModelFactory::GetForBrowserContext(
           Profile::FromBrowserContext(profile))),
       deleted_node_root_(nullptr),
-      pending_node_root_(nullptr) {
+      pending_node_root_(nullptr),
+      observing_(false),
+      object_id_index_built_(false),
+      unsynced_nodes_built_(false) {
   DCHECK(sync_client_);
   DCHECK(sync_prefs);
   DCHECK(bookmark_model_);
@@ -264,11 +303,187 @@ BookmarkChangeProcessor::~BookmarkChangeProcessor() {
 
 void BookmarkChangeProcessor::Start() {
   bookmark_model_->AddObserver(this);
+  observing_ = true;
 }
 
 void BookmarkChangeProcessor::Stop() {
   if (bookmark_model_)
     bookmark_model_->RemoveObserver(this);
+  observing_ = false;
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
+}
+
+void BookmarkChangeProcessor::BuildObjectIdIndex() {
+  object_id_index_.clear();
+  object_id_index_built_ = true;
+  // Pre-order, so the first node wins for a duplicated object id just like
+  // it does for a tree walk
+  AddSubtreeToObjectIdIndex(bookmark_model_->root_node());
+}
+
+void BookmarkChangeProcessor::ClearObjectIdIndex() {
+  object_id_index_.clear();
+  object_id_index_built_ = false;
+}
+
+void BookmarkChangeProcessor::AddToObjectIdIndex(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_built_)
+    return;
+  std::string object_id;
+  if (node->GetMetaInfo("object_id", &object_id) && !object_id.empty())
+    object_id_index_.emplace(object_id, node);
+}
+
+void BookmarkChangeProcessor::AddSubtreeToObjectIdIndex(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_built_)
+    return;
+  AddToObjectIdIndex(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    AddToObjectIdIndex(iterator.Next());
+}
+
+void BookmarkChangeProcessor::RemoveSubtreeFromObjectIdIndex(
+    const bookmarks::BookmarkNode* node) {
+  if (!object_id_index_built_)
+    return;
+  auto remove = [this](const bookmarks::BookmarkNode* node) {
+    std::string object_id;
+    node->GetMetaInfo("object_id", &object_id);
+    auto it = object_id_index_.find(object_id);
+    // Only drop the entry when it points at this node, a duplicate may still
+    // be alive elsewhere
+    if (it != object_id_index_.end() && it->second == node)
+      object_id_index_.erase(it);
+  };
+  remove(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    remove(iterator.Next());
+}
+
+void BookmarkChangeProcessor::BuildUnsyncedNodes() {
+  unsynced_nodes_.clear();
+  unsynced_nodes_built_ = true;
+
+  auto* deleted_node = GetDeletedNodeRoot();
+  CHECK(deleted_node);
+  std::vector<const bookmarks::BookmarkNode*> root_nodes = {
+    bookmark_model_->other_node(),
+    bookmark_model_->bookmark_bar_node(),
+    deleted_node
+  };
+
+  for (const auto* root_node : root_nodes) {
+    ui::TreeNodeIterator<const bookmarks::BookmarkNode>
+        iterator(root_node);
+    while (iterator.has_next()) {
+      const bookmarks::BookmarkNode* node = iterator.Next();
+      if (!IsUnsynced(node))
+        continue;
+
+      // The send time is persisted, so a restart doesn't resend everything
+      // which is still waiting for the server
+      base::Time last_send_time;
+      std::string last_send_time_meta;
+      if (node->GetMetaInfo("last_send_time", &last_send_time_meta) &&
+          !last_send_time_meta.empty())
+        last_send_time =
+            base::Time::FromJsTime(std::stod(last_send_time_meta));
+      unsynced_nodes_[node] = last_send_time;
+    }
+  }
+}
+
+void BookmarkChangeProcessor::ClearUnsyncedNodes() {
+  unsynced_nodes_.clear();
+  unsynced_nodes_built_ = false;
+}
+
+void BookmarkChangeProcessor::MarkUnsynced(
+    const bookmarks::BookmarkNode* node) {
+  if (!unsynced_nodes_built_ || node->is_permanent_node())
+    return;
+  // A new change is sent right away
+  unsynced_nodes_[node] = base::Time();
+}
+
+void BookmarkChangeProcessor::MarkSubtreeUnsynced(
+    const bookmarks::BookmarkNode* node) {
+  if (!unsynced_nodes_built_)
+    return;
+  if (IsUnsynced(node))
+    MarkUnsynced(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next()) {
+    const bookmarks::BookmarkNode* child = iterator.Next();
+    if (IsUnsynced(child))
+      MarkUnsynced(child);
+  }
+}
+
+void BookmarkChangeProcessor::RemoveSubtreeFromUnsyncedNodes(
+    const bookmarks::BookmarkNode* node) {
+  if (!unsynced_nodes_built_)
+    return;
+  unsynced_nodes_.erase(node);
+  ui::TreeNodeIterator<const bookmarks::BookmarkNode> iterator(node);
+  while (iterator.has_next())
+    unsynced_nodes_.erase(iterator.Next());
+}
+
+const bookmarks::BookmarkNode* BookmarkChangeProcessor::FindByObjectId(
+    const std::string& object_id) {
+  if (object_id.empty())
+    return nullptr;
+  // Nothing keeps the index in step with the model while stopped
+  if (!observing_)
+    return FindByObjectIdSlow(bookmark_model_, object_id);
+
+  if (!object_id_index_built_)
+    BuildObjectIdIndex();
+  auto it = object_id_index_.find(object_id);
+  if (it == object_id_index_.end())
+    return nullptr;
+
+  std::string node_object_id;
+  it->second->GetMetaInfo("object_id", &node_object_id);
+  if (node_object_id == object_id)
+    return it->second;
+
+  // A stale entry left behind when the node got another object id
+  BuildObjectIdIndex();
+  it = object_id_index_.find(object_id);
+  return it != object_id_index_.end() ? it->second : nullptr;
+}
+
+const bookmarks::BookmarkNode* BookmarkChangeProcessor::FindParent(
+    const jslib::Bookmark& bookmark) {
+  auto* parent_node = FindByObjectId(bookmark.parentFolderObjectId);
+
+  if (!parent_node) {
+    if (!bookmark.parentFolderObjectId.empty()) {
+      return GetPendingNodeRoot();
+    }
+    if (
+        // this flag is a bit odd, but if the node doesn't have a parent and
+        // hideInToolbar is false, then this bookmark should go in the
+        // toolbar root. We don't care about this flag for records with
+        // a parent id because they will be inserted into the correct
+        // parent folder
+        !bookmark.hideInToolbar ||
+        // mobile generated bookmarks go also in bookmark bar
+        (!bookmark.order.empty() && bookmark.order.at(0) == '2')) {
+      parent_node = bookmark_model_->bookmark_bar_node();
+    } else {
+      parent_node = bookmark_model_->other_node();
+    }
+  }
+
+  return parent_node;
 }
 
 void BookmarkChangeProcessor::BookmarkModelLoaded(BookmarkModel* model,
@@ -280,12 +495,17 @@ void BookmarkChangeProcessor::BookmarkModelLoaded(BookmarkModel* model,
 void BookmarkChangeProcessor::BookmarkModelBeingDeleted(
     bookmarks::BookmarkModel* model) {
   NOTREACHED();
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
   bookmark_model_ = nullptr;
 }
 
 void BookmarkChangeProcessor::BookmarkNodeAdded(BookmarkModel* model,
                                                 const BookmarkNode* parent,
                                                 int index) {
+  // Undo and paste bring their meta info, object id included
+  AddSubtreeToObjectIdIndex(parent->GetChild(index));
+  MarkSubtreeUnsynced(parent->GetChild(index));
 }
 
 void BookmarkChangeProcessor::OnWillRemoveBookmarks(BookmarkModel* model,
@@ -321,6 +541,7 @@ void BookmarkChangeProcessor::CloneBookmarkNodeForDeleteImpl(
 
   auto* cloned_node_ptr = cloned_node.get();
   parent->Add(std::move(cloned_node), index);
+  AddToObjectIdIndex(cloned_node_ptr);
   // we call `Changed` here because we don't want to update the order
   BookmarkNodeChanged(bookmark_model_, cloned_node_ptr);
 }
@@ -344,6 +565,9 @@ void BookmarkChangeProcessor::BookmarkNodeRemoved(
   // TODO(bridiver) - should this be in OnWillRemoveBookmarks?
   // copy into the deleted node tree without firing any events
 
+  RemoveSubtreeFromObjectIdIndex(node);
+  RemoveSubtreeFromUnsyncedNodes(node);
+
   // The node which has not yet been sent, should not be cloned into removed.
   std::string node_object_id;
   node->GetMetaInfo("object_id", &node_object_id);
@@ -363,6 +587,8 @@ void BookmarkChangeProcessor::BookmarkAllUserNodesRemoved(
     const std::set<GURL>& removed_urls) {
   // this only happens on profile deletion and we don't want
   // to wipe out the remote store when that happens
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
 }
 
 void BookmarkChangeProcessor::BookmarkNodeChanged(BookmarkModel* model,
@@ -375,11 +601,13 @@ void BookmarkChangeProcessor::BookmarkNodeChanged(BookmarkModel* model,
   model->SetNodeMetaInfo(node,
       "last_updated_time",
       std::to_string(base::Time::Now().ToJsTime()));
+  MarkUnsynced(node);
 }
 
 void BookmarkChangeProcessor::BookmarkMetaInfoChanged(
     BookmarkModel* model, const BookmarkNode* node) {
-  // Ignore metadata changes.
+  // Ignore metadata changes, apart from keeping the object id index current.
+  AddToObjectIdIndex(node);
   // These are:
   // Brave managed: "object_id", "order", "sync_timestamp",
   //      "last_send_time", "last_updated_time"
@@ -446,6 +674,8 @@ void BookmarkChangeProcessor::Reset(bool clear_meta_info) {
   CHECK(pending_node);
   pending_node->DeleteAll();
   bookmark_model_->EndExtensiveChanges();
+  ClearObjectIdIndex();
+  ClearUnsyncedNodes();
 }
 
 void BookmarkChangeProcessor::DeleteSelfAndChildren(
@@ -461,47 +691,36 @@ void BookmarkChangeProcessor::DeleteSelfAndChildren(
   bookmark_model_->Remove(node);
 }
 
-void ValidateFolderOrders(const bookmarks::BookmarkNode* folder_node) {
-  DCHECK(folder_node);
-
-  // Validate direct children order
-  std::string left_order;
-  std::string right_order;
-  for (auto i = 0; i < folder_node->child_count(); ++i) {
-    const auto* node = folder_node->GetChild(i);
-    std::string order;
-    node->GetMetaInfo("order", &order);
-    if (order.empty()) {
-      continue;
-    }
+// Checks |node| against its closest ordered siblings, which is all an
+// insertion can break
+void ValidateNodeOrder(const bookmarks::BookmarkNode* node) {
+  DCHECK(node);
 
-    if (left_order.empty()) {
-      left_order = order;
-      continue;
-    }
-
-    if (right_order.empty()) {
-      right_order = order;
-    } else {
-      left_order = right_order;
-      right_order = order;
-    }
+  std::string order;
+  if (!node->GetMetaInfo("order", &order) || order.empty())
+    return;
 
-    DCHECK(!left_order.empty());
-    DCHECK(!right_order.empty());
-
-    bool compare_result = CompareOrder(left_order, right_order);
-    if (!compare_result) {
-      DLOG(ERROR) << "ValidateFolderOrders failed";
-      DLOG(ERROR) << "folder_node=" << folder_node->GetTitle();
-      DLOG(ERROR) << "folder_node->child_count()=" <<
-                                                  folder_node->child_count();
-      DLOG(ERROR) << "i=" << i;
-      DLOG(ERROR) << "left_order=" << left_order;
-      DLOG(ERROR) << "right_order=" << right_order;
-      DLOG(ERROR) << "Unexpected situation of invalid order";
-      return;
-    }
+  const bookmarks::BookmarkNode* parent = node->parent();
+  int index = parent->GetIndexOf(node);
+  std::string prev_order;
+  for (int i = index - 1; i >= 0; --i) {
+    if (parent->GetChild(i)->GetMetaInfo("order", &prev_order) &&
+        !prev_order.empty())
+      break;
+  }
+  std::string next_order;
+  GetNextOrderedChild(parent, index + 1, &next_order);
+
+  if ((!prev_order.empty() && !CompareOrder(prev_order, order)) ||
+      (!next_order.empty() && !CompareOrder(order, next_order))) {
+    DLOG(ERROR) << "ValidateNodeOrder failed";
+    DLOG(ERROR) << "folder_node=" << parent->GetTitle();
+    DLOG(ERROR) << "folder_node->child_count()=" << parent->child_count();
+    DLOG(ERROR) << "i=" << index;
+    DLOG(ERROR) << "prev_order=" << prev_order;
+    DLOG(ERROR) << "order=" << order;
+    DLOG(ERROR) << "next_order=" << next_order;
+    DLOG(ERROR) << "Unexpected situation of invalid order";
   }
 }
 
@@ -513,7 +732,7 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
     DCHECK(sync_record->has_bookmark());
     DCHECK(!sync_record->objectId.empty());
 
-    auto* node = FindByObjectId(bookmark_model_, sync_record->objectId);
+    auto* node = FindByObjectId(sync_record->objectId);
     auto bookmark_record = sync_record->GetBookmark();
 
     if (node && sync_record->action == jslib::SyncRecord::Action::A_UPDATE) {
@@ -528,8 +747,7 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
 
       const bookmarks::BookmarkNode* new_parent_node = nullptr;
       if (bookmark_record.parentFolderObjectId != old_parent_object_id) {
-        new_parent_node = FindParent(bookmark_model_, bookmark_record,
-            GetPendingNodeRoot());
+        new_parent_node = FindParent(bookmark_record);
       }
 
       if (new_parent_node) {
@@ -546,8 +764,12 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
         }
       }
       UpdateNode(bookmark_model_, node, sync_record.get());
+      if (!IsUnsynced(node))
+        unsynced_nodes_.erase(node);
     } else if (node &&
                sync_record->action == jslib::SyncRecord::Action::A_DELETE) {
+      RemoveSubtreeFromObjectIdIndex(node);
+      RemoveSubtreeFromUnsyncedNodes(node);
       if (node->parent() == GetDeletedNodeRoot()) {
         // this is a deleted node so remove without firing events
         int index = GetDeletedNodeRoot()->GetIndexOf(node);
@@ -565,8 +787,7 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
       const bookmarks::BookmarkNode* parent_node = nullptr;
       if (!node) {
         // TODO(bridiver) make sure there isn't an existing record for objectId
-        parent_node =
-            FindParent(bookmark_model_, bookmark_record, GetPendingNodeRoot());
+        parent_node = FindParent(bookmark_record);
 
         const BookmarkNode* bookmark_bar = bookmark_model_->bookmark_bar_node();
         bool bookmark_bar_was_empty = bookmark_bar->empty();
@@ -589,10 +810,13 @@ void BookmarkChangeProcessor::ApplyChangesFromSyncModel(
       }
       UpdateNode(bookmark_model_, node, sync_record.get(),
           GetPendingNodeRoot());
+      AddToObjectIdIndex(node);
+      if (!IsUnsynced(node))
+        unsynced_nodes_.erase(node);
 
 #ifndef NDEBUG
       if (parent_node) {
-        ValidateFolderOrders(parent_node);
+        ValidateNodeOrder(node);
       }
 #endif
 
@@ -647,7 +871,7 @@ void BookmarkChangeProcessor::CompletePendingNodesMove(
     // of "Pending Bookmarks" note.
     node->DeleteMetaInfo("parent_object_id");
 #ifndef NDEBUG
-    ValidateFolderOrders(created_folder_node);
+    ValidateNodeOrder(node);
 #endif
   }
 }
@@ -722,6 +946,7 @@ BookmarkChangeProcessor::BookmarkNodeToSyncBookmark(
     record->objectId = tools::GenerateObjectId();
     record->action = jslib::SyncRecord::Action::A_CREATE;
     bookmark_model_->SetNodeMetaInfo(node, "object_id", record->objectId);
+    AddToObjectIdIndex(node);
   } else if (node->HasAncestor(deleted_node)) {
     record->action = jslib::SyncRecord::Action::A_DELETE;
   } else {
@@ -734,28 +959,13 @@ BookmarkChangeProcessor::BookmarkNodeToSyncBookmark(
   return record;
 }
 
-bool IsUnsynced(const bookmarks::BookmarkNode* node) {
-  std::string sync_timestamp;
-  node->GetMetaInfo("sync_timestamp", &sync_timestamp);
-
-  if (sync_timestamp.empty())
-    return true;
-
-  std::string last_updated_time;
-  node->GetMetaInfo("last_updated_time", &last_updated_time);
-
-  return !last_updated_time.empty() &&
-      base::Time::FromJsTime(std::stod(last_updated_time)) >
-      base::Time::FromJsTime(std::stod(sync_timestamp));
-}
-
 void BookmarkChangeProcessor::GetAllSyncData(
     const std::vector<std::unique_ptr<jslib::SyncRecord>>& records,
     SyncRecordAndExistingList* records_and_existing_objects) {
   for (const auto& record : records) {
     auto resolved_record = std::make_unique<SyncRecordAndExisting>();
     resolved_record->first = jslib::SyncRecord::Clone(*record);
-    auto* node = FindByObjectId(bookmark_model_, record->objectId);
+    auto* node = FindByObjectId(record->objectId);
     if (node) {
       resolved_record->second = BookmarkNodeToSyncBookmark(node);
     }
@@ -802,47 +1012,55 @@ bookmarks::BookmarkNode* BookmarkChangeProcessor::GetPendingNodeRoot() {
 
 void BookmarkChangeProcessor::SendUnsynced(
     base::TimeDelta unsynced_send_interval) {
-  std::vector<std::unique_ptr<jslib::SyncRecord>> records;
+  // Nothing kept |unsynced_nodes_| current while stopped
+  if (!observing_)
+    ClearUnsyncedNodes();
+  if (!unsynced_nodes_built_)
+    BuildUnsyncedNodes();
 
   auto* deleted_node = GetDeletedNodeRoot();
   CHECK(deleted_node);
-  std::vector<const bookmarks::BookmarkNode*> root_nodes = {
-    bookmark_model_->other_node(),
-    bookmark_model_->bookmark_bar_node(),
-    deleted_node
-  };
-
-  for (const auto* root_node : root_nodes) {
-    ui::TreeNodeIterator<const bookmarks::BookmarkNode>
-        iterator(root_node);
-    while (iterator.has_next()) {
-      const bookmarks::BookmarkNode* node = iterator.Next();
-
-      // only send unsynced records
-      if (!IsUnsynced(node))
-        continue;
-
-      std::string last_send_time;
-      node->GetMetaInfo("last_send_time", &last_send_time);
-      if (!last_send_time.empty() &&
-          // don't send more often than unsynced_send_interval_
-          (base::Time::Now() -
-              base::Time::FromJsTime(std::stod(last_send_time))) <
-          unsynced_send_interval)
-        continue;
+  const base::Time now = base::Time::Now();
+
+  // Sent in tree order, so parents and previous siblings get their object id
+  // before the records referring to them are made
+  std::vector<std::pair<std::vector<int>, const bookmarks::BookmarkNode*>>
+      due_nodes;
+  std::unordered_map<const bookmarks::BookmarkNode*, int> indices;
+  for (auto it = unsynced_nodes_.begin(); it != unsynced_nodes_.end();) {
+    const bookmarks::BookmarkNode* node = it->first;
+    if (!IsUnsynced(node) ||
+        !(node->HasAncestor(bookmark_model_->other_node()) ||
+          node->HasAncestor(bookmark_model_->bookmark_bar_node()) ||
+          node->HasAncestor(deleted_node))) {
+      it = unsynced_nodes_.erase(it);
+      continue;
+    }
+    // don't send more often than unsynced_send_interval_
+    if (it->second.is_null() || now - it->second >= unsynced_send_interval)
+      due_nodes.push_back(std::make_pair(GetTreePath(node, &indices), node));
+    ++it;
+  }
+  std::sort(due_nodes.begin(), due_nodes.end());
 
+  std::vector<std::unique_ptr<jslib::SyncRecord>> records;
+  for (const auto& due_node : due_nodes) {
+    const bookmarks::BookmarkNode* node = due_node.second;
+    auto record = BookmarkNodeToSyncBookmark(node);
+    if (record) {
+      unsynced_nodes_[node] = now;
       bookmark_model_->SetNodeMetaInfo(node,
-          "last_send_time", std::to_string(base::Time::Now().ToJsTime()));
-
-      auto record = BookmarkNodeToSyncBookmark(node);
-      if (record)
-        records.push_back(std::move(record));
+          "last_send_time", std::to_string(now.ToJsTime()));
+      records.push_back(std::move(record));
+    } else {
+      // Nothing to send until it changes again
+      unsynced_nodes_.erase(node);
+    }
 
-      if (records.size() == 1000) {
-        sync_client_->SendSyncRecords(
-            jslib_const::SyncRecordType_BOOKMARKS, records);
-        records.clear();
-      }
+    if (records.size() == 1000) {
+      sync_client_->SendSyncRecords(
+          jslib_const::SyncRecordType_BOOKMARKS, records);
+      records.clear();
     }
   }
   if (!records.empty()) {
@@ -851,6 +1069,9 @@ void BookmarkChangeProcessor::SendUnsynced(
     records.clear();
   }
   sync_client_->ClearOrderMap();
+
+  if (!observing_)
+    ClearUnsyncedNodes();
 }
 
 void BookmarkChangeProcessor::InitialSync() {}
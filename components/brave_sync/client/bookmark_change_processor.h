@@ -5,7 +5,11 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARKS_BOOKMARK_CHANGE_PROCESSOR_H_
 #define BRAVE_COMPONENTS_BRAVE_SYNC_CLIENT_BOOKMARKS_BOOKMARK_CHANGE_PROCESSOR_H_
 
+#include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -18,11 +22,17 @@
 #include "components/bookmarks/browser/bookmark_node_data.h"
 
 FORWARD_DECLARE_TEST(BraveBookmarkChangeProcessorTest, IgnoreRapidCreateDelete);
+FORWARD_DECLARE_TEST(BraveBookmarkChangeProcessorTest,
+                     SendUnsyncedLargeProfile);
 
 class BraveBookmarkChangeProcessorTest;
 
 namespace brave_sync {
 
+namespace jslib {
+class Bookmark;
+}
+
 class BookmarkChangeProcessor : public ChangeProcessor,
                                        bookmarks::BookmarkModelObserver  {
  public:
@@ -47,6 +57,10 @@ class BookmarkChangeProcessor : public ChangeProcessor,
   friend class ::BraveBookmarkChangeProcessorTest;
   FRIEND_TEST_ALL_PREFIXES(::BraveBookmarkChangeProcessorTest,
                                                        IgnoreRapidCreateDelete);
+  FRIEND_TEST_ALL_PREFIXES(::BraveBookmarkChangeProcessorTest,
+                                                      SendUnsyncedLargeProfile);
+
+  class ScopedPauseObserver;
 
   BookmarkChangeProcessor(Profile* profile,
                           BraveSyncClient* sync_client,
@@ -105,6 +119,30 @@ class BookmarkChangeProcessor : public ChangeProcessor,
       const bookmarks::BookmarkNode* created_folder_node,
       const std::string& created_folder_object_id);
 
+  // Looks up the node carrying |object_id| in its meta info, including the
+  // nodes under the deleted and pending roots.
+  const bookmarks::BookmarkNode* FindByObjectId(const std::string& object_id);
+  const bookmarks::BookmarkNode* FindParent(const jslib::Bookmark& bookmark);
+
+  // |object_id_index_| is kept in step with the model from the observer
+  // callbacks and from the changes made while applying sync records. It is
+  // dropped whenever that is not possible and rebuilt on the next lookup.
+  void BuildObjectIdIndex();
+  void ClearObjectIdIndex();
+  void AddToObjectIdIndex(const bookmarks::BookmarkNode* node);
+  void AddSubtreeToObjectIdIndex(const bookmarks::BookmarkNode* node);
+  void RemoveSubtreeFromObjectIdIndex(const bookmarks::BookmarkNode* node);
+
+  // |unsynced_nodes_| is fed by the same callbacks, so SendUnsynced only
+  // looks at nodes which changed. It is rebuilt from the persisted
+  // "sync_timestamp", "last_updated_time" and "last_send_time" meta info
+  // when dropped.
+  void BuildUnsyncedNodes();
+  void ClearUnsyncedNodes();
+  void MarkUnsynced(const bookmarks::BookmarkNode* node);
+  void MarkSubtreeUnsynced(const bookmarks::BookmarkNode* node);
+  void RemoveSubtreeFromUnsyncedNodes(const bookmarks::BookmarkNode* node);
+
   BraveSyncClient* sync_client_;  // not owned
   prefs::Prefs* sync_prefs_;  // not owned
   Profile* profile_; // not owned
@@ -113,6 +151,17 @@ class BookmarkChangeProcessor : public ChangeProcessor,
   bookmarks::BookmarkNode* deleted_node_root_;
   bookmarks::BookmarkNode* pending_node_root_;
 
+  // True while the model is observed, either directly or through a
+  // ScopedPauseObserver; the index can only be trusted in that state.
+  bool observing_;
+  bool object_id_index_built_;
+  std::unordered_map<std::string, const bookmarks::BookmarkNode*>
+      object_id_index_;
+  // Node to the time it was last sent, null if it was not sent yet
+  bool unsynced_nodes_built_;
+  std::unordered_map<const bookmarks::BookmarkNode*, base::Time>
+      unsynced_nodes_;
+
   DISALLOW_COPY_AND_ASSIGN(BookmarkChangeProcessor);
 };
 
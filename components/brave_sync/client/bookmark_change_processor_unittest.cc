@@ -891,6 +891,114 @@ TEST_F(BraveBookmarkChangeProcessorTest, GetAllSyncData) {
   EXPECT_EQ(pair_at_2->second.get(), nullptr);
 }
 
+TEST_F(BraveBookmarkChangeProcessorTest, GetAllSyncDataLargeProfile) {
+  // A sync batch against a big profile, resolved through the object id index
+  // rather than a tree walk per record
+  change_processor()->Start();
+
+  const int kFolders = 200;
+  const int kBookmarksPerFolder = 100;
+  std::vector<const BookmarkNode*> folders;
+  for (int f = 0; f < kFolders; ++f) {
+    const auto* folder = model()->AddFolder(model()->other_node(), f,
+        base::ASCIIToUTF16("Folder" + std::to_string(f)));
+    model()->SetNodeMetaInfo(folder, "object_id",
+                             "folder-" + std::to_string(f));
+    for (int b = 0; b < kBookmarksPerFolder; ++b) {
+      const std::string suffix = std::to_string(f) + "-" + std::to_string(b);
+      const auto* node = model()->AddURL(folder, b,
+          base::ASCIIToUTF16("title-" + suffix),
+          GURL("https://" + suffix + ".com/"));
+      model()->SetNodeMetaInfo(node, "object_id", "bookmark-" + suffix);
+    }
+    folders.push_back(folder);
+  }
+
+  RecordsList records_to_resolve;
+  for (int i = 0; i < 1000; ++i) {
+    const std::string suffix = std::to_string((i * 7) % kFolders) + "-" +
+        std::to_string(i % kBookmarksPerFolder);
+    records_to_resolve.push_back(SimpleBookmarkSyncRecord(
+        SyncRecord::Action::A_UPDATE,
+        "bookmark-" + suffix,
+        "https://" + suffix + ".com/",
+        "title-" + suffix + " - modified",
+        "", ""));
+  }
+
+  brave_sync::SyncRecordAndExistingList records_and_existing_objects;
+  change_processor()->GetAllSyncData(records_to_resolve,
+                                     &records_and_existing_objects);
+  ASSERT_EQ(records_and_existing_objects.size(), records_to_resolve.size());
+  for (const auto& pair : records_and_existing_objects) {
+    ASSERT_NE(pair->second.get(), nullptr);
+    EXPECT_EQ(pair->first->objectId, pair->second->objectId);
+    EXPECT_EQ(pair->first->GetBookmark().site.location,
+              pair->second->GetBookmark().site.location);
+  }
+
+  // Parents of incoming records are resolved the same way
+  RecordsList records;
+  for (int i = 0; i < 1000; ++i) {
+    records.push_back(SimpleBookmarkSyncRecord(
+        SyncRecord::Action::A_CREATE,
+        "created-" + std::to_string(i),
+        "https://created-" + std::to_string(i) + ".com/",
+        "Created - title",
+        "1.1.1." + std::to_string(i + 1),
+        "folder-" + std::to_string(i % kFolders)));
+  }
+  change_processor()->ApplyChangesFromSyncModel(records);
+
+  EXPECT_TRUE(GetPendingNodeRoot()->empty());
+  for (const auto* folder : folders) {
+    EXPECT_EQ(folder->child_count(), kBookmarksPerFolder + 1000 / kFolders);
+  }
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, ObjectIdIndexFollowsModel) {
+  change_processor()->Start();
+
+  auto resolve = [this](const std::string& object_id) {
+    RecordsList records;
+    records.push_back(SimpleBookmarkSyncRecord(
+        SyncRecord::Action::A_UPDATE, object_id, "https://a.com/",
+        "A.com - title", "", ""));
+    brave_sync::SyncRecordAndExistingList records_and_existing_objects;
+    change_processor()->GetAllSyncData(records,
+                                       &records_and_existing_objects);
+    EXPECT_EQ(records_and_existing_objects.size(), 1u);
+    return std::move(records_and_existing_objects.at(0)->second);
+  };
+
+  const auto* node_a = model()->AddURL(model()->other_node(), 0,
+                                       base::ASCIIToUTF16("A.com - title"),
+                                       GURL("https://a.com/"));
+  model()->SetNodeMetaInfo(node_a, "object_id", "a");
+  auto existing = resolve("a");
+  ASSERT_NE(existing.get(), nullptr);
+  EXPECT_EQ(existing->action, SyncRecord::Action::A_UPDATE);
+
+  // The object id moves over to the clone under the deleted node root
+  model()->Remove(node_a);
+  existing = resolve("a");
+  ASSERT_NE(existing.get(), nullptr);
+  EXPECT_EQ(existing->action, SyncRecord::Action::A_DELETE);
+
+  const auto* node_b = model()->AddURL(model()->other_node(), 0,
+                                       base::ASCIIToUTF16("B.com - title"),
+                                       GURL("https://b.com/"));
+  model()->SetNodeMetaInfo(node_b, "object_id", "b1");
+  EXPECT_NE(resolve("b1").get(), nullptr);
+  model()->SetNodeMetaInfo(node_b, "object_id", "b2");
+  EXPECT_EQ(resolve("b1").get(), nullptr);
+  EXPECT_NE(resolve("b2").get(), nullptr);
+
+  change_processor()->Reset(true);
+  EXPECT_EQ(resolve("a").get(), nullptr);
+  EXPECT_EQ(resolve("b2").get(), nullptr);
+}
+
 TEST_F(BraveBookmarkChangeProcessorTest, TitleCustomTitle) {
   // Should be able to create folder when title = "" and customTitle != ""
   // Create these:
@@ -1340,3 +1448,100 @@ TEST_F(BraveBookmarkChangeProcessorTest, IgnoreMetadataSet) {
   EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
   change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
 }
+
+TEST_F(BraveBookmarkChangeProcessorTest, SendUnsyncedKeepsSendTime) {
+  change_processor()->Start();
+
+  const auto* node_a = model()->AddURL(model()->other_node(), 0,
+                                       base::ASCIIToUTF16("A.com - title"),
+                                       GURL("https://a.com/"));
+
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+  std::string last_send_time;
+  EXPECT_TRUE(node_a->GetMetaInfo("last_send_time", &last_send_time));
+  testing::Mock::VerifyAndClearExpectations(sync_client());
+
+  // Like a restart, the unsynced nodes are rebuilt from the meta info
+  change_processor()->Stop();
+  change_processor()->Start();
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, SendUnsyncedLargeProfile) {
+  change_processor()->Start();
+
+  const int kFolders = 20;
+  const int kBookmarksPerFolder = 1000;
+  const BookmarkNode* node = nullptr;
+  for (int f = 0; f < kFolders; ++f) {
+    const auto* folder = model()->AddFolder(model()->other_node(), f,
+        base::ASCIIToUTF16("Folder" + std::to_string(f)));
+    for (int b = 0; b < kBookmarksPerFolder; ++b) {
+      const std::string suffix = std::to_string(f) + "-" + std::to_string(b);
+      node = model()->AddURL(folder, b, base::ASCIIToUTF16("title-" + suffix),
+                             GURL("https://" + suffix + ".com/"));
+    }
+  }
+
+  RecordsList sent_records;
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _))
+      .Times(AtLeast(1))
+      .WillRepeatedly(testing::Invoke(
+          [&sent_records](const std::string& category_name,
+                          const RecordsList& records) {
+            for (const auto& record : records)
+              sent_records.push_back(SyncRecord::Clone(*record));
+          }));
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+  EXPECT_EQ(sent_records.size(),
+            static_cast<size_t>(kFolders + kFolders * kBookmarksPerFolder));
+  testing::Mock::VerifyAndClearExpectations(sync_client());
+
+  // The server echoes the records back, which marks them as synced
+  for (auto& record : sent_records) {
+    record->syncTimestamp =
+        base::Time::Now() - base::TimeDelta::FromMinutes(1);
+  }
+  change_processor()->ApplyChangesFromSyncModel(sent_records);
+  EXPECT_TRUE(change_processor()->unsynced_nodes_.empty());
+
+  // An idle tick has nothing to look at
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS", _)).Times(0);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(0));
+  testing::Mock::VerifyAndClearExpectations(sync_client());
+
+  model()->SetTitle(node, base::ASCIIToUTF16("title - modified"));
+  EXPECT_EQ(change_processor()->unsynced_nodes_.size(), 1u);
+  EXPECT_CALL(*sync_client(), SendSyncRecords("BOOKMARKS",
+      RecordsNumber(1))).Times(1);
+  change_processor()->SendUnsynced(base::TimeDelta::FromMinutes(10));
+}
+
+TEST_F(BraveBookmarkChangeProcessorTest, ApplyManyOrderedIntoOneFolder) {
+  // Records for one folder applied out of order end up sorted by their order
+  change_processor()->Start();
+
+  const int kRecords = 10;
+  RecordsList records;
+  for (int i = 0; i < kRecords; ++i) {
+    // 7 is coprime with kRecords, so this visits every position once
+    const int position = (i * 7) % kRecords + 1;
+    records.push_back(SimpleBookmarkSyncRecord(
+        SyncRecord::Action::A_CREATE,
+        "",
+        "https://" + std::to_string(position) + ".com/",
+        std::to_string(position),
+        "1.1.1." + std::to_string(position),
+        ""));
+  }
+  change_processor()->ApplyChangesFromSyncModel(records);
+
+  const BookmarkNode* folder = model()->other_node();
+  ASSERT_EQ(folder->child_count(), kRecords);
+  for (int i = 0; i < kRecords; ++i) {
+    EXPECT_EQ(base::UTF16ToUTF8(folder->GetChild(i)->GetTitle()),
+              std::to_string(i + 1));
+  }
+}
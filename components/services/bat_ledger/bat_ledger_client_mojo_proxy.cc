@@ -4,9 +4,14 @@
 
 #include "brave/components/services/bat_ledger/bat_ledger_client_mojo_proxy.h"
 
+#include <limits>
 #include <string>
 
 #include "base/logging.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/trace_event/trace_event.h"
+#include "brave/components/services/bat_ledger/public/cpp/ledger_type_converters.h"
 #include "mojo/public/cpp/bindings/map.h"
 
 namespace bat_ledger {
@@ -69,26 +74,23 @@ class LogStreamImpl : public ledger::LogStream {
 } // anonymous namespace
 
 BatLedgerClientMojoProxy::BatLedgerClientMojoProxy(
-    mojom::BatLedgerClientAssociatedPtrInfo client_info) {
+    mojom::BatLedgerClientAssociatedPtrInfo client_info,
+    TimerCallback on_timer)
+    : on_timer_(std::move(on_timer)),
+      next_timer_id_(0) {
   bat_ledger_client_.Bind(std::move(client_info));
 }
 
 BatLedgerClientMojoProxy::~BatLedgerClientMojoProxy() {
 }
 
-std::string BatLedgerClientMojoProxy::GenerateGUID() const {
-  if (!Connected())
-    return "";
-
-  std::string guid;
-  bat_ledger_client_->GenerateGUID(&guid);
-  return guid;
-}
-
 void OnLoadURL(const ledger::LoadURLCallback& callback,
-    bool success, const std::string& response,
+    bool success, mojo_base::BigBuffer response,
     const base::flat_map<std::string, std::string>& headers) {
-  callback(success, response, mojo::FlatMapToMap(headers));
+  // The ledger keeps the response, so this is the one copy out of the
+  // buffer.
+  callback(success, AsStringPiece(response).as_string(),
+           mojo::FlatMapToMap(headers));
 }
 
 void BatLedgerClientMojoProxy::LoadURL(
@@ -219,14 +221,16 @@ void BatLedgerClientMojoProxy::LoadPublisherState(
 
 void BatLedgerClientMojoProxy::OnLoadPublisherList(
     ledger::LedgerCallbackHandler* handler,
-    int32_t result, const std::string& data) {
-  handler->OnPublisherListLoaded(ToLedgerResult(result), data);
+    int32_t result, mojo_base::BigBuffer data) {
+  base::StringPiece list = AsStringPiece(data);
+  handler->OnPublisherListLoaded(ToLedgerResult(result), list.data(),
+                                 list.size());
 }
 
 void BatLedgerClientMojoProxy::LoadPublisherList(
     ledger::LedgerCallbackHandler* handler) {
   if (!Connected()) {
-    handler->OnPublisherListLoaded(ledger::Result::LEDGER_ERROR, "");
+    handler->OnPublisherListLoaded(ledger::Result::LEDGER_ERROR, "", 0);
     return;
   }
 
@@ -286,19 +290,16 @@ void BatLedgerClientMojoProxy::SavePublishersList(
     return;
   }
 
-  bat_ledger_client_->SavePublishersList(publishers_list,
+  bat_ledger_client_->SavePublishersList(ToBigBuffer(publishers_list),
       base::BindOnce(&BatLedgerClientMojoProxy::OnSavePublishersList,
         AsWeakPtr(), base::Unretained(handler)));
 }
 
 void OnSavePublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result, mojom::PublisherInfoPtr publisher_info) {
+  TRACE_EVENT0("brave", "BatLedgerClientMojoProxy::OnSavePublisherInfo");
+  callback(ToLedgerResult(result),
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>());
 }
 
 void BatLedgerClientMojoProxy::SavePublisherInfo(
@@ -310,19 +311,16 @@ void BatLedgerClientMojoProxy::SavePublisherInfo(
     return;
   }
 
-  std::string json_info = publisher_info ? publisher_info->ToJson() : "";
-  bat_ledger_client_->SavePublisherInfo(json_info,
+  bat_ledger_client_->SavePublisherInfo(
+      mojom::PublisherInfo::From(publisher_info),
       base::BindOnce(&OnSavePublisherInfo, std::move(callback)));
 }
 
 void OnLoadPublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result, mojom::PublisherInfoPtr publisher_info) {
+  TRACE_EVENT0("brave", "BatLedgerClientMojoProxy::OnLoadPublisherInfo");
+  callback(ToLedgerResult(result),
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>());
 }
 
 void BatLedgerClientMojoProxy::LoadPublisherInfo(
@@ -339,15 +337,9 @@ void BatLedgerClientMojoProxy::LoadPublisherInfo(
 }
 
 void OnLoadPanelPublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result, mojom::PublisherInfoPtr publisher_info) {
+  callback(ToLedgerResult(result),
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>());
 }
 
 void BatLedgerClientMojoProxy::LoadPanelPublisherInfo(
@@ -359,18 +351,16 @@ void BatLedgerClientMojoProxy::LoadPanelPublisherInfo(
     return;
   }
 
-  bat_ledger_client_->LoadPanelPublisherInfo(filter.ToJson(),
+  bat_ledger_client_->LoadPanelPublisherInfo(
+      mojom::ActivityInfoFilter::From(filter),
       base::BindOnce(&OnLoadPanelPublisherInfo, std::move(callback)));
 }
 
 void OnLoadMediaPublisherInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result, mojom::PublisherInfoPtr publisher_info) {
+  TRACE_EVENT0("brave", "BatLedgerClientMojoProxy::OnLoadMediaPublisherInfo");
+  callback(ToLedgerResult(result),
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>());
 }
 
 void BatLedgerClientMojoProxy::LoadMediaPublisherInfo(
@@ -388,11 +378,23 @@ void BatLedgerClientMojoProxy::LoadMediaPublisherInfo(
 
 void BatLedgerClientMojoProxy::SetTimer(uint64_t time_offset,
     uint32_t& timer_id) {
-  if (!Connected()) {
-    return;
-  }
+  if (next_timer_id_ == std::numeric_limits<uint32_t>::max())
+    next_timer_id_ = 1;
+  else
+    ++next_timer_id_;
+
+  timer_id = next_timer_id_;
 
-  bat_ledger_client_->SetTimer(time_offset, &timer_id); // sync
+  timers_[next_timer_id_] = std::make_unique<base::OneShotTimer>();
+  timers_[next_timer_id_]->Start(FROM_HERE,
+      base::TimeDelta::FromSeconds(time_offset),
+      base::BindOnce(
+          &BatLedgerClientMojoProxy::OnTimer, AsWeakPtr(), next_timer_id_));
+}
+
+void BatLedgerClientMojoProxy::OnTimer(uint32_t timer_id) {
+  timers_.erase(timer_id);
+  on_timer_.Run(timer_id);
 }
 
 void BatLedgerClientMojoProxy::OnExcludedSitesChanged(
@@ -411,9 +413,8 @@ void BatLedgerClientMojoProxy::OnPanelPublisherInfo(ledger::Result result,
     return;
   }
 
-  std::string json_info = info ? info->ToJson() : "";
   bat_ledger_client_->OnPanelPublisherInfo(ToMojomResult(result),
-      json_info, windowId);
+      mojom::PublisherInfo::From(info), windowId);
 }
 
 void OnFetchFavIcon(const ledger::FetchIconCallback& callback,
@@ -434,17 +435,10 @@ void BatLedgerClientMojoProxy::FetchFavIcon(const std::string& url,
 }
 
 void OnGetRecurringDonations(const ledger::PublisherInfoListCallback& callback,
-    const std::vector<std::string>& publisher_info_list,
+    std::vector<mojom::PublisherInfoPtr> publisher_info_list,
     uint32_t next_record) {
-  ledger::PublisherInfoList list;
-
-  for (const auto& publisher_info : publisher_info_list) {
-    ledger::PublisherInfo info;
-    info.loadFromJson(publisher_info);
-    list.push_back(info);
-  }
-
-  callback(list, next_record);
+  callback(mojo::ConvertTo<ledger::PublisherInfoList>(publisher_info_list),
+      next_record);
 }
 
 void BatLedgerClientMojoProxy::GetRecurringDonations(
@@ -534,15 +528,6 @@ void BatLedgerClientMojoProxy::GetGrantCaptcha() {
   bat_ledger_client_->GetGrantCaptcha();
 }
 
-std::string BatLedgerClientMojoProxy::URIEncode(const std::string& value) {
-  if (!Connected())
-    return "";
-
-  std::string encoded_value;
-  bat_ledger_client_->URIEncode(value, &encoded_value);
-  return encoded_value;
-}
-
 void BatLedgerClientMojoProxy::SetContributionAutoInclude(
   const std::string& publisher_key, bool excluded, uint64_t windowId) {
   if (!Connected())
@@ -561,13 +546,10 @@ void BatLedgerClientMojoProxy::SavePendingContribution(
 }
 
 void OnLoadActivityInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result, mojom::PublisherInfoPtr publisher_info) {
+  TRACE_EVENT0("brave", "BatLedgerClientMojoProxy::OnLoadActivityInfo");
+  callback(ToLedgerResult(result),
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>());
 }
 
 void BatLedgerClientMojoProxy::LoadActivityInfo(
@@ -579,18 +561,16 @@ void BatLedgerClientMojoProxy::LoadActivityInfo(
     return;
   }
 
-  bat_ledger_client_->LoadActivityInfo(filter.ToJson(),
+  bat_ledger_client_->LoadActivityInfo(
+      mojom::ActivityInfoFilter::From(filter),
       base::BindOnce(&OnLoadActivityInfo, std::move(callback)));
 }
 
 void OnSaveActivityInfo(const ledger::PublisherInfoCallback& callback,
-    int32_t result, const std::string& publisher_info) {
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-  callback(ToLedgerResult(result), std::move(info));
+    int32_t result, mojom::PublisherInfoPtr publisher_info) {
+  TRACE_EVENT0("brave", "BatLedgerClientMojoProxy::OnSaveActivityInfo");
+  callback(ToLedgerResult(result),
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>());
 }
 
 void BatLedgerClientMojoProxy::SaveActivityInfo(
@@ -602,8 +582,8 @@ void BatLedgerClientMojoProxy::SaveActivityInfo(
     return;
   }
 
-  std::string json_info = publisher_info ? publisher_info->ToJson() : "";
-  bat_ledger_client_->SaveActivityInfo(json_info,
+  bat_ledger_client_->SaveActivityInfo(
+      mojom::PublisherInfo::From(publisher_info),
       base::BindOnce(&OnSaveActivityInfo, std::move(callback)));
 }
 
@@ -624,17 +604,11 @@ void BatLedgerClientMojoProxy::OnRestorePublishers(
 }
 
 void OnGetActivityInfoList(const ledger::PublisherInfoListCallback& callback,
-    const std::vector<std::string>& publisher_info_list,
+    std::vector<mojom::PublisherInfoPtr> publisher_info_list,
     uint32_t next_record) {
-  ledger::PublisherInfoList list;
-
-  for (const auto& publisher_info : publisher_info_list) {
-    ledger::PublisherInfo info;
-    info.loadFromJson(publisher_info);
-    list.push_back(info);
-  }
-
-  callback(list, next_record);
+  TRACE_EVENT0("brave", "BatLedgerClientMojoProxy::OnGetActivityInfoList");
+  callback(mojo::ConvertTo<ledger::PublisherInfoList>(publisher_info_list),
+      next_record);
 }
 
 void BatLedgerClientMojoProxy::GetActivityInfoList(uint32_t start,
@@ -648,7 +622,7 @@ void BatLedgerClientMojoProxy::GetActivityInfoList(uint32_t start,
 
   bat_ledger_client_->GetActivityInfoList(start,
       limit,
-      filter.ToJson(),
+      mojom::ActivityInfoFilter::From(filter),
       base::BindOnce(&OnGetActivityInfoList, std::move(callback)));
 }
 
@@ -660,7 +634,9 @@ void BatLedgerClientMojoProxy::SaveNormalizedPublisherList(
     return;
   }
 
-  bat_ledger_client_->SaveNormalizedPublisherList(normalized_list.ToJson());
+  bat_ledger_client_->SaveNormalizedPublisherList(
+      mojo::ConvertTo<std::vector<mojom::PublisherInfoPtr>>(
+          normalized_list.list));
 }
 
 bool BatLedgerClientMojoProxy::Connected() const {
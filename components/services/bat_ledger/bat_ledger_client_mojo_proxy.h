@@ -6,24 +6,33 @@
 #define BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_BAT_LEDGER_CLIENT_MOJO_PROXY_H_
 
 #include <map>
+#include <memory>
 
+#include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "bat/ledger/ledger_client.h"
 #include "brave/components/services/bat_ledger/public/interfaces/bat_ledger.mojom.h"
 #include "chrome/browser/bitmap_fetcher/bitmap_fetcher_service.h"
 
+namespace base {
+class OneShotTimer;
+}
+
 class SkBitmap;
 
 namespace bat_ledger {
 
-class BatLedgerClientMojoProxy : public ledger::LedgerClient,
+class BatLedgerClientMojoProxy : public ledger::LedgerHostClient,
                       public base::SupportsWeakPtr<BatLedgerClientMojoProxy> {
  public:
+  using TimerCallback = base::RepeatingCallback<void(uint32_t timer_id)>;
+
+  // |on_timer| is run with the id of each timer the ledger set once it fires.
   BatLedgerClientMojoProxy(
-      mojom::BatLedgerClientAssociatedPtrInfo client_info);
+      mojom::BatLedgerClientAssociatedPtrInfo client_info,
+      TimerCallback on_timer);
   ~BatLedgerClientMojoProxy() override;
 
-  std::string GenerateGUID() const override;
   void OnWalletInitialized(ledger::Result result) override;
   void OnWalletProperties(ledger::Result result,
                           std::unique_ptr<ledger::WalletInfo> info) override;
@@ -92,8 +101,6 @@ class BatLedgerClientMojoProxy : public ledger::LedgerClient,
   void FetchGrant(const std::string& lang, const std::string& paymentId) override;
   void GetGrantCaptcha() override;
 
-  std::string URIEncode(const std::string& value) override;
-
   void SetContributionAutoInclude(const std::string& publisher_key,
       bool excluded, uint64_t windowId) override;
 
@@ -125,12 +132,20 @@ class BatLedgerClientMojoProxy : public ledger::LedgerClient,
 
   mojom::BatLedgerClientAssociatedPtr bat_ledger_client_;
 
+  // The ledger's timers run here rather than in the browser, so setting one
+  // is not a round trip to the UI thread.
+  void OnTimer(uint32_t timer_id);
+
+  TimerCallback on_timer_;
+  std::map<uint32_t, std::unique_ptr<base::OneShotTimer>> timers_;
+  uint32_t next_timer_id_;
+
   void OnLoadLedgerState(ledger::LedgerCallbackHandler* handler,
       int32_t result, const std::string& data);
   void OnLoadPublisherState(ledger::LedgerCallbackHandler* handler,
       int32_t result, const std::string& data);
   void OnLoadPublisherList(ledger::LedgerCallbackHandler* handler,
-      int32_t result, const std::string& data);
+      int32_t result, mojo_base::BigBuffer data);
   void OnSaveLedgerState(ledger::LedgerCallbackHandler* handler,
       int32_t result);
   void OnSavePublisherState(ledger::LedgerCallbackHandler* handler,
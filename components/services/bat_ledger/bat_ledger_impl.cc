@@ -4,8 +4,11 @@
 
 #include "brave/components/services/bat_ledger/bat_ledger_impl.h"
 
+#include "base/bind.h"
 #include "base/containers/flat_map.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/components/services/bat_ledger/bat_ledger_client_mojo_proxy.h"
+#include "brave/components/services/bat_ledger/public/cpp/ledger_type_converters.h"
 #include "mojo/public/cpp/bindings/map.h"
 
 using namespace std::placeholders;
@@ -35,7 +38,9 @@ ledger::REWARDS_CATEGORY ToLedgerPublisherCategory(int32_t category) {
 BatLedgerImpl::BatLedgerImpl(
     mojom::BatLedgerClientAssociatedPtrInfo client_info)
   : bat_ledger_client_mojo_proxy_(
-      new BatLedgerClientMojoProxy(std::move(client_info))),
+      new BatLedgerClientMojoProxy(std::move(client_info),
+          base::BindRepeating(&BatLedgerImpl::OnTimer,
+                              base::Unretained(this)))),
     ledger_(
       ledger::Ledger::CreateInstance(bat_ledger_client_mojo_proxy_.get())) {
 }
@@ -91,22 +96,24 @@ void BatLedgerImpl::GetReconcileStamp(GetReconcileStampCallback callback) {
   std::move(callback).Run(ledger_->GetReconcileStamp());
 }
 
-void BatLedgerImpl::OnLoad(const std::string& visit_data,
+void BatLedgerImpl::OnLoad(mojom::VisitDataPtr visit_data,
     uint64_t current_time) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->OnLoad(visitData, current_time);
+  TRACE_EVENT0("brave", "BatLedgerImpl::OnLoad");
+  ledger_->OnLoad(visit_data.To<ledger::VisitData>(), current_time);
 }
 
 void BatLedgerImpl::OnUnload(uint32_t tab_id, uint64_t current_time) {
+  TRACE_EVENT0("brave", "BatLedgerImpl::OnUnload");
   ledger_->OnUnload(tab_id, current_time);
 }
 
 void BatLedgerImpl::OnShow(uint32_t tab_id, uint64_t current_time) {
+  TRACE_EVENT0("brave", "BatLedgerImpl::OnShow");
   ledger_->OnShow(tab_id, current_time);
 }
 
 void BatLedgerImpl::OnHide(uint32_t tab_id, uint64_t current_time) {
+  TRACE_EVENT0("brave", "BatLedgerImpl::OnHide");
   ledger_->OnHide(tab_id, current_time);
 }
 
@@ -128,20 +135,19 @@ void BatLedgerImpl::OnMediaStop(uint32_t tab_id, uint64_t current_time) {
 
 void BatLedgerImpl::OnPostData(const std::string& url,
     const std::string& first_party_url, const std::string& referrer,
-    const std::string& post_data, const std::string& visit_data) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->OnPostData(url, first_party_url, referrer, post_data, visitData);
+    const std::string& post_data, mojom::VisitDataPtr visit_data) {
+  TRACE_EVENT0("brave", "BatLedgerImpl::OnPostData");
+  ledger_->OnPostData(url, first_party_url, referrer, post_data,
+      visit_data.To<ledger::VisitData>());
 }
 
 void BatLedgerImpl::OnXHRLoad(uint32_t tab_id, const std::string& url,
     const base::flat_map<std::string, std::string>& parts,
     const std::string& first_party_url, const std::string& referrer,
-    const std::string& visit_data) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->OnXHRLoad(tab_id, url, mojo::FlatMapToMap(parts),
-        first_party_url, referrer, visitData);
+    mojom::VisitDataPtr visit_data) {
+  TRACE_EVENT0("brave", "BatLedgerImpl::OnXHRLoad");
+  ledger_->OnXHRLoad(tab_id, url, mojo::FlatMapToMap(parts),
+      first_party_url, referrer, visit_data.To<ledger::VisitData>());
 }
 
 void BatLedgerImpl::SetPublisherExclude(const std::string& publisher_key,
@@ -245,10 +251,6 @@ void BatLedgerImpl::SetAutoContribute(bool enabled) {
   ledger_->SetAutoContribute(enabled);
 }
 
-void BatLedgerImpl::OnTimer(uint32_t timer_id) {
-  ledger_->OnTimer(timer_id);
-}
-
 void BatLedgerImpl::GetAllBalanceReports(
     GetAllBalanceReportsCallback callback) {
   auto reports = ledger_->GetAllBalanceReports();
@@ -273,11 +275,10 @@ void BatLedgerImpl::IsWalletCreated(IsWalletCreatedCallback callback) {
 
 void BatLedgerImpl::GetPublisherActivityFromUrl(
     uint64_t window_id,
-    const std::string& visit_data,
+    mojom::VisitDataPtr visit_data,
     const std::string& publisher_blob) {
-  ledger::VisitData visitData;
-  if (visitData.loadFromJson(visit_data))
-    ledger_->GetPublisherActivityFromUrl(window_id, visitData, publisher_blob);
+  ledger_->GetPublisherActivityFromUrl(window_id,
+      visit_data.To<ledger::VisitData>(), publisher_blob);
 }
 
 // static
@@ -304,11 +305,10 @@ void BatLedgerImpl::GetContributionAmount(
   std::move(callback).Run(ledger_->GetContributionAmount());
 }
 
-void BatLedgerImpl::DoDirectDonation(const std::string& publisher_info,
+void BatLedgerImpl::DoDirectDonation(mojom::PublisherInfoPtr publisher_info,
     int32_t amount, const std::string& currency) {
-  ledger::PublisherInfo info;
-  if (info.loadFromJson(publisher_info))
-    ledger_->DoDirectDonation(info, amount, currency);
+  ledger_->DoDirectDonation(publisher_info.To<ledger::PublisherInfo>(),
+      amount, currency);
 }
 
 void BatLedgerImpl::RemoveRecurring(const std::string& publisher_key) {
@@ -353,4 +353,8 @@ void BatLedgerImpl::GetAddressesForPaymentId(
       std::bind(BatLedgerImpl::OnAddressesForPaymentId, holder, _1));
 }
 
+void BatLedgerImpl::OnTimer(uint32_t timer_id) {
+  ledger_->OnTimer(timer_id);
+}
+
 } // namespace bat_ledger
@@ -40,7 +40,8 @@ class BatLedgerImpl : public mojom::BatLedger,
     void GetAutoContribute(GetAutoContributeCallback callback) override;
     void GetReconcileStamp(GetReconcileStampCallback callback) override;
 
-    void OnLoad(const std::string& visit_data, uint64_t current_time) override;
+    void OnLoad(mojom::VisitDataPtr visit_data,
+        uint64_t current_time) override;
     void OnUnload(uint32_t tab_id, uint64_t current_time) override;
     void OnShow(uint32_t tab_id, uint64_t current_time) override;
     void OnHide(uint32_t tab_id, uint64_t current_time) override;
@@ -51,11 +52,12 @@ class BatLedgerImpl : public mojom::BatLedger,
 
     void OnPostData(const std::string& url,
         const std::string& first_party_url, const std::string& referrer,
-        const std::string& post_data, const std::string& visit_data) override;
+        const std::string& post_data,
+        mojom::VisitDataPtr visit_data) override;
     void OnXHRLoad(uint32_t tab_id, const std::string& url,
         const base::flat_map<std::string, std::string>& parts,
         const std::string& first_party_url, const std::string& referrer,
-        const std::string& visit_data) override;
+        mojom::VisitDataPtr visit_data) override;
 
     void SetPublisherExclude(const std::string& publisher_key,
         int32_t exclude) override;
@@ -91,8 +93,6 @@ class BatLedgerImpl : public mojom::BatLedger,
     void SetContributionAmount(double amount) override;
     void SetAutoContribute(bool enabled) override;
 
-    void OnTimer(uint32_t timer_id) override;
-
     void GetAllBalanceReports(GetAllBalanceReportsCallback callback) override;
     void GetBalanceReport(int32_t month, int32_t year,
         GetBalanceReportCallback callback) override;
@@ -101,7 +101,7 @@ class BatLedgerImpl : public mojom::BatLedger,
 
     void GetPublisherActivityFromUrl(
         uint64_t window_id,
-        const std::string& visit_data,
+        mojom::VisitDataPtr visit_data,
         const std::string& publisher_blob) override;
 
     void GetContributionAmount(
@@ -109,7 +109,8 @@ class BatLedgerImpl : public mojom::BatLedger,
     void GetPublisherBanner(const std::string& publisher_id,
         GetPublisherBannerCallback callback) override;
 
-    void DoDirectDonation(const std::string& publisher_info, int32_t amount,
+    void DoDirectDonation(mojom::PublisherInfoPtr publisher_info,
+        int32_t amount,
         const std::string& currency) override;
 
     void RemoveRecurring(const std::string& publisher_key) override;
@@ -150,6 +151,8 @@ class BatLedgerImpl : public mojom::BatLedger,
         CallbackHolder<GetAddressesForPaymentIdCallback>* holder,
         std::map<std::string, std::string> addresses);
 
+    void OnTimer(uint32_t timer_id);
+
     std::unique_ptr<BatLedgerClientMojoProxy> bat_ledger_client_mojo_proxy_;
     std::unique_ptr<ledger::Ledger> ledger_;
 
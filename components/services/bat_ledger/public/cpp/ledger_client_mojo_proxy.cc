@@ -5,6 +5,7 @@
 #include "brave/components/services/bat_ledger/public/cpp/ledger_client_mojo_proxy.h"
 
 #include "base/logging.h"
+#include "brave/components/services/bat_ledger/public/cpp/ledger_type_converters.h"
 #include "mojo/public/cpp/bindings/map.h"
 
 using namespace std::placeholders;
@@ -66,10 +67,6 @@ void LedgerClientMojoProxy::LoadLedgerState(LoadLedgerStateCallback callback) {
   ledger_client_->LoadLedgerState(holder);
 }
 
-void LedgerClientMojoProxy::GenerateGUID(GenerateGUIDCallback callback) {
-  std::move(callback).Run(ledger_client_->GenerateGUID());
-}
-
 void LedgerClientMojoProxy::OnWalletInitialized(int32_t result) {
   ledger_client_->OnWalletInitialized(ToLedgerResult(result));
 }
@@ -116,16 +113,18 @@ void LedgerClientMojoProxy::LoadPublisherList(
 
 template <typename Callback>
 void LedgerClientMojoProxy::CallbackHolder<Callback>::OnPublisherListLoaded(
-    ledger::Result result, const std::string& data) {
+    ledger::Result result, const char* data, size_t size) {
   NOTREACHED();
 }
 
 template <>
 void LedgerClientMojoProxy::CallbackHolder<
   LedgerClientMojoProxy::LoadPublisherListCallback>::OnPublisherListLoaded(
-    ledger::Result result, const std::string& data) {
-  if (is_valid())
-    std::move(callback_).Run(ToMojomResult(result), data);
+    ledger::Result result, const char* data, size_t size) {
+  if (is_valid()) {
+    std::move(callback_).Run(ToMojomResult(result),
+        ToBigBuffer(base::StringPiece(data, size)));
+  }
   delete this;
 }
 
@@ -174,10 +173,12 @@ void LedgerClientMojoProxy::CallbackHolder<
 }
 
 void LedgerClientMojoProxy::SavePublishersList(
-    const std::string& publishers_list, SavePublishersListCallback callback) {
+    mojo_base::BigBuffer publishers_list,
+    SavePublishersListCallback callback) {
   auto* holder = new CallbackHolder<SavePublishersListCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger_client_->SavePublishersList(publishers_list, holder);
+  ledger_client_->SavePublishersList(
+      AsStringPiece(publishers_list).as_string(), holder);
 }
 
 template <typename Callback>
@@ -233,25 +234,20 @@ void LedgerClientMojoProxy::OnSavePublisherInfo(
     CallbackHolder<SavePublisherInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
   if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+    std::move(holder->get()).Run(ToMojomResult(result),
+        mojom::PublisherInfo::From(info));
   delete holder;
 }
 
 void LedgerClientMojoProxy::SavePublisherInfo(
-    const std::string& publisher_info,
+    mojom::PublisherInfoPtr publisher_info,
     SavePublisherInfoCallback callback) {
   // deleted in OnSavePublisherInfo
   auto* holder = new CallbackHolder<SavePublisherInfoCallback>(
       AsWeakPtr(), std::move(callback));
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-
-  ledger_client_->SavePublisherInfo(std::move(info),
+  ledger_client_->SavePublisherInfo(
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>(),
       std::bind(LedgerClientMojoProxy::OnSavePublisherInfo, holder, _1, _2));
 }
 
@@ -260,9 +256,9 @@ void LedgerClientMojoProxy::OnLoadPublisherInfo(
     CallbackHolder<LoadPublisherInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
   if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+    std::move(holder->get()).Run(ToMojomResult(result),
+        mojom::PublisherInfo::From(info));
   delete holder;
 }
 
@@ -280,20 +276,20 @@ void LedgerClientMojoProxy::LoadPublisherInfo(
 void LedgerClientMojoProxy::OnLoadPanelPublisherInfo(
     CallbackHolder<LoadPanelPublisherInfoCallback>* holder,
     ledger::Result result, std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
   if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+    std::move(holder->get()).Run(ToMojomResult(result),
+        mojom::PublisherInfo::From(info));
   delete holder;
 }
 
-void LedgerClientMojoProxy::LoadPanelPublisherInfo(const std::string& filter,
+void LedgerClientMojoProxy::LoadPanelPublisherInfo(
+    mojom::ActivityInfoFilterPtr filter,
     LoadPanelPublisherInfoCallback callback) {
   // deleted in OnLoadPanelPublisherInfo
   auto* holder = new CallbackHolder<LoadPanelPublisherInfoCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger::ActivityInfoFilter publisher_info_filter;
-  publisher_info_filter.loadFromJson(filter);
-  ledger_client_->LoadPanelPublisherInfo(publisher_info_filter,
+  ledger_client_->LoadPanelPublisherInfo(
+      filter.To<ledger::ActivityInfoFilter>(),
       std::bind(LedgerClientMojoProxy::OnLoadPanelPublisherInfo,
         holder, _1, _2));
 }
@@ -303,9 +299,9 @@ void LedgerClientMojoProxy::OnLoadMediaPublisherInfo(
     CallbackHolder<LoadMediaPublisherInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
   if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+    std::move(holder->get()).Run(ToMojomResult(result),
+        mojom::PublisherInfo::From(info));
   delete holder;
 }
 
@@ -319,27 +315,15 @@ void LedgerClientMojoProxy::LoadMediaPublisherInfo(
       std::bind(LedgerClientMojoProxy::OnLoadMediaPublisherInfo, holder, _1, _2));
 }
 
-void LedgerClientMojoProxy::SetTimer(uint64_t time_offset,
-    SetTimerCallback callback) {
-  uint32_t timer_id;
-  ledger_client_->SetTimer(time_offset, timer_id);
-  std::move(callback).Run(timer_id);
-}
-
 void LedgerClientMojoProxy::OnExcludedSitesChanged(
     const std::string& publisher_id) {
   ledger_client_->OnExcludedSitesChanged(publisher_id);
 }
 
 void LedgerClientMojoProxy::OnPanelPublisherInfo(int32_t result,
-    const std::string& info, uint64_t window_id) {
-  std::unique_ptr<ledger::PublisherInfo> publisher_info;
-  if (!info.empty()) {
-    publisher_info.reset(new ledger::PublisherInfo());
-    publisher_info->loadFromJson(info);
-  }
+    mojom::PublisherInfoPtr info, uint64_t window_id) {
   ledger_client_->OnPanelPublisherInfo(ToLedgerResult(result),
-      std::move(publisher_info), window_id);
+      info.To<std::unique_ptr<ledger::PublisherInfo>>(), window_id);
 }
 
 // static
@@ -365,13 +349,12 @@ void LedgerClientMojoProxy::OnGetRecurringDonations(
     CallbackHolder<GetRecurringDonationsCallback>* holder,
     const ledger::PublisherInfoList& publisher_info_list,
     uint32_t next_record) {
-  std::vector<std::string> list;
-  for (const auto& publisher_info : publisher_info_list) {
-    list.push_back(publisher_info.ToJson());
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(
+        mojo::ConvertTo<std::vector<mojom::PublisherInfoPtr>>(
+            publisher_info_list),
+        next_record);
   }
-
-  if (holder->is_valid())
-    std::move(holder->get()).Run(list, next_record);
   delete holder;
 }
 
@@ -446,11 +429,6 @@ void LedgerClientMojoProxy::GetGrantCaptcha() {
   ledger_client_->GetGrantCaptcha();
 }
 
-void LedgerClientMojoProxy::URIEncode(const std::string& value,
-    URIEncodeCallback callback) {
-  std::move(callback).Run(ledger_client_->URIEncode(value));
-}
-
 void LedgerClientMojoProxy::SetContributionAutoInclude(
     const std::string& publisher_key, bool excluded, uint64_t window_id) {
   ledger_client_->SetContributionAutoInclude(
@@ -464,7 +442,7 @@ void LedgerClientMojoProxy::OnLoadURL(
     const std::map<std::string, std::string>& headers) {
   if (holder->is_valid())
     std::move(holder->get()).Run(
-        success, response, mojo::MapToFlatMap(headers));
+        success, ToBigBuffer(response), mojo::MapToFlatMap(headers));
   delete holder;
 }
 
@@ -494,21 +472,19 @@ void LedgerClientMojoProxy::OnLoadActivityInfo(
     CallbackHolder<LoadActivityInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
   if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+    std::move(holder->get()).Run(ToMojomResult(result),
+        mojom::PublisherInfo::From(info));
   delete holder;
 }
 
 void LedgerClientMojoProxy::LoadActivityInfo(
-    const std::string& filter,
+    mojom::ActivityInfoFilterPtr filter,
     LoadActivityInfoCallback callback) {
   // deleted in OnLoadActivityInfo
   auto* holder = new CallbackHolder<LoadActivityInfoCallback>(
       AsWeakPtr(), std::move(callback));
-  ledger::ActivityInfoFilter publisher_info_filter;
-  publisher_info_filter.loadFromJson(filter);
-  ledger_client_->LoadActivityInfo(publisher_info_filter,
+  ledger_client_->LoadActivityInfo(filter.To<ledger::ActivityInfoFilter>(),
       std::bind(LedgerClientMojoProxy::OnLoadActivityInfo, holder, _1, _2));
 }
 
@@ -517,25 +493,20 @@ void LedgerClientMojoProxy::OnSaveActivityInfo(
     CallbackHolder<SaveActivityInfoCallback>* holder,
     ledger::Result result,
     std::unique_ptr<ledger::PublisherInfo> info) {
-  std::string json_info = info ? info->ToJson() : "";
   if (holder->is_valid())
-    std::move(holder->get()).Run(ToMojomResult(result), json_info);
+    std::move(holder->get()).Run(ToMojomResult(result),
+        mojom::PublisherInfo::From(info));
   delete holder;
 }
 
 void LedgerClientMojoProxy::SaveActivityInfo(
-    const std::string& publisher_info,
+    mojom::PublisherInfoPtr publisher_info,
     SaveActivityInfoCallback callback) {
   // deleted in OnSaveActivityInfo
   auto* holder = new CallbackHolder<SaveActivityInfoCallback>(
       AsWeakPtr(), std::move(callback));
-  std::unique_ptr<ledger::PublisherInfo> info;
-  if (!publisher_info.empty()) {
-    info.reset(new ledger::PublisherInfo());
-    info->loadFromJson(publisher_info);
-  }
-
-  ledger_client_->SaveActivityInfo(std::move(info),
+  ledger_client_->SaveActivityInfo(
+      publisher_info.To<std::unique_ptr<ledger::PublisherInfo>>(),
       std::bind(LedgerClientMojoProxy::OnSaveActivityInfo, holder, _1, _2));
 }
 
@@ -563,30 +534,26 @@ void LedgerClientMojoProxy::OnGetActivityInfoList(
     CallbackHolder<GetActivityInfoListCallback>* holder,
     const ledger::PublisherInfoList& publisher_info_list,
     uint32_t next_record) {
-  std::vector<std::string> list;
-  for (const auto& publisher_info : publisher_info_list) {
-    list.push_back(publisher_info.ToJson());
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(
+        mojo::ConvertTo<std::vector<mojom::PublisherInfoPtr>>(
+            publisher_info_list),
+        next_record);
   }
-
-  if (holder->is_valid())
-    std::move(holder->get()).Run(list, next_record);
   delete holder;
 }
 
 void LedgerClientMojoProxy::GetActivityInfoList(uint32_t start,
     uint32_t limit,
-    const std::string& filter,
+    mojom::ActivityInfoFilterPtr filter,
     GetActivityInfoListCallback callback) {
   // deleted in OnGetActivityInfoList
   auto* holder = new CallbackHolder<GetActivityInfoListCallback>(
       AsWeakPtr(), std::move(callback));
 
-  ledger::ActivityInfoFilter publisher_info_filter;
-  publisher_info_filter.loadFromJson(filter);
-
   ledger_client_->GetActivityInfoList(start,
       limit,
-      publisher_info_filter,
+      filter.To<ledger::ActivityInfoFilter>(),
       std::bind(LedgerClientMojoProxy::OnGetActivityInfoList,
                 holder,
                 _1,
@@ -595,10 +562,9 @@ void LedgerClientMojoProxy::GetActivityInfoList(uint32_t start,
 }
 
 void LedgerClientMojoProxy::SaveNormalizedPublisherList(
-    const std::string& normalized_list) {
-
+    std::vector<mojom::PublisherInfoPtr> normalized_list) {
   ledger::PublisherInfoListStruct list;
-  list.loadFromJson(normalized_list);
+  list.list = mojo::ConvertTo<ledger::PublisherInfoList>(normalized_list);
 
   ledger_client_->SaveNormalizedPublisherList(list);
 }
@@ -20,7 +20,6 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
   ~LedgerClientMojoProxy() override;
 
   // bat_ledger::mojom::BatLedgerClient
-  void GenerateGUID(GenerateGUIDCallback callback) override;
   void LoadLedgerState(LoadLedgerStateCallback callback) override;
   void OnWalletInitialized(int32_t result) override;
   void OnWalletProperties(int32_t result, const std::string& info) override;
@@ -39,14 +38,14 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
       SaveLedgerStateCallback callback) override;
   void SavePublisherState(const std::string& publisher_state,
       SavePublisherStateCallback callback) override;
-  void SavePublishersList(const std::string& publishers_list,
+  void SavePublishersList(mojo_base::BigBuffer publishers_list,
       SavePublishersListCallback callback) override;
 
-  void SavePublisherInfo(const std::string& publisher_info,
+  void SavePublisherInfo(mojom::PublisherInfoPtr publisher_info,
       SavePublisherInfoCallback callback) override;
   void LoadPublisherInfo(const std::string& publisher_key,
       LoadPublisherInfoCallback callback) override;
-  void LoadPanelPublisherInfo(const std::string& filter,
+  void LoadPanelPublisherInfo(mojom::ActivityInfoFilterPtr filter,
       LoadPanelPublisherInfoCallback callback) override;
   void LoadMediaPublisherInfo(const std::string& media_key,
       LoadMediaPublisherInfoCallback callback) override;
@@ -59,8 +58,7 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
   void OnRemoveRecurring(const std::string& publisher_key,
       OnRemoveRecurringCallback callback) override;
 
-  void SetTimer(uint64_t time_offset, SetTimerCallback callback) override;
-  void OnPanelPublisherInfo(int32_t result, const std::string& info,
+  void OnPanelPublisherInfo(int32_t result, mojom::PublisherInfoPtr info,
       uint64_t window_id) override;
   void OnExcludedSitesChanged(const std::string& publisher_id) override;
   void SaveContributionInfo(const std::string& probi, int32_t month,
@@ -73,9 +71,6 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
       const std::string& payment_id) override;
   void GetGrantCaptcha() override;
 
-  void URIEncode(const std::string& value,
-      URIEncodeCallback callback) override;
-
   void SetContributionAutoInclude(const std::string& publisher_key,
       bool excluded, uint64_t window_id) override;
 
@@ -89,21 +84,21 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
   void SavePendingContribution(
       const std::string& list) override;
 
-  void LoadActivityInfo(const std::string& filter,
+  void LoadActivityInfo(mojom::ActivityInfoFilterPtr filter,
       LoadActivityInfoCallback callback) override;
 
-  void SaveActivityInfo(const std::string& publisher_info,
+  void SaveActivityInfo(mojom::PublisherInfoPtr publisher_info,
       SaveActivityInfoCallback callback) override;
 
   void OnRestorePublishers(OnRestorePublishersCallback callback) override;
 
   void GetActivityInfoList(uint32_t start,
                            uint32_t limit,
-                           const std::string& filter,
+                           mojom::ActivityInfoFilterPtr filter,
                            GetActivityInfoListCallback callback) override;
 
   void SaveNormalizedPublisherList(
-    const std::string& normalized_list) override;
+    std::vector<mojom::PublisherInfoPtr> normalized_list) override;
 
  private:
   // workaround to pass base::OnceCallback into std::bind
@@ -125,7 +120,7 @@ class LedgerClientMojoProxy : public mojom::BatLedgerClient,
     void OnPublisherStateLoaded(ledger::Result result,
         const std::string& data) override;
     void OnPublisherListLoaded(ledger::Result result,
-        const std::string& data) override;
+        const char* data, size_t size) override;
     void OnLedgerStateSaved(ledger::Result result) override;
     void OnPublisherStateSaved(ledger::Result result) override;
     void OnPublishersListSaved(ledger::Result result) override;
@@ -0,0 +1,260 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/services/bat_ledger/public/cpp/ledger_type_converters.h"
+
+#include <string>
+#include <utility>
+
+#include "base/containers/span.h"
+
+namespace mojo {
+
+// static
+bat_ledger::mojom::VisitDataPtr
+TypeConverter<bat_ledger::mojom::VisitDataPtr, ledger::VisitData>::Convert(
+    const ledger::VisitData& input) {
+  auto output = bat_ledger::mojom::VisitData::New();
+  output->tld = input.tld;
+  output->domain = input.domain;
+  output->path = input.path;
+  output->tab_id = input.tab_id;
+  output->local_month = input.local_month;
+  output->local_year = input.local_year;
+  output->name = input.name;
+  output->url = input.url;
+  output->provider = input.provider;
+  output->favicon_url = input.favicon_url;
+  return output;
+}
+
+// static
+ledger::VisitData
+TypeConverter<ledger::VisitData, bat_ledger::mojom::VisitDataPtr>::Convert(
+    const bat_ledger::mojom::VisitDataPtr& input) {
+  ledger::VisitData output;
+  if (!input)
+    return output;
+
+  output.tld = input->tld;
+  output.domain = input->domain;
+  output.path = input->path;
+  output.tab_id = input->tab_id;
+  output.local_month = static_cast<ledger::ACTIVITY_MONTH>(input->local_month);
+  output.local_year = input->local_year;
+  output.name = input->name;
+  output.url = input->url;
+  output.provider = input->provider;
+  output.favicon_url = input->favicon_url;
+  return output;
+}
+
+// static
+bat_ledger::mojom::ContributionInfoPtr
+TypeConverter<bat_ledger::mojom::ContributionInfoPtr,
+              ledger::ContributionInfo>::Convert(
+    const ledger::ContributionInfo& input) {
+  auto output = bat_ledger::mojom::ContributionInfo::New();
+  output->publisher = input.publisher;
+  output->value = input.value;
+  output->date = input.date;
+  return output;
+}
+
+// static
+ledger::ContributionInfo
+TypeConverter<ledger::ContributionInfo,
+              bat_ledger::mojom::ContributionInfoPtr>::Convert(
+    const bat_ledger::mojom::ContributionInfoPtr& input) {
+  ledger::ContributionInfo output(0, 0);
+  if (!input)
+    return output;
+
+  output.publisher = input->publisher;
+  output.value = input->value;
+  output.date = input->date;
+  return output;
+}
+
+// static
+bat_ledger::mojom::PublisherInfoPtr
+TypeConverter<bat_ledger::mojom::PublisherInfoPtr,
+              ledger::PublisherInfo>::Convert(
+    const ledger::PublisherInfo& input) {
+  auto output = bat_ledger::mojom::PublisherInfo::New();
+  output->id = input.id;
+  output->duration = input.duration;
+  output->score = input.score;
+  output->visits = input.visits;
+  output->percent = input.percent;
+  output->weight = input.weight;
+  output->excluded = input.excluded;
+  output->category = input.category;
+  output->month = input.month;
+  output->year = input.year;
+  output->reconcile_stamp = input.reconcile_stamp;
+  output->verified = input.verified;
+  output->name = input.name;
+  output->url = input.url;
+  output->provider = input.provider;
+  output->favicon_url = input.favicon_url;
+  output->contributions.reserve(input.contributions.size());
+  for (const auto& contribution : input.contributions) {
+    output->contributions.push_back(
+        bat_ledger::mojom::ContributionInfo::From(contribution));
+  }
+  return output;
+}
+
+// static
+ledger::PublisherInfo
+TypeConverter<ledger::PublisherInfo,
+              bat_ledger::mojom::PublisherInfoPtr>::Convert(
+    const bat_ledger::mojom::PublisherInfoPtr& input) {
+  ledger::PublisherInfo output;
+  if (!input)
+    return output;
+
+  output.id = input->id;
+  output.duration = input->duration;
+  output.score = input->score;
+  output.visits = input->visits;
+  output.percent = input->percent;
+  output.weight = input->weight;
+  output.excluded = static_cast<ledger::PUBLISHER_EXCLUDE>(input->excluded);
+  output.category = static_cast<ledger::REWARDS_CATEGORY>(input->category);
+  output.month = static_cast<ledger::ACTIVITY_MONTH>(input->month);
+  output.year = input->year;
+  output.reconcile_stamp = input->reconcile_stamp;
+  output.verified = input->verified;
+  output.name = input->name;
+  output.url = input->url;
+  output.provider = input->provider;
+  output.favicon_url = input->favicon_url;
+  output.contributions.reserve(input->contributions.size());
+  for (const auto& contribution : input->contributions) {
+    output.contributions.push_back(
+        contribution.To<ledger::ContributionInfo>());
+  }
+  return output;
+}
+
+// static
+bat_ledger::mojom::PublisherInfoPtr
+TypeConverter<bat_ledger::mojom::PublisherInfoPtr,
+              std::unique_ptr<ledger::PublisherInfo>>::Convert(
+    const std::unique_ptr<ledger::PublisherInfo>& input) {
+  if (!input)
+    return nullptr;
+  return bat_ledger::mojom::PublisherInfo::From(*input);
+}
+
+// static
+std::unique_ptr<ledger::PublisherInfo>
+TypeConverter<std::unique_ptr<ledger::PublisherInfo>,
+              bat_ledger::mojom::PublisherInfoPtr>::Convert(
+    const bat_ledger::mojom::PublisherInfoPtr& input) {
+  if (!input)
+    return nullptr;
+  return std::make_unique<ledger::PublisherInfo>(
+      input.To<ledger::PublisherInfo>());
+}
+
+// static
+std::vector<bat_ledger::mojom::PublisherInfoPtr>
+TypeConverter<std::vector<bat_ledger::mojom::PublisherInfoPtr>,
+              ledger::PublisherInfoList>::Convert(
+    const ledger::PublisherInfoList& input) {
+  std::vector<bat_ledger::mojom::PublisherInfoPtr> output;
+  output.reserve(input.size());
+  for (const auto& info : input)
+    output.push_back(bat_ledger::mojom::PublisherInfo::From(info));
+  return output;
+}
+
+// static
+ledger::PublisherInfoList
+TypeConverter<ledger::PublisherInfoList,
+              std::vector<bat_ledger::mojom::PublisherInfoPtr>>::Convert(
+    const std::vector<bat_ledger::mojom::PublisherInfoPtr>& input) {
+  ledger::PublisherInfoList output;
+  output.reserve(input.size());
+  for (const auto& info : input)
+    output.push_back(info.To<ledger::PublisherInfo>());
+  return output;
+}
+
+// static
+bat_ledger::mojom::ActivityInfoFilterPtr
+TypeConverter<bat_ledger::mojom::ActivityInfoFilterPtr,
+              ledger::ActivityInfoFilter>::Convert(
+    const ledger::ActivityInfoFilter& input) {
+  auto output = bat_ledger::mojom::ActivityInfoFilter::New();
+  output->id = input.id;
+  output->month = input.month;
+  output->year = input.year;
+  output->excluded = input.excluded;
+  output->percent = input.percent;
+  output->order_by.reserve(input.order_by.size());
+  for (const auto& order : input.order_by) {
+    output->order_by.push_back(
+        bat_ledger::mojom::ActivityInfoFilterOrderPair::New(
+            order.first, order.second));
+  }
+  output->min_duration = input.min_duration;
+  output->reconcile_stamp = input.reconcile_stamp;
+  output->non_verified = input.non_verified;
+  output->min_visits = input.min_visits;
+  output->after_id = input.after_id;
+  output->after_month = input.after_month;
+  output->after_year = input.after_year;
+  output->after_reconcile_stamp = input.after_reconcile_stamp;
+  return output;
+}
+
+// static
+ledger::ActivityInfoFilter
+TypeConverter<ledger::ActivityInfoFilter,
+              bat_ledger::mojom::ActivityInfoFilterPtr>::Convert(
+    const bat_ledger::mojom::ActivityInfoFilterPtr& input) {
+  ledger::ActivityInfoFilter output;
+  if (!input)
+    return output;
+
+  output.id = input->id;
+  output.month = static_cast<ledger::ACTIVITY_MONTH>(input->month);
+  output.year = input->year;
+  output.excluded = static_cast<ledger::EXCLUDE_FILTER>(input->excluded);
+  output.percent = input->percent;
+  output.order_by.reserve(input->order_by.size());
+  for (const auto& order : input->order_by) {
+    output.order_by.push_back(
+        std::make_pair(order->property_name, order->ascending));
+  }
+  output.min_duration = input->min_duration;
+  output.reconcile_stamp = input->reconcile_stamp;
+  output.non_verified = input->non_verified;
+  output.min_visits = input->min_visits;
+  output.after_id = input->after_id;
+  output.after_month = static_cast<ledger::ACTIVITY_MONTH>(input->after_month);
+  output.after_year = input->after_year;
+  output.after_reconcile_stamp = input->after_reconcile_stamp;
+  return output;
+}
+
+}  // namespace mojo
+
+namespace bat_ledger {
+
+mojo_base::BigBuffer ToBigBuffer(base::StringPiece data) {
+  return mojo_base::BigBuffer(base::make_span(
+      reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+}
+
+base::StringPiece AsStringPiece(const mojo_base::BigBuffer& buffer) {
+  return base::StringPiece(reinterpret_cast<const char*>(buffer.data()),
+                           buffer.size());
+}
+
+}  // namespace bat_ledger
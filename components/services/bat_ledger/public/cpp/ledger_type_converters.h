@@ -0,0 +1,121 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_CPP_LEDGER_TYPE_CONVERTERS_H_
+#define BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_CPP_LEDGER_TYPE_CONVERTERS_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "bat/ledger/ledger.h"
+#include "bat/ledger/publisher_info.h"
+#include "brave/components/services/bat_ledger/public/interfaces/bat_ledger.mojom.h"
+#include "mojo/public/cpp/base/big_buffer.h"
+#include "mojo/public/cpp/bindings/type_converter.h"
+
+// Conversions between the ledger structs and their bat_ledger.mojom mirrors,
+// used on both ends of the ledger IPC, e.g.
+//   bat_ledger::mojom::VisitData::From(visit_data)
+//   mojo_visit_data.To<ledger::VisitData>()
+
+namespace mojo {
+
+template <>
+struct TypeConverter<bat_ledger::mojom::VisitDataPtr, ledger::VisitData> {
+  static bat_ledger::mojom::VisitDataPtr Convert(
+      const ledger::VisitData& input);
+};
+
+template <>
+struct TypeConverter<ledger::VisitData, bat_ledger::mojom::VisitDataPtr> {
+  static ledger::VisitData Convert(
+      const bat_ledger::mojom::VisitDataPtr& input);
+};
+
+template <>
+struct TypeConverter<bat_ledger::mojom::ContributionInfoPtr,
+                     ledger::ContributionInfo> {
+  static bat_ledger::mojom::ContributionInfoPtr Convert(
+      const ledger::ContributionInfo& input);
+};
+
+template <>
+struct TypeConverter<ledger::ContributionInfo,
+                     bat_ledger::mojom::ContributionInfoPtr> {
+  static ledger::ContributionInfo Convert(
+      const bat_ledger::mojom::ContributionInfoPtr& input);
+};
+
+template <>
+struct TypeConverter<bat_ledger::mojom::PublisherInfoPtr,
+                     ledger::PublisherInfo> {
+  static bat_ledger::mojom::PublisherInfoPtr Convert(
+      const ledger::PublisherInfo& input);
+};
+
+template <>
+struct TypeConverter<ledger::PublisherInfo,
+                     bat_ledger::mojom::PublisherInfoPtr> {
+  static ledger::PublisherInfo Convert(
+      const bat_ledger::mojom::PublisherInfoPtr& input);
+};
+
+// The ledger passes a missing publisher as a null std::unique_ptr, mojo as a
+// null PublisherInfo?.
+template <>
+struct TypeConverter<bat_ledger::mojom::PublisherInfoPtr,
+                     std::unique_ptr<ledger::PublisherInfo>> {
+  static bat_ledger::mojom::PublisherInfoPtr Convert(
+      const std::unique_ptr<ledger::PublisherInfo>& input);
+};
+
+template <>
+struct TypeConverter<std::unique_ptr<ledger::PublisherInfo>,
+                     bat_ledger::mojom::PublisherInfoPtr> {
+  static std::unique_ptr<ledger::PublisherInfo> Convert(
+      const bat_ledger::mojom::PublisherInfoPtr& input);
+};
+
+template <>
+struct TypeConverter<std::vector<bat_ledger::mojom::PublisherInfoPtr>,
+                     ledger::PublisherInfoList> {
+  static std::vector<bat_ledger::mojom::PublisherInfoPtr> Convert(
+      const ledger::PublisherInfoList& input);
+};
+
+template <>
+struct TypeConverter<ledger::PublisherInfoList,
+                     std::vector<bat_ledger::mojom::PublisherInfoPtr>> {
+  static ledger::PublisherInfoList Convert(
+      const std::vector<bat_ledger::mojom::PublisherInfoPtr>& input);
+};
+
+template <>
+struct TypeConverter<bat_ledger::mojom::ActivityInfoFilterPtr,
+                     ledger::ActivityInfoFilter> {
+  static bat_ledger::mojom::ActivityInfoFilterPtr Convert(
+      const ledger::ActivityInfoFilter& input);
+};
+
+template <>
+struct TypeConverter<ledger::ActivityInfoFilter,
+                     bat_ledger::mojom::ActivityInfoFilterPtr> {
+  static ledger::ActivityInfoFilter Convert(
+      const bat_ledger::mojom::ActivityInfoFilterPtr& input);
+};
+
+}  // namespace mojo
+
+namespace bat_ledger {
+
+// The large payloads of the ledger IPC, e.g. the publishers list, are sent as
+// a mojo_base.mojom.BigBuffer. ToBigBuffer() copies |data| into a new buffer;
+// AsStringPiece() reads |buffer| in place and is only valid while it lives.
+mojo_base::BigBuffer ToBigBuffer(base::StringPiece data);
+base::StringPiece AsStringPiece(const mojo_base::BigBuffer& buffer);
+
+}  // namespace bat_ledger
+
+#endif  // BRAVE_COMPONENTS_SERVICES_BAT_LEDGER_PUBLIC_CPP_LEDGER_TYPE_CONVERTERS_H_
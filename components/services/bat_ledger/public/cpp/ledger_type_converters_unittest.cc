@@ -0,0 +1,172 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/services/bat_ledger/public/cpp/ledger_type_converters.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=LedgerTypeConvertersTest.*
+
+namespace bat_ledger {
+
+namespace {
+
+// Sends |input| through the same serialization a message would use.
+template <typename MojomType, typename Ptr>
+Ptr SerializeAndDeserialize(Ptr* input) {
+  std::vector<uint8_t> data = MojomType::Serialize(input);
+  Ptr output;
+  EXPECT_TRUE(MojomType::Deserialize(data, &output));
+  return output;
+}
+
+ledger::PublisherInfo CreatePublisherInfo(int i) {
+  std::string id = "site" + std::to_string(i) + ".com";
+  ledger::PublisherInfo info(id, ledger::ACTIVITY_MONTH::MARCH, 2019);
+  info.duration = 10 * i;
+  info.score = 1.5 * i;
+  info.visits = i;
+  info.percent = i % 100;
+  info.weight = 0.25 * i;
+  info.excluded = ledger::PUBLISHER_EXCLUDE::INCLUDED;
+  info.category = ledger::REWARDS_CATEGORY::AUTO_CONTRIBUTE;
+  info.reconcile_stamp = 1550000000 + i;
+  info.verified = i % 2 == 0;
+  info.name = id;
+  info.url = "https://" + id + "/";
+  info.provider = "youtube";
+  info.favicon_url = "https://" + id + "/favicon.ico";
+  info.contributions.push_back(ledger::ContributionInfo(2.5, 1550000001));
+  info.contributions.back().publisher = id;
+  return info;
+}
+
+void ExpectPublisherInfoEq(const ledger::PublisherInfo& expected,
+                           const ledger::PublisherInfo& actual) {
+  EXPECT_EQ(expected.id, actual.id);
+  EXPECT_EQ(expected.duration, actual.duration);
+  EXPECT_EQ(expected.score, actual.score);
+  EXPECT_EQ(expected.visits, actual.visits);
+  EXPECT_EQ(expected.percent, actual.percent);
+  EXPECT_EQ(expected.weight, actual.weight);
+  EXPECT_EQ(expected.excluded, actual.excluded);
+  EXPECT_EQ(expected.category, actual.category);
+  EXPECT_EQ(expected.month, actual.month);
+  EXPECT_EQ(expected.year, actual.year);
+  EXPECT_EQ(expected.reconcile_stamp, actual.reconcile_stamp);
+  EXPECT_EQ(expected.verified, actual.verified);
+  EXPECT_EQ(expected.name, actual.name);
+  EXPECT_EQ(expected.url, actual.url);
+  EXPECT_EQ(expected.provider, actual.provider);
+  EXPECT_EQ(expected.favicon_url, actual.favicon_url);
+  ASSERT_EQ(expected.contributions.size(), actual.contributions.size());
+  for (size_t i = 0; i < expected.contributions.size(); ++i) {
+    EXPECT_EQ(expected.contributions[i].publisher,
+              actual.contributions[i].publisher);
+    EXPECT_EQ(expected.contributions[i].value, actual.contributions[i].value);
+    EXPECT_EQ(expected.contributions[i].date, actual.contributions[i].date);
+  }
+}
+
+}  // namespace
+
+TEST(LedgerTypeConvertersTest, VisitData) {
+  ledger::VisitData visit_data("brave.com", "brave.com", "/download", 7,
+      ledger::ACTIVITY_MONTH::MAY, 2019, "brave.com", "https://brave.com/",
+      "", "https://brave.com/favicon.ico");
+
+  mojom::VisitDataPtr mojo_visit_data = mojom::VisitData::From(visit_data);
+  ledger::VisitData result = SerializeAndDeserialize<mojom::VisitData>(
+      &mojo_visit_data).To<ledger::VisitData>();
+
+  EXPECT_EQ(visit_data.tld, result.tld);
+  EXPECT_EQ(visit_data.domain, result.domain);
+  EXPECT_EQ(visit_data.path, result.path);
+  EXPECT_EQ(visit_data.tab_id, result.tab_id);
+  EXPECT_EQ(visit_data.local_month, result.local_month);
+  EXPECT_EQ(visit_data.local_year, result.local_year);
+  EXPECT_EQ(visit_data.name, result.name);
+  EXPECT_EQ(visit_data.url, result.url);
+  EXPECT_EQ(visit_data.provider, result.provider);
+  EXPECT_EQ(visit_data.favicon_url, result.favicon_url);
+}
+
+TEST(LedgerTypeConvertersTest, PublisherInfo) {
+  ledger::PublisherInfo info = CreatePublisherInfo(42);
+
+  mojom::PublisherInfoPtr mojo_info = mojom::PublisherInfo::From(info);
+  ExpectPublisherInfoEq(info,
+      SerializeAndDeserialize<mojom::PublisherInfo>(&mojo_info)
+          .To<ledger::PublisherInfo>());
+
+  std::unique_ptr<ledger::PublisherInfo> missing;
+  EXPECT_FALSE(mojom::PublisherInfo::From(missing));
+  EXPECT_FALSE(mojom::PublisherInfoPtr()
+                   .To<std::unique_ptr<ledger::PublisherInfo>>());
+}
+
+TEST(LedgerTypeConvertersTest, ActivityInfoFilter) {
+  ledger::ActivityInfoFilter filter;
+  filter.id = "brave.com";
+  filter.month = ledger::ACTIVITY_MONTH::JUNE;
+  filter.year = 2019;
+  filter.excluded = ledger::EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED;
+  filter.percent = 1;
+  filter.order_by.push_back(std::make_pair("ai.percent", false));
+  filter.order_by.push_back(std::make_pair("ai.visits", true));
+  filter.min_duration = 8;
+  filter.reconcile_stamp = 1550000000;
+  filter.non_verified = false;
+  filter.min_visits = 2;
+  filter.after_id = "brave.com";
+  filter.after_month = ledger::ACTIVITY_MONTH::MAY;
+  filter.after_year = 2019;
+  filter.after_reconcile_stamp = 1550000000;
+
+  mojom::ActivityInfoFilterPtr mojo_filter =
+      mojom::ActivityInfoFilter::From(filter);
+  ledger::ActivityInfoFilter result =
+      SerializeAndDeserialize<mojom::ActivityInfoFilter>(&mojo_filter)
+          .To<ledger::ActivityInfoFilter>();
+
+  EXPECT_EQ(filter.id, result.id);
+  EXPECT_EQ(filter.month, result.month);
+  EXPECT_EQ(filter.year, result.year);
+  EXPECT_EQ(filter.excluded, result.excluded);
+  EXPECT_EQ(filter.percent, result.percent);
+  // The JSON filter kept |order_by| in an object, which lost its order.
+  EXPECT_EQ(filter.order_by, result.order_by);
+  EXPECT_EQ(filter.min_duration, result.min_duration);
+  EXPECT_EQ(filter.reconcile_stamp, result.reconcile_stamp);
+  EXPECT_EQ(filter.non_verified, result.non_verified);
+  EXPECT_EQ(filter.min_visits, result.min_visits);
+  EXPECT_EQ(filter.after_id, result.after_id);
+  EXPECT_EQ(filter.after_month, result.after_month);
+  EXPECT_EQ(filter.after_year, result.after_year);
+  EXPECT_EQ(filter.after_reconcile_stamp, result.after_reconcile_stamp);
+}
+
+TEST(LedgerTypeConvertersTest, PublisherInfoList) {
+  ledger::PublisherInfoList list;
+  for (int i = 0; i < 3; ++i)
+    list.push_back(CreatePublisherInfo(i));
+
+  std::vector<mojom::PublisherInfoPtr> mojo_list =
+      mojo::ConvertTo<std::vector<mojom::PublisherInfoPtr>>(list);
+  ASSERT_EQ(list.size(), mojo_list.size());
+  for (auto& mojo_info : mojo_list)
+    mojo_info = SerializeAndDeserialize<mojom::PublisherInfo>(&mojo_info);
+
+  ledger::PublisherInfoList result =
+      mojo::ConvertTo<ledger::PublisherInfoList>(mojo_list);
+  ASSERT_EQ(list.size(), result.size());
+  for (size_t i = 0; i < list.size(); ++i)
+    ExpectPublisherInfoEq(list[i], result[i]);
+}
+
+}  // namespace bat_ledger
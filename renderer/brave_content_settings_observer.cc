@@ -4,6 +4,9 @@
 
 #include "brave/renderer/brave_content_settings_observer.h"
 
+#include <utility>
+
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/render_messages.h"
 #include "brave/content/common/frame_messages.h"
@@ -17,6 +20,31 @@
 #include "third_party/blink/public/web/web_local_frame.h"
 #include "url/url_constants.h"
 
+namespace {
+
+const ContentSettingsPattern& FirstPartyPattern() {
+  static const base::NoDestructor<ContentSettingsPattern> first_party(
+      ContentSettingsPattern::FromString("https://firstParty/*"));
+  return *first_party;
+}
+
+}  // namespace
+
+struct BraveContentSettingsObserver::DocumentRules {
+  GURL primary_url;
+
+  // Generation of the rules these were selected from, it changes whenever
+  // the browser sends new rules.
+  uint64_t rules_generation = 0;
+
+  ContentSettingsForOneType brave_shields_rules;
+  // "https://firstParty/*" is resolved to the document's site and the
+  // default rule is already appended.
+  ContentSettingsForOneType fingerprinting_rules;
+  // Without the wildcard primary rule, which only holds the default.
+  ContentSettingsForOneType autoplay_rules;
+};
+
 BraveContentSettingsObserver::BraveContentSettingsObserver(
     content::RenderFrame* render_frame,
     bool should_whitelist,
@@ -48,6 +76,7 @@ void BraveContentSettingsObserver::DidCommitProvisionalLoad(
   if (!is_same_document_navigation) {
     temporarily_allowed_scripts_ =
       std::move(preloaded_temporarily_allowed_scripts_);
+    document_rules_.reset();
   }
 
   ContentSettingsObserver::DidCommitProvisionalLoad(
@@ -136,27 +165,70 @@ GURL BraveContentSettingsObserver::GetOriginOrURL(const blink::WebFrame* frame)
   return top_origin.GetURL();
 }
 
-ContentSetting BraveContentSettingsObserver::GetFPContentSettingFromRules(
-    const ContentSettingsForOneType& rules,
-    const blink::WebFrame* frame,
-    const GURL& secondary_url) {
+const BraveContentSettingsObserver::DocumentRules&
+BraveContentSettingsObserver::GetDocumentRules(const blink::WebFrame* frame) {
+  static const base::NoDestructor<ContentSettingsForOneType> no_rules;
+  const GURL& primary_url = GetOriginOrURL(frame);
+  const ContentSettingsForOneType& brave_shields_rules =
+      content_setting_rules_ ? content_setting_rules_->brave_shields_rules
+                             : *no_rules;
+  const ContentSettingsForOneType& fingerprinting_rules =
+      content_setting_rules_ ? content_setting_rules_->fingerprinting_rules
+                             : *no_rules;
+  const ContentSettingsForOneType& autoplay_rules =
+      content_setting_rules_ ? content_setting_rules_->autoplay_rules
+                             : *no_rules;
+
+  const uint64_t rules_generation =
+      content_setting_rules_ ? content_setting_rules_->brave_rules_generation
+                             : 0;
+
+  if (document_rules_ && document_rules_->primary_url == primary_url &&
+      document_rules_->rules_generation == rules_generation) {
+    return *document_rules_;
+  }
 
-  if (rules.size() == 0)
-    return CONTENT_SETTING_DEFAULT;
+  document_rules_ = std::make_unique<DocumentRules>();
+  document_rules_->primary_url = primary_url;
+  document_rules_->rules_generation = rules_generation;
 
-  const GURL& primary_url = GetOriginOrURL(frame);
+  for (const auto& rule : brave_shields_rules) {
+    if (rule.primary_pattern.Matches(primary_url))
+      document_rules_->brave_shields_rules.push_back(rule);
+  }
 
-  for (const auto& rule : rules) {
-    ContentSettingsPattern secondary_pattern = rule.secondary_pattern;
-    if (rule.secondary_pattern ==
-        ContentSettingsPattern::FromString("https://firstParty/*")) {
-      secondary_pattern = ContentSettingsPattern::FromString(
-          "[*.]" + GetOriginOrURL(frame).HostNoBrackets());
+  const ContentSettingsPattern first_party = ContentSettingsPattern::FromString(
+      "[*.]" + primary_url.HostNoBrackets());
+  for (const auto& rule : fingerprinting_rules) {
+    if (!rule.primary_pattern.Matches(primary_url))
+      continue;
+    document_rules_->fingerprinting_rules.push_back(rule);
+    if (rule.secondary_pattern == FirstPartyPattern())
+      document_rules_->fingerprinting_rules.back().secondary_pattern =
+          first_party;
+  }
+  document_rules_->fingerprinting_rules.push_back(ContentSettingPatternSource(
+      ContentSettingsPattern::Wildcard(), first_party,
+      base::Value::FromUniquePtrValue(
+          content_settings::ContentSettingToValue(CONTENT_SETTING_ALLOW)),
+      std::string(), false));
+
+  for (const auto& rule : autoplay_rules) {
+    if (rule.primary_pattern != ContentSettingsPattern::Wildcard() &&
+        rule.primary_pattern.Matches(primary_url)) {
+      document_rules_->autoplay_rules.push_back(rule);
     }
+  }
 
-    if (rule.primary_pattern.Matches(primary_url) &&
-        (secondary_pattern == ContentSettingsPattern::Wildcard() ||
-         secondary_pattern.Matches(secondary_url))) {
+  return *document_rules_;
+}
+
+ContentSetting BraveContentSettingsObserver::GetFPContentSettingFromRules(
+    const DocumentRules& rules,
+    const GURL& secondary_url) {
+  for (const auto& rule : rules.fingerprinting_rules) {
+    if (rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
+        rule.secondary_pattern.Matches(secondary_url)) {
       return rule.GetContentSetting();
     }
   }
@@ -169,20 +241,11 @@ ContentSetting BraveContentSettingsObserver::GetFPContentSettingFromRules(
 bool BraveContentSettingsObserver::IsBraveShieldsDown(
     const blink::WebFrame* frame,
     const GURL& secondary_url) {
-  ContentSetting setting = CONTENT_SETTING_DEFAULT;
-  const GURL& primary_url = GetOriginOrURL(frame);
-
-  if (content_setting_rules_) {
-    for (const auto& rule : content_setting_rules_->brave_shields_rules) {
-      if (rule.primary_pattern.Matches(primary_url) &&
-          rule.secondary_pattern.Matches(secondary_url)) {
-        setting = rule.GetContentSetting();
-        break;
-      }
-    }
+  for (const auto& rule : GetDocumentRules(frame).brave_shields_rules) {
+    if (rule.secondary_pattern.Matches(secondary_url))
+      return rule.GetContentSetting() == CONTENT_SETTING_BLOCK;
   }
-
-  return setting == CONTENT_SETTING_BLOCK;
+  return false;
 }
 
 bool BraveContentSettingsObserver::AllowFingerprinting(
@@ -195,19 +258,8 @@ bool BraveContentSettingsObserver::AllowFingerprinting(
   if (IsBraveShieldsDown(frame, secondary_url)) {
     return true;
   }
-  ContentSettingsForOneType rules;
-  if (content_setting_rules_) {
-      rules = content_setting_rules_->fingerprinting_rules;
-  }
-  ContentSettingPatternSource default_rule =
-      ContentSettingPatternSource(ContentSettingsPattern::Wildcard(),
-                                  ContentSettingsPattern::FromString("https://firstParty/*"),
-                                  base::Value::FromUniquePtrValue(content_settings::ContentSettingToValue(CONTENT_SETTING_ALLOW)),
-                                  std::string(),
-                                  false);
-  rules.push_back(default_rule);
-  ContentSetting setting = GetFPContentSettingFromRules(rules, frame, secondary_url);
-  rules.pop_back();
+  ContentSetting setting =
+      GetFPContentSettingFromRules(GetDocumentRules(frame), secondary_url);
   bool allow = setting != CONTENT_SETTING_BLOCK;
   allow = allow || IsWhitelistedForContentSettings();
 
@@ -230,14 +282,10 @@ bool BraveContentSettingsObserver::AllowAutoplay(bool default_value) {
     return true;
 
   // respect user's site blocklist, if any
-  const GURL& primary_url = GetOriginOrURL(frame);
   const GURL& secondary_url = url::Origin(frame->GetDocument().GetSecurityOrigin()).GetURL();
-  for (const auto& rule : content_setting_rules_->autoplay_rules) {
-    if (rule.primary_pattern == ContentSettingsPattern::Wildcard())
-        continue;
-    if (rule.primary_pattern.Matches(primary_url) &&
-        (rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
-         rule.secondary_pattern.Matches(secondary_url))) {
+  for (const auto& rule : GetDocumentRules(frame).autoplay_rules) {
+    if (rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
+        rule.secondary_pattern.Matches(secondary_url)) {
       if (rule.GetContentSetting() == CONTENT_SETTING_BLOCK)
         return false;
     }
@@ -5,6 +5,10 @@
 #ifndef BRAVE_RENDERER_CONTENT_SETTINGS_OBSERVER_H_
 #define BRAVE_RENDERER_CONTENT_SETTINGS_OBSERVER_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "base/strings/string16.h"
 #include "chrome/renderer/content_settings_observer.h"
 #include "components/content_settings/core/common/content_settings.h"
@@ -42,9 +46,15 @@ class BraveContentSettingsObserver
  private:
   GURL GetOriginOrURL(const blink::WebFrame* frame);
 
+  // The shields rules whose primary pattern matches the current document.
+  struct DocumentRules;
+
+  // Selects the rules for |frame| once per document, so each check only
+  // scans the few rules that can apply instead of every site override.
+  const DocumentRules& GetDocumentRules(const blink::WebFrame* frame);
+
   ContentSetting GetFPContentSettingFromRules(
-      const ContentSettingsForOneType& rules,
-      const blink::WebFrame* frame,
+      const DocumentRules& rules,
       const GURL& secondary_url);
 
   bool IsBraveShieldsDown(
@@ -69,6 +79,9 @@ class BraveContentSettingsObserver
   // temporary allowed script origins we preloaded for the next load
   base::flat_set<std::string> preloaded_temporarily_allowed_scripts_;
 
+  // Reset when a new document commits.
+  std::unique_ptr<DocumentRules> document_rules_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveContentSettingsObserver);
 };
 